@@ -1,741 +1,4855 @@
-/* 
-	https://www.cs.princeton.edu/courses/archive/spr08/cos226/assignments/8puzzle.html
-	Should have been (N^2 - 1) puzzle but whatever
-	Anyway here we use the A star algorithm
-	Input: "start.txt" and "goal.txt". 
-	Output: The solution printed to screen
-	To compile with gcc, use:
-	gcc -ansi -pedantic -W -Wall -o N_puzzles N_puzzles.c
-	Then run:
-	./N_puzzles
-*/
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-#define NUM_OF_MOVES 4 /* Up, down, left, right */
-#define MAX_HEAP_SIZE 20
-
-typedef struct StateStruct {
-	char* desc; /* The list of moves to get to the board position. For example 'Brd' for right then down */
-	int** board;
-	int score;
-	int g_score;	
-} State;
-
-int** new_board(int N);
-
-int print_board(int** board, int N);
-
-int free_board(int** board, int N);
-
-int is_valid_move(int** board, int N, char move);
-
-int valid_moves(int** board, int N, int* result);
-
-int** move_board(int** board, int N, char move);
-
-char* move_desc(const char* desc, char move);
-
-int h_score(int** board, int *current_rows, int *current_cols, const int *goal_rows, const int *goal_cols,
-	int N, int N_squared);
-
-int swap_two_states(State *state_1, State *state_2);
-
-int is_goal(const int **board, const int **goal, int N);
-
-int print_solution(const int **start, int N, const char *desc);
-	
-int insert_to_heap(State *heap, int *heap_size, char *desc, int **board, int score, int g_score);
-
-int extract_from_heap(State *heap, int *heap_size, char **desc, int ***board, int *score, int *g_score);
-	
-int run(const int** start, const int ** goal, int N);
-
-int main()
-{
-   
-   FILE *fid;
-   int N, i, j;   
-   int **start, **goal;     
-  
-   /* Read start position */
-   fid = fopen("start.txt", "rt");
-   fscanf(fid, "%d ", &N);   
-   start = new_board(N);
-   for (i = 0; i < N; i++){
-	   for (j = 0; j < N; j++){
-		   fscanf(fid, "%d ", &start[i][j]);
-	   }
-   }
-   fclose(fid);
-      
-   /* Read goal position */
-   fid = fopen("goal.txt", "rt");   
-   goal = new_board(N);
-   for (i = 0; i < N; i++){
-	   for (j = 0; j < N; j++){
-		   fscanf(fid, "%d ", &goal[i][j]);
-	   }
-   }
-   fclose(fid);   
-   
-   run((const int**) start, (const int **) goal, N);    
-   
-   free_board(start, N);   
-   free_board(goal, N);    
-   return 0;
-}
-
-int** new_board(int N){
-   int **board, i;
-   board = (int **) malloc(sizeof(int *) * N);
-   for (i = 0; i < N; i++){
-	   board[i] = (int *) malloc(sizeof(int) * N);
-   }
-   return board;
-}
-
-/*
- * Function:  print_board 
- * --------------------
- * Print the board
- *    
- *  board: The board configuration 
- *  N: width and height of the board 
- * 
- *  returns: 0
- */
-int print_board(int** board, int N){
-	int i, j;	
-	for (i = 0; i < N; i++){		
-		for (j = 0; j < N; j++){
-			if (board[i][j] == 0) {
-				printf("x ");
-			} else {
-				printf("%d ", board[i][j]);
-			}
-		}
-		printf("\n");
-	}
-	return 0;
-}
-
-/*
- * Function:  free_board 
- * --------------------
- * Free the board
- *    
- *  board: The board configuration 
- *  N: width and height of the board 
- * 
- *  returns: 0
- */
-int free_board(int** board, int N){
-	int i;
-	for (i = 0; i < N; i++){
-		free(board[i]);
-	}
-	free(board);
-	return 0;
-}
-
-/*
- * Function:  is_valid_move 
- * --------------------
- * Check whether the move is valid or not
- *    
- *  board: The board configuration 
- *  N: width and height of the board 
- *  move: The move('u', 'd', 'l', 'r') 
- *
- *  returns: 1 if valid and 0 otherwise
- */
-int is_valid_move(int** board, int N, char move){
-	int i, j, x_row, x_col, new_x_row, new_x_col;
-	
-	/* Find 'x' position */
-	for (i = 0; i < N; i++){		
-		for (j = 0; j < N; j++){
-			if (board[i][j] == 0) {
-				x_row = i;
-				x_col = j;
-			} 
-		}		
-	}
-	
-	/* Then check if the new position is within the board */
-	switch (move){
-		case 'u':
-			/* Up */
-			new_x_row = x_row - 1;
-			new_x_col = x_col;
-			break;
-		case 'd':
-			/* Down */
-			new_x_row = x_row + 1;
-			new_x_col = x_col;
-			break;
-		case 'l':
-			/* Left */
-			new_x_row = x_row;
-			new_x_col = x_col - 1;
-			break;
-		case 'r':
-			/* Right */
-			new_x_row = x_row;
-			new_x_col = x_col + 1;
-			break;
-		default:
-			new_x_row = -1;
-			new_x_col = -1;
-			break;
-	}
-	if ((0 <= new_x_row) && (new_x_row < N) && (0 <= new_x_col) && (new_x_col < N)){
-		return 1;
-	} else {
-		return 0;
-	}
-}
-
-/*
- * Function:  valid_moves 
- * --------------------
- * Return the list of valid moves from the current board
- *    
- *  board: The board configuration 
- *  N: width and height of the board 
- *  result: The array of size NUM_OF_MOVES used to store the list of valid moves
- *  result[i] = 1 if the move i is valid and 0 otherwise
- *  i = 0: Up
- *  i = 1: Down
- *  i = 2: Left
- *  i = 3: Right
- *
- *  returns: 0
- */
-int valid_moves(int** board, int N, int* result){
-	/* Up, down, left, right	 */
-	result[0] = is_valid_move(board, N, 'u');
-	result[1] = is_valid_move(board, N, 'd');
-	result[2] = is_valid_move(board, N, 'l');
-	result[3] = is_valid_move(board, N, 'r');
-	return 0;
-}
-
-/*
- * Function:  move_board 
- * --------------------
- * Create a new board based on the designated move
- *    
- *  board: The board configuration 
- *  N: width and height of the board 
- *  move: The move('u', 'd', 'l', 'r') 
- *
- *  returns: a new dynamically created board (that must be freed afterwards)
- */
-int** move_board(int** board, int N, char move){
-	/* This function assumes that the move is valid */
-	int **board_2 = new_board(N);
-	int i, j, x_row, x_col, new_x_row, new_x_col;	
-	/* Find 'x' position */
-	for (i = 0; i < N; i++){		
-		for (j = 0; j < N; j++){
-			if (board[i][j] == 0) {
-				x_row = i;
-				x_col = j;
-			} 
-		}		
-	}
-	
-	/* Then move! */
-	switch (move){
-		case 'u':
-			/* Up */
-			new_x_row = x_row - 1;
-			new_x_col = x_col;
-			break;
-		case 'd':
-			/* Down */
-			new_x_row = x_row + 1;
-			new_x_col = x_col;
-			break;
-		case 'l':
-			/* Left */
-			new_x_row = x_row;
-			new_x_col = x_col - 1;
-			break;
-		case 'r':
-			/* Right */
-			new_x_row = x_row;
-			new_x_col = x_col + 1;
-			break;		
-	}
-	
-	for (i = 0; i < N; i++){		
-		for (j = 0; j < N; j++){
-			board_2[i][j] = board[i][j];
-		}		
-	}
-	board_2[x_row][x_col] = board[new_x_row][new_x_col];
-	board_2[new_x_row][new_x_col] = board[x_row][x_col];
-	return board_2;
-}
-
-/*
- * Function:  move_desc 
- * --------------------
- * Create a new move description (e.g: Brdrd) based on the designated move
- *    
- *  desc: The move description, basically a character array that starts with 'B' and ends with '\0'  
- *  move: The move('u', 'd', 'l', 'r') 
- *
- *  returns: a new dynamically created move description (that must be freed afterwards)
- */
-char* move_desc(const char* desc, char move){
-	int desc_length = strlen(desc);
-	int i;
-	char *desc_2 = (char *) malloc(sizeof(char) * (desc_length+1));
-	for (i = 0; i < desc_length; i++){
-		desc_2[i] = desc[i];
-	}
-	desc_2[desc_length] = move;
-	desc_2[desc_length + 1] = '\0';
-	return desc_2;
-}
-
-/*
- * Function:  h_score 
- * --------------------
- * Calculate the h_score (heuristic estimate) of the current board configuration
- * Here we use Manhattan distance as the heuristic estimate
- *    
- *  board: The board configuration
- *  current_rows: Row position for each of the value in the current board (current_rows[value] = position) 
- *  current_cols: Column position for each of the value in the current board (current_cols[value] = position) 
- *  goal_rows: Row position for each of the value in the goal (goal_rows[value] = position)
- *  goal_cols: Column position for each of the value in the goal (goal_cols[value] = position)
- *  N: width and height of the board 
- *  N_squared: This is because we will call h_score multiple times
- * 
- *  returns: 0
- */
-int h_score(int** board, int *current_rows, int *current_cols, const int *goal_rows, const int *goal_cols,
-	int N, int N_squared){
-	/* Here we use Manhattan priority function */
-	int i,j;
-	int manhattan_score;
-	for (i = 0; i < N; i++){		
-		for (j = 0; j < N; j++){
-			current_rows[board[i][j]] = i;
-			current_cols[board[i][j]] = j;
-		}		
-	}
-	for (i = 1; i < N_squared; i++){
-	   /* Do not care about 'x' */
-	   manhattan_score += (abs(current_rows[i] - goal_rows[i]) + abs(current_cols[i] - goal_cols[i]));
-   }
-   return manhattan_score;	
-}
-
-/*
- * Function:  swap_two_states 
- * --------------------
- * Swap two states
- *    
- *  state_1: The first state
- *  state_2: The second state 
- *
- *  returns: 0
- */
-int swap_two_states(State *state_1, State *state_2){
-	State temp;
-	temp.desc = (*state_1).desc;
-	temp.board = (*state_1).board;
-	temp.score = (*state_1).score;
-	temp.g_score = (*state_1).g_score;
-	
-	(*state_1).desc = (*state_2).desc;
-	(*state_1).board = (*state_2).board;
-	(*state_1).score = (*state_2).score;
-	(*state_1).g_score = (*state_2).g_score;
-	
-	(*state_2).desc = temp.desc;
-	(*state_2).board = temp.board;
-	(*state_2).score = temp.score;
-	(*state_2).g_score = temp.g_score;
-	
-	return 0;
-}
-/*
- * Function:  is_goal 
- * --------------------
- * Check if a board configuration is the goal state or not
- *    
- *  board: The board configuration
- *  goal: The goal state
- *  N: width and height of the board 
- * 
- *  returns: 1 if it is true else 0
- */
-int is_goal(const int **board, const int **goal, int N){
-	int i, j;	
-	for (i = 0; i < N; i++){
-		for (j = 0; j < N; j++){
-			if (board[i][j] != goal[i][j]){
-				return 0;
-			}
-		}
-	}
-	return 1;
-}
-
-/*
- * Function:  print_solution 
- * --------------------
- * Print the optimal solution
- *    
- *  start: The start state *  
- *  N: width and height of the board 
- *  desc: A descriptions of the moves to get from the start state to the goal state'
- *  For example : "Brdrd" would be "right, down, right, down" 
- *  u: Up, d: Down, l: Left, r: Right. B denotes the starting position
- *
- *  returns: 0
- */
-int print_solution(const int **start, int N, const char *desc){
-	int **board, i, j, temp, x_row, x_col, new_x_row, new_x_col;	
-	char move;
-	board = new_board(N);
-	for (i = 0; i < N; i++){		
-		for (j = 0; j < N; j++){
-			board[i][j] = start[i][j];	
-			if (board[i][j] == 0) {
-				x_row = i;
-				x_col = j;
-			} 			
-		}		
-	}
-	printf("Moves to get to the solution: %s \n", desc);
-	
-	printf("The solution: \n");	
-	i = 1;
-	while (1) {
-		print_board(board, N);
-		printf(" => \n\n");		
-		move = desc[i];
-		if (move == '\0'){
-			printf("The end!\n");
-			for (i = 0; i < N; i++){
-				free(board[i]);
-			}
-			free(board);
-			return 0;
-		}
-		switch (move){
-			case 'u':
-				/* Up */
-				new_x_row = x_row - 1;
-				new_x_col = x_col;
-				break;
-			case 'd':
-				/* Down */
-				new_x_row = x_row + 1;
-				new_x_col = x_col;
-				break;
-			case 'l':
-				/* Left */
-				new_x_row = x_row;
-				new_x_col = x_col - 1;
-				break;
-			case 'r':
-				/* Right */
-				new_x_row = x_row;
-				new_x_col = x_col + 1;
-				break;		
-		}
-		temp = board[new_x_row][new_x_col];
-		board[new_x_row][new_x_col] = board[x_row][x_col];
-		board[x_row][x_col] = temp;	
-		x_row = new_x_row;
-		x_col = new_x_col;
-		i++;
-	}	
-	return 0;
-}
-/*
- * Function:  insert_to_heap 
- * --------------------
- * insert an element to heap (note that the heap starts from the 1st index, not 0)
- *    
- *  heap: The heap, represented as an array
- *  heap_size: Current size of the heap
- *  desc: The description character array (created dynamically). It will be linked to the new heap element
- *  board: The board (created dynamically). It will be linked to the new heap element
- *  score: The f-score 
- *  g_score: The number of moves made to arrive at the current board position
- * 
- *  returns: 0
- */
-int insert_to_heap(State *heap, int *heap_size, char *desc, int **board, int score, int g_score){
-	
-	/* Add the element to the bottom level of the heap */
-	int child_idx, parent_idx;
-	*heap_size = (*heap_size) + 1;
-	heap[*heap_size].desc = desc;
-	heap[*heap_size].board = board;
-	heap[*heap_size].score = score;
-	heap[*heap_size].g_score = g_score;
-	
-	if (*heap_size == 1){
-		/* The heap has only 1 element so stop */
-		return 0;
-	}
-	child_idx = *heap_size;
-	parent_idx = child_idx / 2;
-	while (parent_idx != 0) {
-		/* Compare the added element with its parent; if they are in the correct order, stop. */
-		if (heap[parent_idx].score <= heap[child_idx].score){
-			return 0;
-		} else {
-			/* Swap the element with its parent and return to the previous step	*/
-			swap_two_states(&heap[parent_idx], &heap[child_idx]);
-			child_idx = parent_idx;
-			parent_idx /= 2;
-		}		
-	}
-	return 0;	
-}
-
-/*
- * Function:  extract_from_heap 
- * --------------------
- * Extract an element from the heap (note that the heap starts from the 1st index, not 0)
- *    
- *  heap: The heap, represented as an array
- *  heap_size: Current size of the heap
- *  desc: The description character array (output)
- *  board: The board (output)
- *  score: The f-score (output)
- *  g_score: The number of moves made to arrive at the current board position (output)
- * 
- *  returns: 0
- */
-int extract_from_heap(State *heap, int *heap_size, char **desc, int ***board, int *score, int *g_score){
-	int child_to_swap_with_idx, left_child_idx, right_child_idx, parent_idx;	
-	if ((*heap_size) == 0){
-		return 0;
-	}
-	/* Extract from root */	
-	(*desc) = heap[1].desc;
-	(*board) = heap[1].board;
-	(*score) = heap[1].score;
-	(*g_score) = heap[1].g_score;
-	
-	/* Replace the root of the heap with the last element on the last level */	
-	heap[1].desc = heap[*heap_size].desc;
-	heap[1].board = heap[*heap_size].board;
-	heap[1].score = heap[*heap_size].score;
-	heap[1].g_score = heap[*heap_size].g_score;
-	heap[*heap_size].desc = NULL;
-	heap[*heap_size].board = NULL;
-	*heap_size = (*heap_size) - 1;	
-	
-	if ((*heap_size) == 1) {
-		return 0;
-	}
-	
-	parent_idx = 1;	
-	while (1){
-		/* Compare the parent with its children; if they are in the correct order, stop	*/		
-		left_child_idx = 2*parent_idx ; 
-		right_child_idx = 2*parent_idx + 1;
-		child_to_swap_with_idx = parent_idx;
-		if (left_child_idx <= *heap_size){
-			if (heap[parent_idx].score > heap[left_child_idx].score){
-				child_to_swap_with_idx = left_child_idx;
-			}
-		}
-		if (right_child_idx <= *heap_size){
-			if (heap[left_child_idx].score > heap[right_child_idx].score){
-				child_to_swap_with_idx = right_child_idx;
-			}
-		}
-		if (child_to_swap_with_idx == parent_idx){
-			return 0;
-		}
-		/* If not, swap the parent with one of its children and return to the previous step. 
-		   (Swap with its smaller child in a min-heap and its larger child in a max-heap)
-		 */		 
-		swap_two_states(&heap[parent_idx], &heap[child_to_swap_with_idx]);
-		parent_idx = child_to_swap_with_idx;		
-	}	
-}
-
-/*
- * Function:  run 
- * --------------------
- * Run (N^2-1) solver using A-star algorithm
- *    
- *  start: The starting board
- *  goal: The goal
- *  N: width and height of the board 
- * 
- *  returns: 0
- */
-int run(const int** start, const int ** goal, int N){
-	int *current_cols, *current_rows, *goal_cols, *goal_rows; /* Position of each element */
-	int i,j;
-	int N_squared;
-	
-	State heap[MAX_HEAP_SIZE];
-	int heap_size = 0;
-	char *desc, *desc_2;	
-	int **board, **board_2;
-	int score, score_2;
-	int g_score, g_score_2;
-	/* int *list_of_valid_moves = (int *) malloc(sizeof(int) * NUM_OF_MOVES);
-	*/
-	int list_of_valid_moves[NUM_OF_MOVES];
-	int desc_length;
-	char move, go_back_move, last_move_by_current;
-	
-	/* Precompute positions for goal */
-	N_squared = N*N;
-	current_cols = (int *) malloc(sizeof(int) * N_squared);
-    current_rows = (int *) malloc(sizeof(int) * N_squared);
-    goal_cols = (int *) malloc(sizeof(int) * N_squared);
-    goal_rows = (int *) malloc(sizeof(int) * N_squared);
-	for (i = 0; i < N; i++){		
-		for (j = 0; j < N; j++){
-			goal_rows[goal[i][j]] = i;
-			goal_cols[goal[i][j]] = j;
-		}		
-	}
-	
-	/* First, insert the initial state into the heap */
-	desc = (char *) malloc(sizeof(char) * N_squared);
-	desc[0] = 'B';
-	desc[1] = '\0';	
-	board = new_board(N);
-	for (i = 0; i < N; i++){		
-		for (j = 0; j < N; j++){
-			board[i][j] = start[i][j];			
-		}		
-	}
-	g_score = 0;
-	score = g_score + h_score(board, current_rows, current_cols, 
-		(const int *) goal_rows, (const int *) goal_cols, N, N_squared);	
-	insert_to_heap(heap, &heap_size, desc, board, score, g_score);	
-	desc = NULL;
-	board = NULL;
-	
-	while (1){
-		/* Extract the state with the lowest score from the heap
-		 */
-		if (heap_size == 0){
-			printf("The heap is empty already! Something must be wrong! \n");
-			free(desc);
-			for (i = 0; i < N; i++){
-				free(board[i]);
-			}			
-			free(board);
-			free(current_cols);
-			free(current_rows);
-			free(goal_cols);
-			free(goal_rows);			
-			for (i = 1; i <= heap_size; i++){
-				free(heap[i].desc);
-				for (j = 0; j < N; j++){
-					free(heap[i].board[j]);
-				}
-				free(heap[i].board);
-			}
-			return 0;
-		}
-		if (desc != NULL){
-			free(desc);
-		}
-		if (board != NULL){					
-			for (i = 0; i < N; i++){
-				free(board[i]);
-			}
-			free(board);
-		}
-		extract_from_heap(heap, &heap_size, &desc, &board, &score, &g_score);
-		
-		/* If it is the goal state then stop and print the solution (don't forget to cleanup the memory!)
-		 */
-		if (is_goal((const int **) board, goal, N)){
-			print_solution(start, N, (const char *) desc);
-			free(desc);
-			for (i = 0; i < N; i++){
-				free(board[i]);
-			}
-			free(board);
-			free(current_cols);
-			free(current_rows);
-			free(goal_cols);
-			free(goal_rows);
-			for (i = 1; i <= heap_size; i++){
-				free(heap[i].desc);
-				for (j = 0; j < N; j++){
-					free(heap[i].board[j]);
-				}
-				free(heap[i].board);
-			}
-			return 0;
-		}
-		
-		/* Else insert all neighboring states (those that can be reached in one move 
-		   from the extracted state) onto the heap
-		 */
-		desc_length = strlen(desc);
-		last_move_by_current = desc[desc_length - 1]; /* desc always starts with 'B' so this is okay */			
-		valid_moves(board, N, list_of_valid_moves);
-		for (i = 0; i < NUM_OF_MOVES; i++){			
-			if (list_of_valid_moves[i] == 0){
-				continue;
-			}
-			switch (i) {
-				case 0:
-					move = 'u';
-					break;
-				case 1:
-					move = 'd';
-					break;
-				case 2:
-					move = 'l';
-					break;
-				case 3:
-					move = 'r';
-					break;
-			}			
-			switch (move) {
-				case 'u':
-					go_back_move = 'd';
-					break;
-				case 'd':
-					go_back_move = 'u';
-					break;
-				case 'l':
-					go_back_move = 'r';
-					break;
-				case 'r':
-					go_back_move = 'l';
-					break;
-			}
-			if (last_move_by_current == go_back_move){
-				continue;			
-			}
-			board_2 = move_board(board, N, move);			
-			desc_2 = move_desc(desc, move);
-			g_score_2 = g_score + 1;
-			score_2 = g_score_2 + h_score(board_2, current_rows, current_cols, (const int *)goal_rows, 
-				(const int *) goal_cols, N, N_squared);			
-			insert_to_heap(heap, &heap_size, desc_2, board_2, score_2, g_score_2);
-			board_2 = NULL;
-			desc_2 = NULL;			
-		}
-	}	
-}
+/* 
+	https://www.cs.princeton.edu/courses/archive/spr08/cos226/assignments/8puzzle.html
+	Should have been (N^2 - 1) puzzle but whatever
+	Anyway here we use the A star algorithm
+	Input: "start.txt" and "goal.txt". 
+	Output: The solution printed to screen
+	To compile with gcc, use:
+	gcc -ansi -pedantic -W -Wall -pthread -o N_puzzles N_puzzles.c
+	Then run:
+	./N_puzzles [-open heap|buckets] [-heuristic manhattan|linear|walking] [-threads T | -bidirectional | -memory MB 
+	            | -disk dir [-sort-buffer MB] [-io-buffer KB]]
+	-open selects the open list: a binary heap (default) or buckets indexed by f-score and g-score
+	-heuristic selects the estimate: Manhattan distance (default), Manhattan distance plus linear 
+	conflicts, or the walking distance (up to 4x4)
+	-threads runs Hash-Distributed A* (HDA*) with T threads, each owning the boards whose hash 
+	maps to it (up to 4x4)
+	-bidirectional searches from the start and from the goal at once (BAE*) until the two searches 
+	meet, and also prints where they met. It cannot be combined with -threads
+	-memory searches with SMA* in at most MB megabytes, set aside at the start: once they are used 
+	up, the worst leaves are evicted and their parents remember their f-scores, to expand them 
+	again if it comes to that. The solution is optimal if its path fits. A board already in 
+	memory is not stored again unless it was reached in fewer moves, so with memory to spare it 
+	expands about as many states as A*, and it does not run out of memory on hard instances. It 
+	cannot be combined with -threads or -bidirectional
+	-disk searches breadth-first with a threshold on the f-score that rises from one iteration to 
+	the next (BFIDA*), and keeps the layers of boards in files in the directory dir rather than in 
+	memory, a few bytes per board (9 for 4x4, 16 for 5x5). The children of a layer are sorted in 
+	runs of up to -sort-buffer MB megabytes (64 by default), which are merged into the next layer, 
+	dropping the copies of a board and the boards of the layer before (delayed duplicate 
+	detection). The files are read and written in order with a buffer of -io-buffer KB kilobytes 
+	(1024 by default) each. The directory should be on a local SSD: the runs are written and read 
+	once per layer, and the layers of the last iteration stay until the solution is traced back 
+	through them. It cannot be combined with -bidirectional or -memory, nor with -threads but in batch mode
+	To solve every instance of a file in the format of temp.txt instead of start.txt and goal.txt:
+	./N_puzzles -batch file [-open heap|buckets] [-heuristic ...] [-threads T] [-bidirectional | -memory MB | -disk dir ...]
+	The heuristic tables are set up once per distinct goal. In batch mode, -threads solves T 
+	instances at a time. The time, states expanded and length of each instance are reported, 
+	followed by the number of instances solved per second. -csv file and -json file also write 
+	them, with states/s and the peak RSS of the process, for benchmarks/run_benchmarks.sh.
+	A start from which the goal cannot be reached is turned down before any search, with exit 
+	status 2. In batch mode such an instance is reported as UNSOLVABLE, and the batch exits with 2 
+	if every other instance was solved. Any other instance that is not solved, for instance when 
+	no solution fits in -memory MB or the heuristic is not available, gives exit status 1.
+	Compiled with -DNPUZZLE_STATS, every search also counts the states expanded and generated, the 
+	heuristic evaluations, the pushes and pops of the open list, its largest size and the time, 
+	and prints them on exit as "stats:" lines of key=value pairs
+*/
+#define _POSIX_C_SOURCE 200112L /* For pthreads, sched_yield, clock_gettime and getpid */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#define NUM_OF_MOVES 4 /* Up, down, left, right */
+#define EXIT_UNSOLVABLE 2 /* Exit status when the goal cannot be reached from the start */
+#define INITIAL_HEAP_CAPACITY 1024 /* The heap and the state pool grow by doubling from here */
+#define INITIAL_POOL_CAPACITY 1024
+#define MAX_G_SCORE 0xFFFF /* g-scores are stored in the lower 16 bits of a heap key */
+#define INITIAL_BUCKET_CAPACITY 16
+#define INITIAL_CLOSED_SET_CAPACITY (1UL << 20) /* Must be a power of two */
+#define OPEN_LIST_HEAP 0
+#define OPEN_LIST_BUCKETS 1
+#define MAX_PACKED_N 4 /* Up to 4x4, a board fits in a uint64_t with 4 bits per tile */
+#define NO_PARENT -1
+#define HEURISTIC_MANHATTAN 0
+#define HEURISTIC_LINEAR_CONFLICT 1 /* Manhattan distance plus 2 moves per tile that must leave its goal line */
+#define HEURISTIC_WALKING_DISTANCE 2
+#define MAX_WALKING_DISTANCE_N 4 /* A walking distance key holds N*N counts of 3 bits and the line of 'x' */
+#define WALKING_DISTANCE_TABLE_SIZE (1UL << 16) /* Enough for the 24964 states of the 4x4 board */
+#define MAX_LINE_LENGTH 16 /* Longest row or column handled by line_conflicts */
+#define MAX_THREADS 256 /* The worker of a parent is kept in an unsigned char */
+#define MESSAGE_BATCH_SIZE 64 /* Children for another worker are sent this many at a time */
+#define FLUSH_INTERVAL 256 /* Expansions between sending batches that are not full yet */
+#define INITIAL_STATS_CAPACITY 64
+#define SMA_INFINITY MAX_G_SCORE /* Score of a node with no solution below it that fits in memory */
+#define DISK_MOVE_BITS 2 /* A record on disk keeps the move that reached its board in this many bits */
+#define DEFAULT_SORT_MEGABYTES 64
+#define DEFAULT_IO_BUFFER_KILOBYTES 1024
+#define MAX_IO_BUFFER_KILOBYTES (1L << 20)
+#define SORT_BLOCK_SIZE 16 /* Records sorted by insertion before they are merged */
+#define MAX_MERGE_WAYS 64 /* Runs merged at once, each with a file and a buffer of its own */
+
+#ifdef NPUZZLE_STATS
+#define STATS_COUNT(counter) ((counter)++)
+#else
+#define STATS_COUNT(counter) ((void) 0) /* The counters do not even exist without NPUZZLE_STATS */
+#endif
+
+static const char MOVE_CHARS[NUM_OF_MOVES] = {'u', 'd', 'l', 'r'}; /* Move i is undone by move (i ^ 1) */
+static const char *HEURISTIC_NAMES[] = {"manhattan", "linear", "walking"}; /* By HEURISTIC_* */
+static const char *OPEN_LIST_NAMES[] = {"astar-heap", "astar-buckets"}; /* By OPEN_LIST_*, as the solver in reports */
+static const char *BIDIRECTIONAL_NAMES[] = {"bae-heap", "bae-buckets"}; /* The same, with -bidirectional */
+static const char *BOUNDED_NAME = "sma-star"; /* With -memory, whatever the open list */
+static const char *DISK_NAME = "bfida-disk"; /* With -disk */
+
+typedef struct StateStruct {
+	int parent; /* Index of the state this one was reached from, or NO_PARENT for the start */
+	unsigned short g_score;
+	unsigned short h_score;
+	unsigned char move; /* The move made from the parent, as an index into MOVE_CHARS */
+	unsigned char closed; /* 1 once the state has been expanded */
+	unsigned char blank; /* Position (row*N + col) of 'x' */
+	unsigned char parent_owner; /* With -threads, the worker whose pool holds the parent */
+	unsigned short wd_rows; /* Walking distance indices of the board, only for HEURISTIC_WALKING_DISTANCE */
+	unsigned short wd_cols;
+} State;
+
+typedef struct StatePoolStruct {
+	State *states; /* Every state generated so far. The rest of the solver refers to them by index */
+	uint64_t *packed; /* packed[i] is the board of state i, 4 bits per tile (only if N <= MAX_PACKED_N) */
+	unsigned char *codes; /* codes[i*code_length ...] is the board of state i, one byte per tile (otherwise) */
+	uint64_t goal_packed;
+	unsigned char *goal_code;
+	int code_length;
+	int N;
+	int size; /* States 0 to size-1 are in use. Slot 'size' is where the next child is built */
+	int capacity;
+} StatePool;
+
+typedef struct EstimateStruct {
+	unsigned short h_score; /* With -bidirectional, the estimate of a state by the heuristic of the other side */
+	unsigned short wd_rows;
+	unsigned short wd_cols;
+} Estimate;
+
+typedef struct HeapEntryStruct {
+	unsigned int key; /* f-score in the upper 16 bits, (MAX_G_SCORE - g-score) in the lower 16 bits */
+	int state; /* Index of the state in the state pool */
+} HeapEntry;
+
+typedef struct HeapStruct {
+	HeapEntry *entries; /* Starts from the 1st index, not 0 */
+	int size;
+	int capacity;
+} Heap;
+
+typedef struct BucketStruct {
+	int *states; /* LIFO stack of state indices */
+	int size;
+	int capacity;
+} Bucket;
+
+typedef struct BucketQueueStruct {
+	Bucket *buckets; /* The bucket for (f, g) is buckets[f*(f+1)/2 + g], since 0 <= g <= f */
+	int *level_sizes; /* level_sizes[f] = number of states with this f-score */
+	int *top_g; /* top_g[f] = no bucket (f, g) with g > top_g[f] is occupied */
+	int num_levels; /* f-scores from 0 to num_levels-1 have buckets */
+	int min_f; /* no level below min_f is occupied */
+	int size;
+} BucketQueue;
+
+typedef struct ClosedSetEntryStruct {
+	unsigned int hash; /* Hash of the board, compared before the boards themselves */
+	int state; /* Index of the state in the state pool, or -1 if the slot is empty */
+} ClosedSetEntry;
+
+typedef struct ClosedSetStruct {
+	ClosedSetEntry *entries; /* Open addressing with linear probing */
+	unsigned long capacity; /* Always a power of two */
+	unsigned long size;
+} ClosedSet;
+
+typedef struct OpenListStruct {
+	int kind; /* OPEN_LIST_HEAP or OPEN_LIST_BUCKETS */
+	Heap heap;
+	BucketQueue buckets;
+#ifdef NPUZZLE_STATS
+	long num_pushes;
+	long num_pops;
+	long size; /* Entries in the open list, outdated ones included */
+	long max_size;
+#endif
+} OpenList;
+
+typedef struct IndexedHeapStruct {
+	HeapEntry *entries; /* Starts from the 1st index, as in Heap */
+	int *positions; /* positions[state] = index of the entry of the state, 0 if it is not in the heap */
+	int size;
+} IndexedHeap;
+
+typedef struct BoundedNodeStruct {
+	int children[NUM_OF_MOVES]; /* The child reached by each move while it is in memory, else -1. 
+	                               In a free slot, children[0] is the next free slot */
+	unsigned short f_score; /* Its f-score, raised to the score of its parent when it was generated (pathmax) */
+	unsigned short forgotten; /* Lowest score of the children evicted since it was last expanded, 
+	                             SMA_INFINITY if none */
+	unsigned char num_children; /* Children in memory */
+} BoundedNode;
+
+typedef struct BoundedSearchStruct {
+	StatePool pool; /* Of a fixed capacity, the slots of evicted states are used again */
+	BoundedNode *nodes; /* nodes[i] goes with state i of the pool */
+	IndexedHeap best; /* The open nodes, lowest score first, and deepest first among those */
+	IndexedHeap worst; /* The leaves, highest score first, and shallowest first among those */
+	ClosedSet boards; /* Every board in memory, with the node that reached it in the fewest moves. Of a fixed 
+	                     capacity, the evicted nodes are taken out */
+	int scratch; /* The slot past the others, where a child is built before it is known to be new */
+	int free_slots; /* First slot freed by an eviction, chained through children[0], or -1 */
+	int num_used; /* Slots from num_used on have never been used, so that the memory is only touched as needed */
+	int num_free; /* Both kinds */
+	long num_evicted;
+} BoundedSearch;
+
+typedef struct DiskFileStruct {
+	FILE *fid;
+	char *buffer; /* Its stdio buffer, of io_buffer_size bytes */
+} DiskFile;
+
+typedef struct DiskSearchStruct {
+	const char *directory;
+	char *file_name; /* Where the names of the files are built */
+	int id; /* Tells apart the files of searches run at the same time by one process */
+	int N;
+	int tile_bits; /* Bits per tile in a record */
+	int record_length; /* Bytes per record: the tiles, then the move in the low bits of the last byte */
+	size_t io_buffer_size;
+	unsigned char *sorted; /* Children waiting to be written as a run, sort_capacity records */
+	unsigned char *temp; /* As many again, to sort them */
+	long sort_capacity;
+	long num_sorted;
+	int first_run; /* The runs of the layer being generated are run files first_run to next_run-1 */
+	int next_run;
+	int num_layers; /* Layer files 0 to num_layers-1 are on disk */
+	long num_written; /* Records written to runs and layers */
+} DiskSearch;
+
+typedef struct WalkingDistanceStruct {
+	int N;
+	int num_states;
+	int capacity;
+	uint64_t *keys; /* keys[index] = tile counts and the line of 'x' (see walking_distance_key) */
+	unsigned char *distance; /* distance[index] = number of moves from the goal counts */
+	int *next; /* next[(index*2 + direction)*N + group] = index after a tile whose goal line is 'group' 
+	              slides into the line of 'x' from the line before it (direction 0) or after it (direction 1), 
+	              or -1 if there is no such tile */
+	int *table; /* Open addressing from keys to indices, WALKING_DISTANCE_TABLE_SIZE slots */
+} WalkingDistance;
+
+typedef struct HeuristicStruct {
+	int kind; /* HEURISTIC_MANHATTAN, HEURISTIC_LINEAR_CONFLICT or HEURISTIC_WALKING_DISTANCE */
+	int N;
+	const int *goal_rows;
+	const int *goal_cols;
+	WalkingDistance rows; /* Walking distance along the rows, only for HEURISTIC_WALKING_DISTANCE */
+	WalkingDistance cols; /* Walking distance along the columns */
+} Heuristic;
+
+typedef struct MessageStruct {
+	uint64_t board; /* The packed board of the child */
+	int parent; /* Index of the parent in the pool of its worker */
+	unsigned short g_score;
+	unsigned short h_score;
+	unsigned short wd_rows;
+	unsigned short wd_cols;
+	unsigned char parent_owner; /* The worker of the parent */
+	unsigned char move;
+	unsigned char blank;
+} Message;
+
+typedef struct BatchStruct {
+	struct BatchStruct *next; /* The batch pushed before it onto the same inbox */
+	int size;
+	Message messages[MESSAGE_BATCH_SIZE];
+} Batch;
+
+typedef struct WorkerStruct {
+	struct ParallelSearchStruct *shared;
+	int id;
+	StatePool pool; /* The boards that belong to this worker */
+	OpenList open;
+	ClosedSet closed;
+	Batch * volatile inbox; /* Pushed onto by the other workers, taken all at once by this one */
+	Batch *outgoing[MAX_THREADS]; /* The batch being filled for each worker */
+	long num_expanded;
+	long num_reopened;
+#ifdef NPUZZLE_STATS
+	long num_evaluations;
+#endif
+} Worker;
+
+typedef struct ParallelSearchStruct {
+	Worker *workers;
+	int num_threads;
+	const Heuristic *heuristic;
+	volatile long num_active; /* Workers that are not idle plus batches not taken in yet. 0 means done */
+	volatile int failed; /* Set when a worker runs out of memory */
+	pthread_mutex_t best_lock;
+	volatile int best_cost; /* Length of the best solution so far, MAX_G_SCORE if there is none */
+	int best_owner; /* The goal state of that solution */
+	int best_state;
+} ParallelSearch;
+
+#ifdef NPUZZLE_STATS
+typedef struct SearchStatsStruct {
+	int search; /* Number of the search, from 1, to tell apart the instances of a batch */
+	int num_threads;
+	long num_expanded;
+	long num_generated;
+	long num_evaluations;
+	long num_pushes;
+	long num_pops;
+	long max_open_size; /* With several threads, the largest open list of any worker */
+	double seconds;
+} SearchStats;
+
+typedef struct StatisticsStruct {
+	pthread_mutex_t lock;
+	int num_searches;
+	SearchStats *searches; /* In the order they finished */
+	int num_recorded;
+	int capacity;
+} Statistics;
+
+static Statistics statistics = {PTHREAD_MUTEX_INITIALIZER, 0, NULL, 0, 0};
+#endif
+
+typedef struct OptionsStruct {
+	int open_list; /* OPEN_LIST_HEAP or OPEN_LIST_BUCKETS */
+	int heuristic; /* HEURISTIC_MANHATTAN, HEURISTIC_LINEAR_CONFLICT or HEURISTIC_WALKING_DISTANCE */
+	int num_threads; /* More than 1 for HDA*, or for solving several instances at a time with -batch */
+	int bidirectional; /* 1 to search from both ends with solve_bidirectional */
+	long memory_megabytes; /* If more than 0, search with solve_bounded in at most this much memory */
+	const char *disk_directory; /* If set, search with solve_on_disk, keeping its files here */
+	long sort_megabytes; /* Memory of solve_on_disk for sorting children into runs */
+	long io_buffer_kilobytes; /* Buffer of each file solve_on_disk reads or writes */
+	const char *batch_file; /* If set, solve every instance of this file instead of start.txt and goal.txt */
+	const char *csv_file; /* If set, the results of the batch also go to this file as CSV */
+	const char *json_file; /* And to this one as JSON */
+} Options;
+
+typedef struct GoalTableStruct {
+	struct GoalTableStruct *next;
+	int N;
+	int *goal_rows;
+	int *goal_cols;
+	int ready; /* 0 if the heuristic is not available for this goal */
+	Heuristic heuristic; /* Only read once set up, by every thread solving an instance with this goal */
+} GoalTable;
+
+typedef struct BatchSearchStruct {
+	FILE *fid;
+	const Options *options;
+	pthread_mutex_t lock; /* Held to read the file, to set up goal tables, to update the counts and to print */
+	int num_read;
+	int malformed; /* Set to 1 when an instance cannot be read, which ends the batch */
+	GoalTable *goal_tables; /* One per distinct goal read so far */
+	int num_solved;
+	int num_unsolvable; /* Instances whose goal cannot be reached, not searched */
+	long num_expanded;
+	FILE *csv; /* NULL without -csv */
+	FILE *json; /* NULL without -json */
+	int num_reported;
+} BatchSearch;
+
+int** new_board(int N);
+
+int print_board(int** board, int N);
+
+int free_board(int** board, int N);
+
+char* build_desc(const StatePool *pool, int state);
+
+char* build_bidirectional_desc(const StatePool *forward, int forward_state, const StatePool *backward, 
+	int backward_state, int *meeting);
+
+int print_solution(const int **start, int N, const char *desc);
+
+int encode_board(const int **board, int N, unsigned char *code);
+
+uint64_t pack_board(const int **board, int N);
+
+int is_solvable(const int **start, const int **goal, int N);
+
+unsigned int hash_code(const unsigned char *code, int code_length);
+
+int new_state_pool(StatePool *pool, const int **goal, int N);
+
+int reserve_state(StatePool *pool);
+
+int new_state(StatePool *pool, int parent, int move, int g_score, int h_score, int blank);
+
+int free_state_pool(StatePool *pool);
+
+int find_blank(const StatePool *pool, int state);
+
+int move_state(StatePool *pool, int state, int child, int blank, int new_blank);
+
+int line_conflicts(const Heuristic *heuristic, const int *tiles, int line, int is_row);
+
+uint64_t walking_distance_key(const int *tiles, const int *goal_lines, int N, int is_row);
+
+int find_walking_distance(const WalkingDistance *wd, uint64_t key);
+
+int add_walking_distance(WalkingDistance *wd, uint64_t key, int distance);
+
+int build_walking_distance(WalkingDistance *wd, uint64_t goal_key, int N);
+
+int free_walking_distance(WalkingDistance *wd);
+
+int new_heuristic(Heuristic *heuristic, int kind, const int *goal_rows, const int *goal_cols, int N);
+
+int free_heuristic(Heuristic *heuristic);
+
+int heuristic_value(const Heuristic *heuristic, const int *tiles, int *wd_rows, int *wd_cols);
+
+int h_score(const StatePool *pool, int state, const Heuristic *heuristic, int *wd_rows, int *wd_cols);
+
+int state_line(const StatePool *pool, int state, int line, int is_row, int *tiles);
+
+int conflicts_change(const Heuristic *heuristic, const StatePool *pool, int state, int child, int is_row, 
+	int line_1, int line_2);
+
+int child_h_score(const Heuristic *heuristic, const StatePool *pool, int state, int h, int child, int move, 
+	int tile, int blank, int new_blank, int *wd_rows, int *wd_cols);
+
+unsigned int hash_state(const StatePool *pool, int state);
+
+int same_board(const StatePool *pool, int state_1, int state_2);
+
+int copy_board(StatePool *pool, int state, const StatePool *from, int from_state);
+
+int is_goal(const StatePool *pool, int state);
+
+int new_heap(Heap *heap);
+
+int free_heap(Heap *heap);
+	
+int insert_to_heap(Heap *heap, int state, int score, int g_score);
+
+int extract_from_heap(Heap *heap, int *state);
+
+int new_bucket_queue(BucketQueue *queue);
+
+int free_bucket_queue(BucketQueue *queue);
+
+int insert_to_buckets(BucketQueue *queue, int state, int score, int g_score);
+
+int extract_from_buckets(BucketQueue *queue, int *state);
+
+int new_closed_set(ClosedSet *closed, unsigned long capacity);
+
+int free_closed_set(ClosedSet *closed);
+
+int find_in_closed_set(const ClosedSet *closed, const StatePool *pool, int state, unsigned int hash);
+
+int add_to_closed_set(ClosedSet *closed, int state, unsigned int hash);
+
+int remove_from_closed_set(ClosedSet *closed, int state, unsigned int hash);
+
+int new_open_list(OpenList *open, int kind);
+
+int free_open_list(OpenList *open);
+
+int insert_to_open_list(OpenList *open, int state, int score, int g_score);
+
+int extract_from_open_list(OpenList *open, int *state);
+
+int min_score_in_open_list(OpenList *open);
+
+int new_indexed_heap(IndexedHeap *heap, int capacity);
+
+int free_indexed_heap(IndexedHeap *heap);
+
+int sift_indexed_heap(IndexedHeap *heap, int index, HeapEntry entry);
+
+int update_indexed_heap(IndexedHeap *heap, int state, unsigned int key);
+
+int remove_from_indexed_heap(IndexedHeap *heap, int state);
+	
+int owner_of(unsigned int hash, int num_threads);
+
+int flush_batch(ParallelSearch *shared, Worker *worker, int owner);
+
+int send_child(ParallelSearch *shared, Worker *worker, int owner, const Message *message);
+
+int add_child(ParallelSearch *shared, Worker *worker, const Message *message);
+
+void* parallel_worker(void *arg);
+
+char* build_parallel_desc(const Worker *workers, int owner, int state);
+
+int run_parallel(const int **start, const int **goal, int N, const Heuristic *heuristic, const Options *options);
+
+double seconds_since(const struct timespec *start);
+
+int solve(const int** start, const int ** goal, int N, const Heuristic *heuristic, int open_list, char **desc, 
+	long *num_expanded, long *num_generated, long *num_reopened);
+
+int solve_bidirectional(const int** start, const int ** goal, int N, const Heuristic *heuristic, int open_list, 
+	char **desc, int *meeting, long *num_expanded, long *num_generated, long *num_reopened);
+
+int bounded_score(const BoundedSearch *search, int state);
+
+int place_bounded_node(BoundedSearch *search, int state);
+
+int evict_worst_leaf(BoundedSearch *search, int expanding);
+
+int solve_bounded(const int** start, const int ** goal, int N, const Heuristic *heuristic, long memory_megabytes, 
+	char **desc, long *num_expanded, long *num_generated, long *num_evicted);
+
+int move_blank(int blank, int move, int N);
+
+int encode_record(const DiskSearch *search, const int *tiles, int move, unsigned char *record);
+
+int decode_record(const DiskSearch *search, const unsigned char *record, int *tiles);
+
+int compare_records(const unsigned char *record_1, const unsigned char *record_2, int record_length);
+
+unsigned char* sort_records(unsigned char *records, unsigned char *temp, long num_records, int record_length);
+
+const char* disk_file_name(DiskSearch *search, const char *kind, int number);
+
+int open_disk_file(DiskSearch *search, DiskFile *file, const char *kind, int number, const char *mode);
+
+int close_disk_file(const DiskSearch *search, DiskFile *file);
+
+int write_run(DiskSearch *search);
+
+int merge_runs(DiskSearch *search, int first, int last, DiskFile *output, DiskFile *previous, long *num_records);
+
+int find_record(DiskSearch *search, int layer, unsigned char *record);
+
+int solve_on_disk(const int** start, const int ** goal, int N, const Heuristic *heuristic, const Options *options, 
+	int id, char **desc, long *num_expanded, long *num_generated, double *megabytes_written);
+
+int run(const int** start, const int ** goal, int N, const Options *options);
+
+int read_instance(FILE *fid, int *N, int ***start, int ***goal);
+
+GoalTable* goal_table(BatchSearch *batch, const int **goal, int N);
+
+long peak_rss(void);
+
+int report_instance(BatchSearch *batch, int index, int N, int solvable, const char *solution, long num_expanded, 
+	double seconds);
+
+void* batch_worker(void *arg);
+
+int run_batch(const char *file_name, const Options *options);
+
+#ifdef NPUZZLE_STATS
+int record_search(int num_threads, long num_expanded, long num_generated, long num_evaluations, 
+	const OpenList *open, int num_open, double seconds);
+
+void print_statistics(void);
+#endif
+
+int main(int argc, char **argv)
+{
+   
+   FILE *fid;
+   int N, i, j, status;   
+   int **start, **goal;     
+   Options options;
+   
+   options.open_list = OPEN_LIST_HEAP;
+   options.heuristic = HEURISTIC_MANHATTAN;
+   options.num_threads = 1;
+   options.bidirectional = 0;
+   options.memory_megabytes = 0;
+   options.disk_directory = NULL;
+   options.sort_megabytes = DEFAULT_SORT_MEGABYTES;
+   options.io_buffer_kilobytes = DEFAULT_IO_BUFFER_KILOBYTES;
+   options.batch_file = NULL;
+   options.csv_file = NULL;
+   options.json_file = NULL;
+#ifdef NPUZZLE_STATS
+   atexit(print_statistics);
+#endif
+   for (i = 1; i < argc; i++){
+	   if ((strcmp(argv[i], "-open") == 0) && (i + 1 < argc)){
+		   i++;
+		   if (strcmp(argv[i], "heap") == 0){
+			   options.open_list = OPEN_LIST_HEAP;
+		   } else if (strcmp(argv[i], "buckets") == 0){
+			   options.open_list = OPEN_LIST_BUCKETS;
+		   } else {
+			   printf("Unknown open list: %s \n", argv[i]);
+			   return 1;
+		   }
+	   } else if ((strcmp(argv[i], "-heuristic") == 0) && (i + 1 < argc)){
+		   i++;
+		   if (strcmp(argv[i], "manhattan") == 0){
+			   options.heuristic = HEURISTIC_MANHATTAN;
+		   } else if (strcmp(argv[i], "linear") == 0){
+			   options.heuristic = HEURISTIC_LINEAR_CONFLICT;
+		   } else if (strcmp(argv[i], "walking") == 0){
+			   options.heuristic = HEURISTIC_WALKING_DISTANCE;
+		   } else {
+			   printf("Unknown heuristic: %s \n", argv[i]);
+			   return 1;
+		   }
+	   } else if ((strcmp(argv[i], "-threads") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.num_threads = atoi(argv[i]);
+		   if ((options.num_threads < 1) || (options.num_threads > MAX_THREADS)){
+			   printf("The number of threads must be between 1 and %d \n", MAX_THREADS);
+			   return 1;
+		   }
+	   } else if (strcmp(argv[i], "-bidirectional") == 0){
+		   options.bidirectional = 1;
+	   } else if ((strcmp(argv[i], "-memory") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.memory_megabytes = atol(argv[i]);
+		   if (options.memory_megabytes < 1){
+			   printf("The memory-bounded search needs at least 1 megabyte \n");
+			   return 1;
+		   }
+	   } else if ((strcmp(argv[i], "-disk") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.disk_directory = argv[i];
+	   } else if ((strcmp(argv[i], "-sort-buffer") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.sort_megabytes = atol(argv[i]);
+		   if (options.sort_megabytes < 1){
+			   printf("The sort buffer needs at least 1 megabyte \n");
+			   return 1;
+		   }
+	   } else if ((strcmp(argv[i], "-io-buffer") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.io_buffer_kilobytes = atol(argv[i]);
+		   if ((options.io_buffer_kilobytes < 1) || (options.io_buffer_kilobytes > MAX_IO_BUFFER_KILOBYTES)){
+			   printf("The I/O buffers must be between 1 and %ld kilobytes \n", MAX_IO_BUFFER_KILOBYTES);
+			   return 1;
+		   }
+	   } else if ((strcmp(argv[i], "-batch") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.batch_file = argv[i];
+	   } else if ((strcmp(argv[i], "-csv") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.csv_file = argv[i];
+	   } else if ((strcmp(argv[i], "-json") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.json_file = argv[i];
+	   } else {
+		   printf("Usage: %s [-open heap|buckets] [-heuristic manhattan|linear|walking] [-threads T | -bidirectional | -memory MB \n", argv[0]);
+		   printf("          | -disk dir [-sort-buffer MB] [-io-buffer KB]] \n");
+		   printf("       %s -batch file [-open heap|buckets] [-heuristic ...] [-threads T] [-bidirectional | -memory MB \n", argv[0]);
+		   printf("          | -disk dir [-sort-buffer MB] [-io-buffer KB]] [-csv file] [-json file] \n");
+		   return 1;
+	   }
+   }
+   if (options.bidirectional && (options.num_threads > 1) && (options.batch_file == NULL)){
+	   printf("-bidirectional searches on one thread, -threads only goes with it in batch mode \n");
+	   return 1;
+   }
+   if ((options.memory_megabytes > 0) && (options.bidirectional 
+	   || ((options.num_threads > 1) && (options.batch_file == NULL)))){
+	   printf("-memory searches on one thread in one direction, -threads only goes with it in batch mode \n");
+	   return 1;
+   }
+   if ((options.disk_directory != NULL) && ((options.memory_megabytes > 0) || options.bidirectional 
+	   || ((options.num_threads > 1) && (options.batch_file == NULL)))){
+	   printf("-disk searches on one thread in one direction without -memory, -threads only goes with it in batch mode \n");
+	   return 1;
+   }
+   if (options.batch_file != NULL){
+	   return run_batch(options.batch_file, (const Options *) &options);
+   }
+  
+   /* Read start position */
+   fid = fopen("start.txt", "rt");
+   fscanf(fid, "%d ", &N);   
+   start = new_board(N);
+   for (i = 0; i < N; i++){
+	   for (j = 0; j < N; j++){
+		   fscanf(fid, "%d ", &start[i][j]);
+	   }
+   }
+   fclose(fid);
+      
+   /* Read goal position */
+   fid = fopen("goal.txt", "rt");   
+   goal = new_board(N);
+   for (i = 0; i < N; i++){
+	   for (j = 0; j < N; j++){
+		   fscanf(fid, "%d ", &goal[i][j]);
+	   }
+   }
+   fclose(fid);   
+   
+   status = run((const int**) start, (const int **) goal, N, &options);    
+   
+   free_board(start, N);   
+   free_board(goal, N);    
+   return status;
+}
+
+int** new_board(int N){
+   int **board, i;
+   board = (int **) malloc(sizeof(int *) * N);
+   for (i = 0; i < N; i++){
+	   board[i] = (int *) malloc(sizeof(int) * N);
+   }
+   return board;
+}
+
+/*
+ * Function:  print_board 
+ * --------------------
+ * Print the board
+ *    
+ *  board: The board configuration 
+ *  N: width and height of the board 
+ * 
+ *  returns: 0
+ */
+int print_board(int** board, int N){
+	int i, j;	
+	for (i = 0; i < N; i++){		
+		for (j = 0; j < N; j++){
+			if (board[i][j] == 0) {
+				printf("x ");
+			} else {
+				printf("%d ", board[i][j]);
+			}
+		}
+		printf("\n");
+	}
+	return 0;
+}
+
+/*
+ * Function:  free_board 
+ * --------------------
+ * Free the board
+ *    
+ *  board: The board configuration 
+ *  N: width and height of the board 
+ * 
+ *  returns: 0
+ */
+int free_board(int** board, int N){
+	int i;
+	for (i = 0; i < N; i++){
+		free(board[i]);
+	}
+	free(board);
+	return 0;
+}
+
+/*
+ * Function:  build_desc 
+ * --------------------
+ * Create the move description (e.g: Brdrd) of a state by following the parent links back to the start
+ *    
+ *  pool: The state pool
+ *  state: Index of the state
+ *
+ *  returns: a new dynamically created move description (that must be freed afterwards)
+ */
+char* build_desc(const StatePool *pool, int state){
+	int desc_length = pool->states[state].g_score + 1;
+	char *desc = (char *) malloc(sizeof(char) * (desc_length+1));
+	desc[0] = 'B';
+	desc[desc_length] = '\0';
+	while (pool->states[state].parent != NO_PARENT){
+		desc_length--;
+		desc[desc_length] = MOVE_CHARS[pool->states[state].move];
+		state = pool->states[state].parent;
+	}
+	return desc;
+}
+
+/*
+ * Function:  build_bidirectional_desc 
+ * --------------------
+ * Create the move description of a solution found by solve_bidirectional: the moves from the start 
+ * to the meeting point, then those from the goal to the meeting point, backwards and undone
+ *    
+ *  forward: The state pool of the search from the start
+ *  forward_state: Index of the meeting point in it
+ *  backward: The state pool of the search from the goal
+ *  backward_state: Index of the meeting point in it
+ *  meeting: Set to the number of moves before the meeting point
+ *
+ *  returns: a new dynamically created move description (that must be freed afterwards)
+ */
+char* build_bidirectional_desc(const StatePool *forward, int forward_state, const StatePool *backward, 
+	int backward_state, int *meeting){
+	int state, desc_length, i;
+	char *desc;
+	*meeting = 0;
+	for (state = forward_state; forward->states[state].parent != NO_PARENT; state = forward->states[state].parent){
+		(*meeting)++;
+	}
+	desc_length = *meeting + 1;
+	for (state = backward_state; backward->states[state].parent != NO_PARENT; state = backward->states[state].parent){
+		desc_length++;
+	}
+	desc = (char *) malloc(sizeof(char) * (desc_length+1));
+	if (desc == NULL){
+		return NULL;
+	}
+	desc[0] = 'B';
+	desc[desc_length] = '\0';
+	i = *meeting;
+	for (state = forward_state; forward->states[state].parent != NO_PARENT; state = forward->states[state].parent){
+		desc[i] = MOVE_CHARS[forward->states[state].move];
+		i--;
+	}
+	i = *meeting + 1;
+	for (state = backward_state; backward->states[state].parent != NO_PARENT; state = backward->states[state].parent){
+		desc[i] = MOVE_CHARS[backward->states[state].move ^ 1];
+		i++;
+	}
+	return desc;
+}
+
+/*
+ * Function:  print_solution 
+ * --------------------
+ * Print the optimal solution
+ *    
+ *  start: The start state *  
+ *  N: width and height of the board 
+ *  desc: A descriptions of the moves to get from the start state to the goal state'
+ *  For example : "Brdrd" would be "right, down, right, down" 
+ *  u: Up, d: Down, l: Left, r: Right. B denotes the starting position
+ *
+ *  returns: 0
+ */
+int print_solution(const int **start, int N, const char *desc){
+	int **board, i, j, temp, x_row, x_col, new_x_row, new_x_col;	
+	char move;
+	board = new_board(N);
+	x_row = 0; /* Found below, the start always has an 'x' */
+	x_col = 0;
+	for (i = 0; i < N; i++){		
+		for (j = 0; j < N; j++){
+			board[i][j] = start[i][j];	
+			if (board[i][j] == 0) {
+				x_row = i;
+				x_col = j;
+			} 			
+		}		
+	}
+	printf("Moves to get to the solution: %s \n", desc);
+	
+	printf("The solution: \n");	
+	i = 1;
+	while (1) {
+		print_board(board, N);
+		printf(" => \n\n");		
+		move = desc[i];
+		if (move == '\0'){
+			printf("The end!\n");
+			for (i = 0; i < N; i++){
+				free(board[i]);
+			}
+			free(board);
+			return 0;
+		}
+		switch (move){
+			case 'u':
+				/* Up */
+				new_x_row = x_row - 1;
+				new_x_col = x_col;
+				break;
+			case 'd':
+				/* Down */
+				new_x_row = x_row + 1;
+				new_x_col = x_col;
+				break;
+			case 'l':
+				/* Left */
+				new_x_row = x_row;
+				new_x_col = x_col - 1;
+				break;
+			default:
+				/* Right */
+				new_x_row = x_row;
+				new_x_col = x_col + 1;
+				break;		
+		}
+		temp = board[new_x_row][new_x_col];
+		board[new_x_row][new_x_col] = board[x_row][x_col];
+		board[x_row][x_col] = temp;	
+		x_row = new_x_row;
+		x_col = new_x_col;
+		i++;
+	}	
+	return 0;
+}
+
+/*
+ * Function:  encode_board 
+ * --------------------
+ * Write the one-byte-per-tile encoding of a board, row by row
+ *    
+ *  board: The board configuration 
+ *  N: width and height of the board 
+ *  code: The array of size N*N receiving the encoding (output)
+ * 
+ *  returns: 0
+ */
+int encode_board(const int **board, int N, unsigned char *code){
+	int i, j;
+	for (i = 0; i < N; i++){
+		for (j = 0; j < N; j++){
+			code[i*N + j] = (unsigned char) board[i][j];
+		}
+	}
+	return 0;
+}
+
+/*
+ * Function:  pack_board 
+ * --------------------
+ * Pack a board of width at most MAX_PACKED_N into 64 bits. 
+ * The tile at position p = row*N + col takes bits 4p to 4p+3
+ *    
+ *  board: The board configuration 
+ *  N: width and height of the board 
+ * 
+ *  returns: the packed board
+ */
+uint64_t pack_board(const int **board, int N){
+	uint64_t packed = 0;
+	int i, j;
+	for (i = 0; i < N; i++){
+		for (j = 0; j < N; j++){
+			packed |= (uint64_t) board[i][j] << (4 * (i*N + j));
+		}
+	}
+	return packed;
+}
+
+/*
+ * Function:  is_solvable 
+ * --------------------
+ * Whether the goal can be reached from the start at all. Every move swaps 'x' with a tile, which 
+ * flips both the parity of the permutation taking the start to the goal and the parity of the 
+ * distance of 'x' from its place in the goal, and the goal is reachable exactly when the two agree. 
+ * For the usual goal with 'x' in the last row this is the familiar rule on inversions and the row 
+ * of 'x', but it holds for any goal
+ *    
+ *  start: The starting board
+ *  goal: The goal
+ *  N: width and height of the board 
+ * 
+ *  returns: 1 if the goal can be reached, 0 if not, -1 if there is not enough memory to tell
+ */
+int is_solvable(const int **start, const int **goal, int N){
+	int *goal_positions, *permutation;
+	int i, j, next, num_cycles = 0, blank_distance = 0, solvable;
+	goal_positions = (int *) malloc(sizeof(int) * 2 * N * N);
+	if (goal_positions == NULL){
+		return -1;
+	}
+	permutation = goal_positions + N*N;
+	for (i = 0; i < N; i++){
+		for (j = 0; j < N; j++){
+			goal_positions[goal[i][j]] = i*N + j;
+		}
+	}
+	for (i = 0; i < N; i++){
+		for (j = 0; j < N; j++){
+			/* Where the tile at (i, j) has to go */
+			permutation[i*N + j] = goal_positions[start[i][j]];
+			if (start[i][j] == 0){
+				blank_distance = abs(i - goal_positions[0] / N) + abs(j - goal_positions[0] % N);
+			}
+		}
+	}
+	for (i = 0; i < N*N; i++){
+		if (permutation[i] < 0){
+			continue;
+		}
+		num_cycles++;
+		for (j = i; permutation[j] >= 0; j = next){
+			next = permutation[j];
+			permutation[j] = -1;
+		}
+	}
+	/* A permutation of N*N elements with c cycles is N*N - c transpositions */
+	solvable = ((N*N - num_cycles) % 2 == blank_distance % 2);
+	free(goal_positions);
+	return solvable;
+}
+
+/*
+ * Function:  hash_code 
+ * --------------------
+ * Hash a one-byte-per-tile board code (FNV-1a)
+ *    
+ *  code: The board code
+ *  code_length: Number of bytes in the code
+ * 
+ *  returns: the hash
+ */
+unsigned int hash_code(const unsigned char *code, int code_length){
+	unsigned int hash = 2166136261U;
+	int i;
+	for (i = 0; i < code_length; i++){
+		hash ^= code[i];
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+/*
+ * Function:  new_state_pool 
+ * --------------------
+ * Initialize an empty state pool. Memory is allocated on the first insertion. 
+ * Boards up to MAX_PACKED_N wide are stored packed, larger ones one byte per tile
+ *    
+ *  pool: The state pool
+ *  goal: The goal, kept in the same representation for is_goal()
+ *  N: width and height of the board 
+ * 
+ *  returns: 0
+ */
+int new_state_pool(StatePool *pool, const int **goal, int N){
+	pool->states = NULL;
+	pool->packed = NULL;
+	pool->codes = NULL;
+	pool->goal_packed = 0;
+	pool->goal_code = NULL;
+	pool->code_length = N*N;
+	pool->N = N;
+	pool->size = 0;
+	pool->capacity = 0;
+	if (N <= MAX_PACKED_N){
+		pool->goal_packed = pack_board(goal, N);
+	} else {
+		pool->goal_code = (unsigned char *) malloc(sizeof(unsigned char) * pool->code_length);
+		encode_board(goal, N, pool->goal_code);
+	}
+	return 0;
+}
+
+/*
+ * Function:  reserve_state 
+ * --------------------
+ * Make sure that slot pool->size exists so that a child board can be built there 
+ * before deciding whether to keep it
+ *    
+ *  pool: The state pool
+ * 
+ *  returns: the index of the free slot, or -1 if the pool could not grow
+ */
+int reserve_state(StatePool *pool){
+	State *states;
+	uint64_t *packed;
+	unsigned char *codes;
+	int capacity;
+	if (pool->size == pool->capacity){
+		capacity = (pool->capacity == 0) ? INITIAL_POOL_CAPACITY : 2 * pool->capacity;
+		states = (State *) realloc(pool->states, sizeof(State) * capacity);
+		if (states == NULL){
+			return -1;
+		}
+		pool->states = states;
+		if (pool->N <= MAX_PACKED_N){
+			packed = (uint64_t *) realloc(pool->packed, sizeof(uint64_t) * capacity);
+			if (packed == NULL){
+				return -1;
+			}
+			pool->packed = packed;
+		} else {
+			codes = (unsigned char *) realloc(pool->codes, sizeof(unsigned char) * capacity * pool->code_length);
+			if (codes == NULL){
+				return -1;
+			}
+			pool->codes = codes;
+		}
+		pool->capacity = capacity;
+	}
+	return pool->size;
+}
+
+/*
+ * Function:  new_state 
+ * --------------------
+ * Keep the board built in the reserved slot (see reserve_state) as a new state
+ *    
+ *  pool: The state pool
+ *  parent: Index of the state the board was reached from, or NO_PARENT
+ *  move: The move made from the parent (index into MOVE_CHARS)
+ *  g_score: The number of moves made to arrive at the current board position
+ *  h_score: The heuristic estimate of the board
+ *  blank: Position of 'x' on the board
+ * 
+ *  returns: the index of the new state
+ */
+int new_state(StatePool *pool, int parent, int move, int g_score, int h_score, int blank){
+	pool->states[pool->size].parent = parent;
+	pool->states[pool->size].move = (unsigned char) move;
+	pool->states[pool->size].g_score = (unsigned short) g_score;
+	pool->states[pool->size].h_score = (unsigned short) h_score;
+	pool->states[pool->size].closed = 0;
+	pool->states[pool->size].blank = (unsigned char) blank;
+	pool->states[pool->size].parent_owner = 0;
+	pool->states[pool->size].wd_rows = 0;
+	pool->states[pool->size].wd_cols = 0;
+	pool->size++;
+	return pool->size - 1;
+}
+
+/*
+ * Function:  free_state_pool 
+ * --------------------
+ * Free the state pool
+ *    
+ *  pool: The state pool
+ * 
+ *  returns: 0
+ */
+int free_state_pool(StatePool *pool){
+	free(pool->states);
+	free(pool->packed);
+	free(pool->codes);
+	free(pool->goal_code);
+	pool->states = NULL;
+	pool->packed = NULL;
+	pool->codes = NULL;
+	pool->goal_code = NULL;
+	pool->size = 0;
+	pool->capacity = 0;
+	return 0;
+}
+
+/*
+ * Function:  find_blank 
+ * --------------------
+ * Find the position (row*N + col) of 'x' on the board of a state
+ *    
+ *  pool: The state pool
+ *  state: Index of the state
+ * 
+ *  returns: the position of 'x'
+ */
+int find_blank(const StatePool *pool, int state){
+	uint64_t packed;
+	const unsigned char *code;
+	int i;
+	if (pool->N <= MAX_PACKED_N){
+		packed = pool->packed[state];
+		for (i = 0; ((packed >> (4 * i)) & 0xF) != 0; i++){
+		}
+		return i;
+	}
+	code = &pool->codes[state * pool->code_length];
+	for (i = 0; code[i] != 0; i++){
+	}
+	return i;
+}
+
+/*
+ * Function:  move_state 
+ * --------------------
+ * Build the board reached by sliding the tile at new_blank into the blank. 
+ * For packed boards this is a mask and two shifts, since the blank nibble is 0
+ *    
+ *  pool: The state pool
+ *  state: Index of the current state
+ *  child: Index of the slot receiving the new board (usually the reserved one)
+ *  blank: Position of 'x' in the current state
+ *  new_blank: Position of 'x' after the move
+ * 
+ *  returns: the tile that was moved
+ */
+int move_state(StatePool *pool, int state, int child, int blank, int new_blank){
+	uint64_t packed, tile;
+	unsigned char *code;
+	if (pool->N <= MAX_PACKED_N){
+		packed = pool->packed[state];
+		tile = (packed >> (4 * new_blank)) & 0xF;
+		pool->packed[child] = (packed & ~((uint64_t) 0xF << (4 * new_blank))) | (tile << (4 * blank));
+		return (int) tile;
+	}
+	code = &pool->codes[child * pool->code_length];
+	memcpy(code, &pool->codes[state * pool->code_length], pool->code_length);
+	code[blank] = code[new_blank];
+	code[new_blank] = 0;
+	return code[blank];
+}
+
+/*
+ * Function:  line_conflicts 
+ * --------------------
+ * Linear conflicts on one row or column: the tiles whose goal is on this line must be in 
+ * increasing goal order to reach it without leaving the line. Every tile outside the longest 
+ * increasing run has to step out of the line and back, which costs 2 moves on top of its 
+ * Manhattan distance
+ *    
+ *  heuristic: The heuristic
+ *  tiles: The N tiles on the line, in order
+ *  line: Index of the row or column
+ *  is_row: 1 if the line is a row, 0 if it is a column
+ * 
+ *  returns: the number of extra moves
+ */
+int line_conflicts(const Heuristic *heuristic, const int *tiles, int line, int is_row){
+	const int *goal_lines = is_row ? heuristic->goal_rows : heuristic->goal_cols;
+	const int *goal_places = is_row ? heuristic->goal_cols : heuristic->goal_rows;
+	int places[MAX_LINE_LENGTH], longest[MAX_LINE_LENGTH];
+	int i, j, num_places = 0, longest_run = 0;
+	for (i = 0; i < heuristic->N; i++){
+		if ((tiles[i] != 0) && (goal_lines[tiles[i]] == line)){
+			places[num_places] = goal_places[tiles[i]];
+			num_places++;
+		}
+	}
+	for (i = 0; i < num_places; i++){
+		longest[i] = 1;
+		for (j = 0; j < i; j++){
+			if ((places[j] < places[i]) && (longest[j] + 1 > longest[i])){
+				longest[i] = longest[j] + 1;
+			}
+		}
+		if (longest[i] > longest_run){
+			longest_run = longest[i];
+		}
+	}
+	return 2 * (num_places - longest_run);
+}
+
+/*
+ * Function:  walking_distance_key 
+ * --------------------
+ * Encode a board for the walking distance: for every line and every goal line, how many tiles 
+ * on that line belong to that goal line (3 bits each), plus the line of 'x' on top
+ *    
+ *  tiles: The board, tiles[row*N + col]
+ *  goal_lines: Goal row (or column) of each tile
+ *  N: width and height of the board 
+ *  is_row: 1 to count along rows, 0 along columns
+ * 
+ *  returns: the key
+ */
+uint64_t walking_distance_key(const int *tiles, const int *goal_lines, int N, int is_row){
+	uint64_t key = 0;
+	int i, line;
+	for (i = 0; i < N*N; i++){
+		line = is_row ? (i / N) : (i % N);
+		if (tiles[i] == 0){
+			key |= (uint64_t) line << (3 * MAX_WALKING_DISTANCE_N * MAX_WALKING_DISTANCE_N);
+		} else {
+			key += (uint64_t) 1 << (3 * (line * N + goal_lines[tiles[i]]));
+		}
+	}
+	return key;
+}
+
+/*
+ * Function:  find_walking_distance 
+ * --------------------
+ * Look up the index of a walking distance key
+ *    
+ *  wd: The walking distance tables
+ *  key: The key
+ * 
+ *  returns: the index, or -1 if the key is not in the tables
+ */
+int find_walking_distance(const WalkingDistance *wd, uint64_t key){
+	unsigned long slot = (unsigned long) ((key * (uint64_t) 0x9E3779B97F4A7C15UL) >> 48);
+	while (wd->table[slot] != -1){
+		if (wd->keys[wd->table[slot]] == key){
+			return wd->table[slot];
+		}
+		slot = (slot + 1) & (WALKING_DISTANCE_TABLE_SIZE - 1);
+	}
+	return -1;
+}
+
+/*
+ * Function:  add_walking_distance 
+ * --------------------
+ * Append a new key to the walking distance tables
+ *    
+ *  wd: The walking distance tables
+ *  key: The key, not in the tables yet
+ *  distance: Number of moves from the goal key
+ * 
+ *  returns: the index of the key, or -1 if there is not enough memory
+ */
+int add_walking_distance(WalkingDistance *wd, uint64_t key, int distance){
+	unsigned long slot;
+	int capacity;
+	void *grown;
+	if (2 * (wd->num_states + 1) > (int) WALKING_DISTANCE_TABLE_SIZE){
+		return -1;
+	}
+	if (wd->num_states == wd->capacity){
+		capacity = (wd->capacity == 0) ? 1024 : 2 * wd->capacity;
+		grown = realloc(wd->keys, sizeof(uint64_t) * capacity);
+		if (grown == NULL){
+			return -1;
+		}
+		wd->keys = (uint64_t *) grown;
+		grown = realloc(wd->distance, sizeof(unsigned char) * capacity);
+		if (grown == NULL){
+			return -1;
+		}
+		wd->distance = (unsigned char *) grown;
+		grown = realloc(wd->next, sizeof(int) * capacity * 2 * wd->N);
+		if (grown == NULL){
+			return -1;
+		}
+		wd->next = (int *) grown;
+		wd->capacity = capacity;
+	}
+	wd->keys[wd->num_states] = key;
+	wd->distance[wd->num_states] = (unsigned char) distance;
+	slot = (unsigned long) ((key * (uint64_t) 0x9E3779B97F4A7C15UL) >> 48);
+	while (wd->table[slot] != -1){
+		slot = (slot + 1) & (WALKING_DISTANCE_TABLE_SIZE - 1);
+	}
+	wd->table[slot] = wd->num_states;
+	wd->num_states++;
+	return wd->num_states - 1;
+}
+
+/*
+ * Function:  build_walking_distance 
+ * --------------------
+ * Breadth-first search over walking distance keys from the goal key. A move takes one tile 
+ * from the line next to 'x' into the line of 'x', so only the counts matter, not the order 
+ * of the tiles within a line
+ *    
+ *  wd: The walking distance tables (output)
+ *  goal_key: walking_distance_key() of the goal
+ *  N: width and height of the board (at most MAX_WALKING_DISTANCE_N)
+ * 
+ *  returns: 0, or -1 if there is not enough memory
+ */
+int build_walking_distance(WalkingDistance *wd, uint64_t goal_key, int N){
+	int index, direction, group, next_index, blank_line, next_line;
+	int blank_shift = 3 * MAX_WALKING_DISTANCE_N * MAX_WALKING_DISTANCE_N;
+	unsigned long i;
+	uint64_t key, next_key;
+	
+	wd->N = N;
+	wd->num_states = 0;
+	wd->capacity = 0;
+	wd->keys = NULL;
+	wd->distance = NULL;
+	wd->next = NULL;
+	wd->table = (int *) malloc(sizeof(int) * WALKING_DISTANCE_TABLE_SIZE);
+	if (wd->table == NULL){
+		return -1;
+	}
+	for (i = 0; i < WALKING_DISTANCE_TABLE_SIZE; i++){
+		wd->table[i] = -1;
+	}
+	if (add_walking_distance(wd, goal_key, 0) == -1){
+		return -1;
+	}
+	
+	/* The tables double as the queue: keys are appended in order of distance */
+	for (index = 0; index < wd->num_states; index++){
+		key = wd->keys[index];
+		blank_line = (int) (key >> blank_shift);
+		for (direction = 0; direction < 2; direction++){
+			next_line = (direction == 0) ? blank_line - 1 : blank_line + 1;
+			for (group = 0; group < N; group++){
+				if ((next_line < 0) || (next_line >= N) || (((key >> (3 * (next_line * N + group))) & 7) == 0)){
+					wd->next[(index*2 + direction)*N + group] = -1;
+					continue;
+				}
+				next_key = key - ((uint64_t) 1 << (3 * (next_line * N + group))) 
+					+ ((uint64_t) 1 << (3 * (blank_line * N + group)));
+				next_key = (next_key & (((uint64_t) 1 << blank_shift) - 1)) | ((uint64_t) next_line << blank_shift);
+				next_index = find_walking_distance(wd, next_key);
+				if (next_index == -1){
+					next_index = add_walking_distance(wd, next_key, wd->distance[index] + 1);
+					if (next_index == -1){
+						return -1;
+					}
+				}
+				wd->next[(index*2 + direction)*N + group] = next_index;
+			}
+		}
+	}
+	return 0;
+}
+
+/*
+ * Function:  free_walking_distance 
+ * --------------------
+ * Free the walking distance tables
+ *    
+ *  wd: The walking distance tables
+ * 
+ *  returns: 0
+ */
+int free_walking_distance(WalkingDistance *wd){
+	free(wd->keys);
+	free(wd->distance);
+	free(wd->next);
+	free(wd->table);
+	wd->keys = NULL;
+	wd->distance = NULL;
+	wd->next = NULL;
+	wd->table = NULL;
+	wd->num_states = 0;
+	return 0;
+}
+
+/*
+ * Function:  new_heuristic 
+ * --------------------
+ * Set up a heuristic, building its tables if it has any
+ *    
+ *  heuristic: The heuristic (output)
+ *  kind: HEURISTIC_MANHATTAN, HEURISTIC_LINEAR_CONFLICT or HEURISTIC_WALKING_DISTANCE
+ *  goal_rows: Row position for each of the value in the goal (goal_rows[value] = position)
+ *  goal_cols: Column position for each of the value in the goal (goal_cols[value] = position)
+ *  N: width and height of the board 
+ * 
+ *  returns: 0, or -1 if the heuristic is not available for this board
+ */
+int new_heuristic(Heuristic *heuristic, int kind, const int *goal_rows, const int *goal_cols, int N){
+	int goal_tiles[MAX_WALKING_DISTANCE_N * MAX_WALKING_DISTANCE_N];
+	int i;
+	heuristic->kind = kind;
+	heuristic->N = N;
+	heuristic->goal_rows = goal_rows;
+	heuristic->goal_cols = goal_cols;
+	heuristic->rows.table = NULL;
+	heuristic->cols.table = NULL;
+	if ((kind == HEURISTIC_LINEAR_CONFLICT) && (N > MAX_LINE_LENGTH)){
+		return -1;
+	}
+	if (kind != HEURISTIC_WALKING_DISTANCE){
+		return 0;
+	}
+	if (N > MAX_WALKING_DISTANCE_N){
+		return -1;
+	}
+	for (i = 0; i < N*N; i++){
+		goal_tiles[goal_rows[i] * N + goal_cols[i]] = i;
+	}
+	if ((build_walking_distance(&heuristic->rows, walking_distance_key(goal_tiles, goal_rows, N, 1), N) != 0)
+		|| (build_walking_distance(&heuristic->cols, walking_distance_key(goal_tiles, goal_cols, N, 0), N) != 0)){
+		free_heuristic(heuristic);
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Function:  free_heuristic 
+ * --------------------
+ * Free the tables of a heuristic
+ *    
+ *  heuristic: The heuristic
+ * 
+ *  returns: 0
+ */
+int free_heuristic(Heuristic *heuristic){
+	if (heuristic->rows.table != NULL){
+		free_walking_distance(&heuristic->rows);
+	}
+	if (heuristic->cols.table != NULL){
+		free_walking_distance(&heuristic->cols);
+	}
+	return 0;
+}
+
+/*
+ * Function:  heuristic_value 
+ * --------------------
+ * Evaluate the heuristic on a whole board. The search then keeps it up to date move by move
+ *    
+ *  heuristic: The heuristic
+ *  tiles: The board, tiles[row*N + col]
+ *  wd_rows: Walking distance index along the rows (output, only for HEURISTIC_WALKING_DISTANCE)
+ *  wd_cols: Walking distance index along the columns (output, only for HEURISTIC_WALKING_DISTANCE)
+ * 
+ *  returns: the heuristic estimate
+ */
+int heuristic_value(const Heuristic *heuristic, const int *tiles, int *wd_rows, int *wd_cols){
+	int N = heuristic->N;
+	int line[MAX_LINE_LENGTH];
+	int i, j, h_score = 0;
+	*wd_rows = 0;
+	*wd_cols = 0;
+	if (heuristic->kind == HEURISTIC_WALKING_DISTANCE){
+		*wd_rows = find_walking_distance(&heuristic->rows, walking_distance_key(tiles, heuristic->goal_rows, N, 1));
+		*wd_cols = find_walking_distance(&heuristic->cols, walking_distance_key(tiles, heuristic->goal_cols, N, 0));
+		return heuristic->rows.distance[*wd_rows] + heuristic->cols.distance[*wd_cols];
+	}
+	for (i = 0; i < N*N; i++){
+		if (tiles[i] != 0){
+			/* Do not care about 'x' */
+			h_score += abs(i / N - heuristic->goal_rows[tiles[i]]) + abs(i % N - heuristic->goal_cols[tiles[i]]);
+		}
+	}
+	if (heuristic->kind == HEURISTIC_LINEAR_CONFLICT){
+		for (i = 0; i < N; i++){
+			h_score += line_conflicts(heuristic, &tiles[i*N], i, 1);
+			for (j = 0; j < N; j++){
+				line[j] = tiles[j*N + i];
+			}
+			h_score += line_conflicts(heuristic, line, i, 0);
+		}
+	}
+	return h_score;
+}
+
+/*
+ * Function:  h_score 
+ * --------------------
+ * Calculate the h_score (heuristic estimate) of the board of a state from scratch. 
+ * Only the start state needs this, the children are updated move by move
+ *    
+ *  pool: The state pool
+ *  state: Index of the state
+ *  heuristic: The heuristic
+ *  wd_rows: Walking distance index along the rows (output, only for HEURISTIC_WALKING_DISTANCE)
+ *  wd_cols: Walking distance index along the columns (output, only for HEURISTIC_WALKING_DISTANCE)
+ * 
+ *  returns: the heuristic estimate
+ */
+int h_score(const StatePool *pool, int state, const Heuristic *heuristic, int *wd_rows, int *wd_cols){
+	int tiles[MAX_LINE_LENGTH * MAX_LINE_LENGTH] = {0}; /* Only N*N entries are used, but the optimizer cannot tell */
+	int i;
+	for (i = 0; i < pool->code_length; i++){
+		if (pool->N <= MAX_PACKED_N){
+			tiles[i] = (int) ((pool->packed[state] >> (4 * i)) & 0xF);
+		} else {
+			tiles[i] = pool->codes[state * pool->code_length + i];
+		}
+	}
+	return heuristic_value(heuristic, (const int *) tiles, wd_rows, wd_cols);
+}
+
+/*
+ * Function:  state_line 
+ * --------------------
+ * Read one row or column of the board of a state
+ *    
+ *  pool: The state pool
+ *  state: Index of the state
+ *  line: Index of the row or column
+ *  is_row: 1 for a row, 0 for a column
+ *  tiles: The array of size N receiving the tiles (output)
+ * 
+ *  returns: 0
+ */
+int state_line(const StatePool *pool, int state, int line, int is_row, int *tiles){
+	int i, position, N = pool->N;
+	for (i = 0; i < N; i++){
+		position = is_row ? line*N + i : i*N + line;
+		if (N <= MAX_PACKED_N){
+			tiles[i] = (int) ((pool->packed[state] >> (4 * position)) & 0xF);
+		} else {
+			tiles[i] = pool->codes[state * pool->code_length + position];
+		}
+	}
+	return 0;
+}
+
+/*
+ * Function:  conflicts_change 
+ * --------------------
+ * Change in linear conflicts after a move. A vertical move takes a tile from one row to another 
+ * and a horizontal move from one column to another, so only those two lines need to be looked at
+ *    
+ *  heuristic: The heuristic
+ *  pool: The state pool
+ *  state: Index of the state before the move
+ *  child: Index of the slot holding the board after the move
+ *  is_row: 1 if the tile moved between rows, 0 if between columns
+ *  line_1, line_2: The two rows or columns
+ * 
+ *  returns: the conflicts on both lines after the move minus the conflicts before
+ */
+int conflicts_change(const Heuristic *heuristic, const StatePool *pool, int state, int child, int is_row, 
+	int line_1, int line_2){
+	int line[MAX_LINE_LENGTH] = {0}; /* Only N entries are used, but the optimizer cannot tell */
+	int change = 0;
+	state_line(pool, state, line_1, is_row, line);
+	change -= line_conflicts(heuristic, line, line_1, is_row);
+	state_line(pool, state, line_2, is_row, line);
+	change -= line_conflicts(heuristic, line, line_2, is_row);
+	state_line(pool, child, line_1, is_row, line);
+	change += line_conflicts(heuristic, line, line_1, is_row);
+	state_line(pool, child, line_2, is_row, line);
+	change += line_conflicts(heuristic, line, line_2, is_row);
+	return change;
+}
+
+/*
+ * Function:  child_h_score 
+ * --------------------
+ * The h_score of a child, from the h_score of its parent and the one tile that moved
+ *    
+ *  heuristic: The heuristic
+ *  pool: The state pool
+ *  state: Index of the parent
+ *  h: The h_score of the parent
+ *  child: Index of the slot holding the board of the child
+ *  move: The move made (index into MOVE_CHARS)
+ *  tile: The tile that moved
+ *  blank, new_blank: Position of 'x' before and after the move
+ *  wd_rows, wd_cols: Walking distance indices of the parent on entry, of the child on return
+ * 
+ *  returns: the h_score of the child
+ */
+int child_h_score(const Heuristic *heuristic, const StatePool *pool, int state, int h, int child, int move, 
+	int tile, int blank, int new_blank, int *wd_rows, int *wd_cols){
+	int N = pool->N;
+	if (heuristic->kind == HEURISTIC_WALKING_DISTANCE){
+		/* The moved tile leaves its row (or column) for the one 'x' was on */
+		if (move < 2){
+			*wd_rows = heuristic->rows.next[(*wd_rows*2 + move)*N + heuristic->goal_rows[tile]];
+		} else {
+			*wd_cols = heuristic->cols.next[(*wd_cols*2 + move - 2)*N + heuristic->goal_cols[tile]];
+		}
+		return heuristic->rows.distance[*wd_rows] + heuristic->cols.distance[*wd_cols];
+	}
+	if (move < 2){
+		h += abs(blank / N - heuristic->goal_rows[tile]) - abs(new_blank / N - heuristic->goal_rows[tile]);
+		if (heuristic->kind == HEURISTIC_LINEAR_CONFLICT){
+			h += conflicts_change(heuristic, pool, state, child, 1, blank / N, new_blank / N);
+		}
+	} else {
+		h += abs(blank % N - heuristic->goal_cols[tile]) - abs(new_blank % N - heuristic->goal_cols[tile]);
+		if (heuristic->kind == HEURISTIC_LINEAR_CONFLICT){
+			h += conflicts_change(heuristic, pool, state, child, 0, blank % N, new_blank % N);
+		}
+	}
+	return h;
+}
+
+/*
+ * Function:  hash_state 
+ * --------------------
+ * Hash the board of a state. Packed boards need a single multiplication
+ *    
+ *  pool: The state pool
+ *  state: Index of the state
+ * 
+ *  returns: the hash
+ */
+unsigned int hash_state(const StatePool *pool, int state){
+	if (pool->N <= MAX_PACKED_N){
+		return (unsigned int) ((pool->packed[state] * (uint64_t) 0x9E3779B97F4A7C15UL) >> 32);
+	}
+	return hash_code(&pool->codes[state * pool->code_length], pool->code_length);
+}
+
+/*
+ * Function:  same_board 
+ * --------------------
+ * Check if two states have the same board
+ *    
+ *  pool: The state pool
+ *  state_1: Index of the first state
+ *  state_2: Index of the second state
+ * 
+ *  returns: 1 if it is true else 0
+ */
+int same_board(const StatePool *pool, int state_1, int state_2){
+	if (pool->N <= MAX_PACKED_N){
+		return pool->packed[state_1] == pool->packed[state_2];
+	}
+	return memcmp(&pool->codes[state_1 * pool->code_length], 
+		&pool->codes[state_2 * pool->code_length], pool->code_length) == 0;
+}
+
+/*
+ * Function:  copy_board 
+ * --------------------
+ * Copy the board of a state into a slot of another state pool for the same N, 
+ * so that it can be looked up in the closed set of that pool
+ *    
+ *  pool: The state pool receiving the board
+ *  state: Index of the slot receiving the board (usually the reserved one)
+ *  from: The state pool holding the board
+ *  from_state: Index of the state in it
+ * 
+ *  returns: 0
+ */
+int copy_board(StatePool *pool, int state, const StatePool *from, int from_state){
+	if (pool->N <= MAX_PACKED_N){
+		pool->packed[state] = from->packed[from_state];
+	} else {
+		memcpy(&pool->codes[state * pool->code_length], &from->codes[from_state * from->code_length], 
+			pool->code_length);
+	}
+	return 0;
+}
+
+/*
+ * Function:  is_goal 
+ * --------------------
+ * Check if the board of a state is the goal state or not
+ *    
+ *  pool: The state pool
+ *  state: Index of the state
+ * 
+ *  returns: 1 if it is true else 0
+ */
+int is_goal(const StatePool *pool, int state){
+	if (pool->N <= MAX_PACKED_N){
+		return pool->packed[state] == pool->goal_packed;
+	}
+	return memcmp(&pool->codes[state * pool->code_length], pool->goal_code, pool->code_length) == 0;
+}
+
+/*
+ * Function:  new_heap 
+ * --------------------
+ * Initialize an empty heap. Memory is allocated on the first insertion
+ *    
+ *  heap: The heap
+ * 
+ *  returns: 0
+ */
+int new_heap(Heap *heap){
+	heap->entries = NULL;
+	heap->size = 0;
+	heap->capacity = 0;
+	return 0;
+}
+
+/*
+ * Function:  free_heap 
+ * --------------------
+ * Free the heap. The states it refers to are owned by the state pool, not by the heap
+ *    
+ *  heap: The heap
+ * 
+ *  returns: 0
+ */
+int free_heap(Heap *heap){
+	free(heap->entries);
+	return new_heap(heap);
+}
+
+/*
+ * Function:  insert_to_heap 
+ * --------------------
+ * insert an element to heap (note that the heap starts from the 1st index, not 0)
+ * Ties on the f-score are broken towards the larger g-score, i.e. the deeper state,
+ * which tends to reach the goal with fewer expansions
+ *    
+ *  heap: The heap
+ *  state: Index of the state in the state pool
+ *  score: The f-score 
+ *  g_score: The number of moves made to arrive at the current board position
+ * 
+ *  returns: 0, or -1 if the heap could not grow
+ */
+int insert_to_heap(Heap *heap, int state, int score, int g_score){
+	HeapEntry *entries;
+	HeapEntry entry;
+	int capacity, child_idx, parent_idx;
+	
+	if ((score > MAX_G_SCORE) || (g_score > MAX_G_SCORE)){
+		return -1;
+	}
+	if (heap->size + 1 >= heap->capacity){
+		capacity = (heap->capacity == 0) ? INITIAL_HEAP_CAPACITY : 2 * heap->capacity;
+		entries = (HeapEntry *) realloc(heap->entries, sizeof(HeapEntry) * capacity);
+		if (entries == NULL){
+			return -1;
+		}
+		heap->entries = entries;
+		heap->capacity = capacity;
+	}
+	entry.key = ((unsigned int) score << 16) | (unsigned int) (MAX_G_SCORE - g_score);
+	entry.state = state;
+	
+	/* Add the element to the bottom level of the heap, then move the hole up 
+	   while the parent is larger instead of swapping at every level */
+	heap->size++;
+	child_idx = heap->size;
+	parent_idx = child_idx / 2;
+	while ((parent_idx != 0) && (heap->entries[parent_idx].key > entry.key)){
+		heap->entries[child_idx] = heap->entries[parent_idx];
+		child_idx = parent_idx;
+		parent_idx /= 2;
+	}
+	heap->entries[child_idx] = entry;
+	return 0;	
+}
+
+/*
+ * Function:  extract_from_heap 
+ * --------------------
+ * Extract the element with the lowest key from the heap (note that the heap starts from the 1st index, not 0)
+ *    
+ *  heap: The heap
+ *  state: Index of the extracted state in the state pool (output)
+ * 
+ *  returns: 0, or -1 if the heap is empty
+ */
+int extract_from_heap(Heap *heap, int *state){
+	HeapEntry last;
+	int child_idx, parent_idx;
+	if (heap->size == 0){
+		return -1;
+	}
+	/* Extract from root */	
+	*state = heap->entries[1].state;
+	
+	/* Replace the root of the heap with the last element on the last level, 
+	   then move it down towards its smaller child */
+	last = heap->entries[heap->size];
+	heap->size--;
+	parent_idx = 1;
+	child_idx = 2;
+	while (child_idx <= heap->size){
+		if ((child_idx < heap->size) && (heap->entries[child_idx + 1].key < heap->entries[child_idx].key)){
+			child_idx++;
+		}
+		if (last.key <= heap->entries[child_idx].key){
+			break;
+		}
+		heap->entries[parent_idx] = heap->entries[child_idx];
+		parent_idx = child_idx;
+		child_idx = 2 * parent_idx;
+	}
+	heap->entries[parent_idx] = last;
+	return 0;
+}
+
+/*
+ * Function:  new_bucket_queue 
+ * --------------------
+ * Initialize an empty bucket queue. Buckets are allocated when a state with a new f-score arrives
+ *    
+ *  queue: The bucket queue
+ * 
+ *  returns: 0
+ */
+int new_bucket_queue(BucketQueue *queue){
+	queue->buckets = NULL;
+	queue->level_sizes = NULL;
+	queue->top_g = NULL;
+	queue->num_levels = 0;
+	queue->min_f = 0;
+	queue->size = 0;
+	return 0;
+}
+
+/*
+ * Function:  free_bucket_queue 
+ * --------------------
+ * Free the bucket queue. The states it refers to are owned by the state pool
+ *    
+ *  queue: The bucket queue
+ * 
+ *  returns: 0
+ */
+int free_bucket_queue(BucketQueue *queue){
+	int i;
+	for (i = 0; i < queue->num_levels * (queue->num_levels + 1) / 2; i++){
+		free(queue->buckets[i].states);
+	}
+	free(queue->buckets);
+	free(queue->level_sizes);
+	free(queue->top_g);
+	return new_bucket_queue(queue);
+}
+
+/*
+ * Function:  insert_to_buckets 
+ * --------------------
+ * Push a state onto the bucket for its (f, g) pair in O(1)
+ *    
+ *  queue: The bucket queue
+ *  state: Index of the state in the state pool
+ *  score: The f-score 
+ *  g_score: The number of moves made to arrive at the current board position
+ * 
+ *  returns: 0, or -1 if the queue could not grow
+ */
+int insert_to_buckets(BucketQueue *queue, int state, int score, int g_score){
+	Bucket *buckets, *bucket;
+	int *level_sizes, *top_g;
+	int num_levels, capacity, i;
+	int *states;
+	
+	if ((g_score < 0) || (g_score > score)){
+		/* Only possible with a negative heuristic */
+		return -1;
+	}
+	if (score >= queue->num_levels){
+		/* Add levels up to the new f-score. The triangular layout keeps the old buckets where they are */
+		num_levels = 2 * queue->num_levels;
+		if (num_levels <= score){
+			num_levels = score + 1;
+		}
+		buckets = (Bucket *) realloc(queue->buckets, sizeof(Bucket) * (num_levels * (num_levels + 1) / 2));
+		if (buckets == NULL){
+			return -1;
+		}
+		queue->buckets = buckets;
+		level_sizes = (int *) realloc(queue->level_sizes, sizeof(int) * num_levels);
+		if (level_sizes == NULL){
+			return -1;
+		}
+		queue->level_sizes = level_sizes;
+		top_g = (int *) realloc(queue->top_g, sizeof(int) * num_levels);
+		if (top_g == NULL){
+			return -1;
+		}
+		queue->top_g = top_g;
+		for (i = queue->num_levels * (queue->num_levels + 1) / 2; i < num_levels * (num_levels + 1) / 2; i++){
+			buckets[i].states = NULL;
+			buckets[i].size = 0;
+			buckets[i].capacity = 0;
+		}
+		for (i = queue->num_levels; i < num_levels; i++){
+			level_sizes[i] = 0;
+			top_g[i] = 0;
+		}
+		queue->num_levels = num_levels;
+	}
+	
+	bucket = &queue->buckets[score * (score + 1) / 2 + g_score];
+	if (bucket->size == bucket->capacity){
+		capacity = (bucket->capacity == 0) ? INITIAL_BUCKET_CAPACITY : 2 * bucket->capacity;
+		states = (int *) realloc(bucket->states, sizeof(int) * capacity);
+		if (states == NULL){
+			return -1;
+		}
+		bucket->states = states;
+		bucket->capacity = capacity;
+	}
+	bucket->states[bucket->size] = state;
+	bucket->size++;
+	
+	queue->level_sizes[score]++;
+	if (g_score > queue->top_g[score]){
+		queue->top_g[score] = g_score;
+	}
+	if ((queue->size == 0) || (score < queue->min_f)){
+		queue->min_f = score;
+	}
+	queue->size++;
+	return 0;
+}
+
+/*
+ * Function:  extract_from_buckets 
+ * --------------------
+ * Pop the most recently inserted state among those with the lowest f-score and, 
+ * for that f-score, the largest g-score. Both cursors only move monotonically 
+ * between insertions so the cost is amortized O(1)
+ *    
+ *  queue: The bucket queue
+ *  state: Index of the extracted state in the state pool (output)
+ * 
+ *  returns: 0, or -1 if the queue is empty
+ */
+int extract_from_buckets(BucketQueue *queue, int *state){
+	Bucket *level, *bucket;
+	int f;
+	if (queue->size == 0){
+		return -1;
+	}
+	f = queue->min_f;
+	while (queue->level_sizes[f] == 0){
+		f++;
+	}
+	queue->min_f = f;
+	level = &queue->buckets[f * (f + 1) / 2];
+	while (level[queue->top_g[f]].size == 0){
+		queue->top_g[f]--;
+	}
+	bucket = &level[queue->top_g[f]];
+	bucket->size--;
+	*state = bucket->states[bucket->size];
+	queue->level_sizes[f]--;
+	queue->size--;
+	return 0;
+}
+
+/*
+ * Function:  new_closed_set 
+ * --------------------
+ * Initialize an empty closed set. Despite the name it holds every state generated so far, 
+ * open or closed, so that duplicates are caught as soon as they are generated
+ *    
+ *  closed: The closed set
+ *  capacity: Initial number of slots (a power of two). The set doubles whenever it is half full
+ * 
+ *  returns: 0, or -1 if the slots could not be allocated
+ */
+int new_closed_set(ClosedSet *closed, unsigned long capacity){
+	unsigned long i;
+	closed->entries = (ClosedSetEntry *) malloc(sizeof(ClosedSetEntry) * capacity);
+	closed->capacity = capacity;
+	closed->size = 0;
+	if (closed->entries == NULL){
+		closed->capacity = 0;
+		return -1;
+	}
+	for (i = 0; i < capacity; i++){
+		closed->entries[i].state = -1;
+	}
+	return 0;
+}
+
+/*
+ * Function:  free_closed_set 
+ * --------------------
+ * Free the closed set. The states it refers to are owned by the state pool
+ *    
+ *  closed: The closed set
+ * 
+ *  returns: 0
+ */
+int free_closed_set(ClosedSet *closed){
+	free(closed->entries);
+	closed->entries = NULL;
+	closed->capacity = 0;
+	closed->size = 0;
+	return 0;
+}
+
+/*
+ * Function:  find_in_closed_set 
+ * --------------------
+ * Look up a board by its code
+ *    
+ *  closed: The closed set
+ *  pool: The state pool holding the boards
+ *  state: Index of a state (possibly the reserved slot) holding the board to look for
+ *  hash: hash_state() of that state
+ * 
+ *  returns: the index of the stored state with the same board, or -1 if there is none
+ */
+int find_in_closed_set(const ClosedSet *closed, const StatePool *pool, int state, unsigned int hash){
+	unsigned long mask = closed->capacity - 1;
+	unsigned long slot = hash & mask;
+	int stored;
+	while ((stored = closed->entries[slot].state) != -1){
+		if ((closed->entries[slot].hash == hash) && same_board(pool, stored, state)){
+			return stored;
+		}
+		slot = (slot + 1) & mask;
+	}
+	return -1;
+}
+
+/*
+ * Function:  add_to_closed_set 
+ * --------------------
+ * Add a state that is known not to be in the closed set yet
+ *    
+ *  closed: The closed set
+ *  state: Index of the state in the state pool
+ *  hash: hash_state() of the state
+ * 
+ *  returns: 0, or -1 if the closed set could not grow
+ */
+int add_to_closed_set(ClosedSet *closed, int state, unsigned int hash){
+	ClosedSetEntry *entries, *old_entries;
+	unsigned long capacity, old_capacity, mask, slot, i;
+	if (2 * (closed->size + 1) > closed->capacity){
+		/* Rehash into a table twice as large, reusing the stored hashes */
+		old_entries = closed->entries;
+		old_capacity = closed->capacity;
+		capacity = 2 * old_capacity;
+		entries = (ClosedSetEntry *) malloc(sizeof(ClosedSetEntry) * capacity);
+		if (entries == NULL){
+			return -1;
+		}
+		for (i = 0; i < capacity; i++){
+			entries[i].state = -1;
+		}
+		mask = capacity - 1;
+		for (i = 0; i < old_capacity; i++){
+			if (old_entries[i].state == -1){
+				continue;
+			}
+			slot = old_entries[i].hash & mask;
+			while (entries[slot].state != -1){
+				slot = (slot + 1) & mask;
+			}
+			entries[slot] = old_entries[i];
+		}
+		free(old_entries);
+		closed->entries = entries;
+		closed->capacity = capacity;
+	}
+	mask = closed->capacity - 1;
+	slot = hash & mask;
+	while (closed->entries[slot].state != -1){
+		slot = (slot + 1) & mask;
+	}
+	closed->entries[slot].hash = hash;
+	closed->entries[slot].state = state;
+	closed->size++;
+	return 0;
+}
+
+/*
+ * Function:  remove_from_closed_set 
+ * --------------------
+ * Take a state out of the closed set. The entries after it in the same run of slots that would 
+ * not be found any more with the hole there are moved back into it (backward shift deletion)
+ *    
+ *  closed: The closed set
+ *  state: Index of the state in the state pool
+ *  hash: hash_state() of the state
+ * 
+ *  returns: 0, or -1 if the state is not in the closed set
+ */
+int remove_from_closed_set(ClosedSet *closed, int state, unsigned int hash){
+	unsigned long mask = closed->capacity - 1;
+	unsigned long slot = hash & mask;
+	unsigned long next, home;
+	while (closed->entries[slot].state != state){
+		if (closed->entries[slot].state == -1){
+			return -1;
+		}
+		slot = (slot + 1) & mask;
+	}
+	next = slot;
+	while (1){
+		next = (next + 1) & mask;
+		if (closed->entries[next].state == -1){
+			break;
+		}
+		home = closed->entries[next].hash & mask;
+		if (((next - home) & mask) >= ((next - slot) & mask)){
+			/* The hole lies between the slot of this entry and where it is now */
+			closed->entries[slot] = closed->entries[next];
+			slot = next;
+		}
+	}
+	closed->entries[slot].state = -1;
+	closed->size--;
+	return 0;
+}
+
+/*
+ * Function:  new_open_list 
+ * --------------------
+ * Initialize an empty open list
+ *    
+ *  open: The open list
+ *  kind: OPEN_LIST_HEAP for a binary heap or OPEN_LIST_BUCKETS for a bucket queue
+ * 
+ *  returns: 0
+ */
+int new_open_list(OpenList *open, int kind){
+	open->kind = kind;
+#ifdef NPUZZLE_STATS
+	open->num_pushes = 0;
+	open->num_pops = 0;
+	open->size = 0;
+	open->max_size = 0;
+#endif
+	new_heap(&open->heap);
+	new_bucket_queue(&open->buckets);
+	return 0;
+}
+
+/*
+ * Function:  free_open_list 
+ * --------------------
+ * Free the open list
+ *    
+ *  open: The open list
+ * 
+ *  returns: 0
+ */
+int free_open_list(OpenList *open){
+	free_heap(&open->heap);
+	free_bucket_queue(&open->buckets);
+	return 0;
+}
+
+/*
+ * Function:  insert_to_open_list 
+ * --------------------
+ * Insert a state into whichever structure backs the open list
+ *    
+ *  open: The open list
+ *  state: Index of the state in the state pool
+ *  score: The f-score 
+ *  g_score: The number of moves made to arrive at the current board position
+ * 
+ *  returns: 0, or -1 if the open list could not grow
+ */
+int insert_to_open_list(OpenList *open, int state, int score, int g_score){
+#ifdef NPUZZLE_STATS
+	open->num_pushes++;
+	open->size++;
+	if (open->size > open->max_size){
+		open->max_size = open->size;
+	}
+#endif
+	if (open->kind == OPEN_LIST_BUCKETS){
+		return insert_to_buckets(&open->buckets, state, score, g_score);
+	}
+	return insert_to_heap(&open->heap, state, score, g_score);
+}
+
+/*
+ * Function:  extract_from_open_list 
+ * --------------------
+ * Extract the state with the lowest f-score (largest g-score on ties) from the open list
+ *    
+ *  open: The open list
+ *  state: Index of the extracted state in the state pool (output)
+ * 
+ *  returns: 0, or -1 if the open list is empty
+ */
+int extract_from_open_list(OpenList *open, int *state){
+#ifdef NPUZZLE_STATS
+	if (open->size > 0){
+		open->num_pops++;
+		open->size--;
+	}
+#endif
+	if (open->kind == OPEN_LIST_BUCKETS){
+		return extract_from_buckets(&open->buckets, state);
+	}
+	return extract_from_heap(&open->heap, state);
+}
+
+/*
+ * Function:  min_score_in_open_list 
+ * --------------------
+ * The lowest score in the open list, without extracting anything. Outdated entries count too
+ *    
+ *  open: The open list
+ * 
+ *  returns: the score, or -1 if the open list is empty
+ */
+int min_score_in_open_list(OpenList *open){
+	BucketQueue *queue = &open->buckets;
+	if (open->kind == OPEN_LIST_BUCKETS){
+		if (queue->size == 0){
+			return -1;
+		}
+		while (queue->level_sizes[queue->min_f] == 0){
+			queue->min_f++;
+		}
+		return queue->min_f;
+	}
+	if (open->heap.size == 0){
+		return -1;
+	}
+	return (int) (open->heap.entries[1].key >> 16);
+}
+
+/*
+ * Function:  new_indexed_heap 
+ * --------------------
+ * Initialize an empty indexed heap for states 0 to capacity-1. Unlike Heap, it holds each state 
+ * at most once, and knows where, so that the key of a state can be changed and a state can be 
+ * taken out from anywhere. All the memory is allocated here
+ *    
+ *  heap: The indexed heap
+ *  capacity: Number of states
+ * 
+ *  returns: 0, or -1 if out of memory
+ */
+int new_indexed_heap(IndexedHeap *heap, int capacity){
+	heap->entries = (HeapEntry *) malloc(sizeof(HeapEntry) * (capacity + 1));
+	heap->positions = (int *) calloc(capacity, sizeof(int));
+	heap->size = 0;
+	if ((heap->entries == NULL) || (heap->positions == NULL)){
+		free_indexed_heap(heap);
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Function:  free_indexed_heap 
+ * --------------------
+ * Free an indexed heap
+ *    
+ *  heap: The indexed heap
+ * 
+ *  returns: 0
+ */
+int free_indexed_heap(IndexedHeap *heap){
+	free(heap->entries);
+	free(heap->positions);
+	heap->entries = NULL;
+	heap->positions = NULL;
+	heap->size = 0;
+	return 0;
+}
+
+/*
+ * Function:  sift_indexed_heap 
+ * --------------------
+ * Put an entry in the hole at some index of an indexed heap, moving the hole up while the 
+ * parent is larger, or else down towards the smaller child, as in insert_to_heap and extract_from_heap
+ *    
+ *  heap: The indexed heap
+ *  index: The hole, from 1 to heap->size
+ *  entry: The entry to put there
+ * 
+ *  returns: 0
+ */
+int sift_indexed_heap(IndexedHeap *heap, int index, HeapEntry entry){
+	int child_idx;
+	while ((index > 1) && (heap->entries[index / 2].key > entry.key)){
+		heap->entries[index] = heap->entries[index / 2];
+		heap->positions[heap->entries[index].state] = index;
+		index /= 2;
+	}
+	child_idx = 2 * index;
+	while (child_idx <= heap->size){
+		if ((child_idx < heap->size) && (heap->entries[child_idx + 1].key < heap->entries[child_idx].key)){
+			child_idx++;
+		}
+		if (entry.key <= heap->entries[child_idx].key){
+			break;
+		}
+		heap->entries[index] = heap->entries[child_idx];
+		heap->positions[heap->entries[index].state] = index;
+		index = child_idx;
+		child_idx = 2 * index;
+	}
+	heap->entries[index] = entry;
+	heap->positions[entry.state] = index;
+	return 0;
+}
+
+/*
+ * Function:  update_indexed_heap 
+ * --------------------
+ * Insert a state into an indexed heap, or change its key if it is there already
+ *    
+ *  heap: The indexed heap
+ *  state: Index of the state
+ *  key: Its key, the lowest comes out first
+ * 
+ *  returns: 0
+ */
+int update_indexed_heap(IndexedHeap *heap, int state, unsigned int key){
+	HeapEntry entry;
+	int index = heap->positions[state];
+	if (index == 0){
+		heap->size++;
+		index = heap->size;
+	}
+	entry.key = key;
+	entry.state = state;
+	return sift_indexed_heap(heap, index, entry);
+}
+
+/*
+ * Function:  remove_from_indexed_heap 
+ * --------------------
+ * Take a state out of an indexed heap, if it is there. The last entry fills its place
+ *    
+ *  heap: The indexed heap
+ *  state: Index of the state
+ * 
+ *  returns: 0
+ */
+int remove_from_indexed_heap(IndexedHeap *heap, int state){
+	HeapEntry last;
+	int index = heap->positions[state];
+	if (index == 0){
+		return 0;
+	}
+	heap->positions[state] = 0;
+	last = heap->entries[heap->size];
+	heap->size--;
+	if (index <= heap->size){
+		sift_indexed_heap(heap, index, last);
+	}
+	return 0;
+}
+
+/*
+ * Function:  owner_of 
+ * --------------------
+ * The worker a board belongs to, from the upper bits of its hash (the closed sets use 
+ * the lower bits)
+ *    
+ *  hash: Hash of the board (see hash_state)
+ *  num_threads: Number of workers
+ * 
+ *  returns: the worker
+ */
+int owner_of(unsigned int hash, int num_threads){
+	return (int) (((uint64_t) hash * (uint64_t) num_threads) >> 32);
+}
+
+/*
+ * Function:  flush_batch 
+ * --------------------
+ * Hand the batch being filled for a worker over to it. The batch is pushed onto the inbox 
+ * of the worker with a compare-and-swap, so any number of workers can send at once
+ *    
+ *  shared: The parallel search
+ *  worker: The sending worker
+ *  owner: The receiving worker
+ * 
+ *  returns: 0
+ */
+int flush_batch(ParallelSearch *shared, Worker *worker, int owner){
+	Batch *batch = worker->outgoing[owner];
+	Worker *target = &shared->workers[owner];
+	Batch *head;
+	if ((batch == NULL) || (batch->size == 0)){
+		return 0;
+	}
+	/* Counted before it is visible, so the search cannot look finished while it is in flight */
+	__sync_fetch_and_add(&shared->num_active, 1);
+	do {
+		head = target->inbox;
+		batch->next = head;
+	} while (!__sync_bool_compare_and_swap(&target->inbox, head, batch));
+	worker->outgoing[owner] = NULL;
+	return 0;
+}
+
+/*
+ * Function:  send_child 
+ * --------------------
+ * Queue a child for the worker it belongs to. It is sent when the batch is full
+ *    
+ *  shared: The parallel search
+ *  worker: The sending worker
+ *  owner: The receiving worker
+ *  message: The child
+ * 
+ *  returns: 0, or -1 if there is not enough memory
+ */
+int send_child(ParallelSearch *shared, Worker *worker, int owner, const Message *message){
+	Batch *batch = worker->outgoing[owner];
+	if (batch == NULL){
+		batch = (Batch *) malloc(sizeof(Batch));
+		if (batch == NULL){
+			return -1;
+		}
+		batch->size = 0;
+		worker->outgoing[owner] = batch;
+	}
+	batch->messages[batch->size] = *message;
+	batch->size++;
+	if (batch->size == MESSAGE_BATCH_SIZE){
+		flush_batch(shared, worker, owner);
+	}
+	return 0;
+}
+
+/*
+ * Function:  add_child 
+ * --------------------
+ * Add a child to the worker it belongs to, the same way the serial search does: skip it if its 
+ * board has already been reached with no more moves, reopen it if this path is shorter. 
+ * A child that is the goal becomes the best solution if it is shorter than the current one
+ *    
+ *  shared: The parallel search
+ *  worker: The worker the child belongs to
+ *  message: The child
+ * 
+ *  returns: 0, or -1 if there is not enough memory
+ */
+int add_child(ParallelSearch *shared, Worker *worker, const Message *message){
+	StatePool *pool = &worker->pool;
+	unsigned int hash;
+	int state;
+	if (message->g_score + message->h_score >= shared->best_cost){
+		return 0;
+	}
+	state = reserve_state(pool);
+	if (state < 0){
+		return -1;
+	}
+	pool->packed[state] = message->board;
+	hash = hash_state(pool, state);
+	state = find_in_closed_set(&worker->closed, pool, state, hash);
+	if (state >= 0){
+		if (pool->states[state].g_score <= message->g_score){
+			return 0;
+		}
+		if (pool->states[state].closed){
+			pool->states[state].closed = 0;
+			worker->num_reopened++;
+		}
+	} else {
+		state = new_state(pool, message->parent, message->move, message->g_score, message->h_score, message->blank);
+		pool->states[state].wd_rows = message->wd_rows;
+		pool->states[state].wd_cols = message->wd_cols;
+		if (add_to_closed_set(&worker->closed, state, hash) != 0){
+			return -1;
+		}
+	}
+	pool->states[state].parent = message->parent;
+	pool->states[state].parent_owner = message->parent_owner;
+	pool->states[state].move = message->move;
+	pool->states[state].g_score = message->g_score;
+	if (insert_to_open_list(&worker->open, state, message->g_score + message->h_score, message->g_score) != 0){
+		return -1;
+	}
+	if (message->h_score == 0){
+		pthread_mutex_lock(&shared->best_lock);
+		if (message->g_score < shared->best_cost){
+			shared->best_cost = message->g_score;
+			shared->best_owner = worker->id;
+			shared->best_state = state;
+		}
+		pthread_mutex_unlock(&shared->best_lock);
+	}
+	return 0;
+}
+
+/*
+ * Function:  parallel_worker 
+ * --------------------
+ * Thread body of HDA*: take in the children sent by the other workers, expand the best state 
+ * of the own open list and send each child to the worker its board belongs to. States that 
+ * cannot lead to a shorter solution than the best one so far are dropped. When no worker has 
+ * anything left and no batch is in flight, the best solution is optimal
+ *    
+ *  arg: The Worker
+ * 
+ *  returns: NULL
+ */
+void* parallel_worker(void *arg){
+	Worker *worker = (Worker *) arg;
+	ParallelSearch *shared = worker->shared;
+	StatePool *pool = &worker->pool;
+	const Heuristic *heuristic = shared->heuristic;
+	Batch *batches, *batch;
+	Message message;
+	int N = pool->N;
+	int num_batches, active = 1, since_flush = 0;
+	int state, child, owner, i, k, go_back_move;
+	int blank, new_blank, tile, wd_rows, wd_cols;
+	
+	while (!shared->failed){
+		/* Children from the other workers */
+		batches = (Batch *) __sync_lock_test_and_set(&worker->inbox, NULL);
+		if (batches != NULL){
+			if (!active){
+				__sync_fetch_and_add(&shared->num_active, 1);
+				active = 1;
+			}
+			for (num_batches = 0; batches != NULL; num_batches++){
+				batch = batches;
+				batches = batch->next;
+				for (k = 0; k < batch->size; k++){
+					if (add_child(shared, worker, &batch->messages[k]) != 0){
+						shared->failed = 1;
+					}
+				}
+				free(batch);
+			}
+			__sync_fetch_and_sub(&shared->num_active, num_batches);
+		}
+		
+		if (extract_from_open_list(&worker->open, &state) != 0){
+			/* Nothing to expand: send what is left and wait */
+			for (owner = 0; owner < shared->num_threads; owner++){
+				flush_batch(shared, worker, owner);
+			}
+			if (active){
+				__sync_fetch_and_sub(&shared->num_active, 1);
+				active = 0;
+			}
+			if (shared->num_active == 0){
+				break;
+			}
+			sched_yield();
+			continue;
+		}
+		if (pool->states[state].closed 
+			|| (pool->states[state].g_score + pool->states[state].h_score >= shared->best_cost)){
+			/* Outdated, or no better than the best solution so far */
+			continue;
+		}
+		
+		go_back_move = (pool->states[state].parent == NO_PARENT) ? -1 : (pool->states[state].move ^ 1);
+		blank = pool->states[state].blank;
+		for (i = 0; i < NUM_OF_MOVES; i++){
+			if (((i == 0) && (blank / N == 0)) || ((i == 1) && (blank / N == N - 1)) 
+				|| ((i == 2) && (blank % N == 0)) || ((i == 3) && (blank % N == N - 1)) || (i == go_back_move)){
+				continue;
+			}
+			new_blank = blank + ((i == 0) ? -N : (i == 1) ? N : (i == 2) ? -1 : 1);
+			child = reserve_state(pool);
+			if (child < 0){
+				shared->failed = 1;
+				break;
+			}
+			tile = move_state(pool, state, child, blank, new_blank);
+			wd_rows = pool->states[state].wd_rows;
+			wd_cols = pool->states[state].wd_cols;
+			message.board = pool->packed[child];
+			message.parent = state;
+			message.parent_owner = (unsigned char) worker->id;
+			message.move = (unsigned char) i;
+			message.blank = (unsigned char) new_blank;
+			message.g_score = (unsigned short) (pool->states[state].g_score + 1);
+			STATS_COUNT(worker->num_evaluations);
+			message.h_score = (unsigned short) child_h_score(heuristic, pool, state, pool->states[state].h_score, child, 
+				i, tile, blank, new_blank, &wd_rows, &wd_cols);
+			message.wd_rows = (unsigned short) wd_rows;
+			message.wd_cols = (unsigned short) wd_cols;
+			owner = owner_of(hash_state(pool, child), shared->num_threads);
+			if (((owner == worker->id) ? add_child(shared, worker, &message) 
+				: send_child(shared, worker, owner, &message)) != 0){
+				shared->failed = 1;
+				break;
+			}
+		}
+		pool->states[state].closed = 1;
+		worker->num_expanded++;
+		
+		/* Do not keep children waiting in half-full batches for long */
+		since_flush++;
+		if (since_flush == FLUSH_INTERVAL){
+			for (owner = 0; owner < shared->num_threads; owner++){
+				flush_batch(shared, worker, owner);
+			}
+			since_flush = 0;
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Function:  build_parallel_desc 
+ * --------------------
+ * Create the move description of a state by following the parent links back to the start, 
+ * across the pools of the workers. A parent can have been improved after its child was 
+ * reached, so the path is measured before it is written
+ *    
+ *  workers: The workers
+ *  owner: The worker the state belongs to
+ *  state: Index of the state in its pool
+ *
+ *  returns: a new dynamically created move description (that must be freed afterwards)
+ */
+char* build_parallel_desc(const Worker *workers, int owner, int state){
+	const State *current;
+	int desc_length = 1, next_owner, next_state;
+	char *desc;
+	next_owner = owner;
+	next_state = state;
+	for (current = &workers[owner].pool.states[state]; current->parent != NO_PARENT; desc_length++){
+		current = &workers[current->parent_owner].pool.states[current->parent];
+	}
+	desc = (char *) malloc(sizeof(char) * (desc_length+1));
+	desc[0] = 'B';
+	desc[desc_length] = '\0';
+	for (current = &workers[owner].pool.states[state]; current->parent != NO_PARENT; ){
+		desc_length--;
+		desc[desc_length] = MOVE_CHARS[current->move];
+		next_owner = current->parent_owner;
+		next_state = current->parent;
+		current = &workers[next_owner].pool.states[next_state];
+	}
+	return desc;
+}
+
+/*
+ * Function:  run_parallel 
+ * --------------------
+ * Run the solver with Hash-Distributed A* (HDA*): every board belongs to one worker thread, 
+ * chosen by its hash, and each worker has its own state pool, open list and closed set. 
+ * Only packed boards (N <= MAX_PACKED_N) are supported
+ *    
+ *  start: The starting board
+ *  goal: The goal
+ *  N: width and height of the board 
+ *  heuristic: The heuristic
+ *  options: Options from the command line
+ * 
+ *  returns: 0 if a solution was found, 1 if not
+ */
+int run_parallel(const int **start, const int **goal, int N, const Heuristic *heuristic, const Options *options){
+	ParallelSearch shared;
+	Worker *workers;
+	pthread_t threads[MAX_THREADS];
+	Message message;
+	Batch *batch;
+	char *desc;
+	int num_threads = options->num_threads;
+	int i, owner, state, wd_rows, wd_cols, num_ready = 0, num_started;
+	long num_expanded = 0, num_generated = 0, num_reopened = 0;
+	int status = 1;
+#ifdef NPUZZLE_STATS
+	OpenList open[MAX_THREADS];
+	long num_evaluations = 0;
+	struct timespec start_time;
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+#endif
+	
+	if (N > MAX_PACKED_N){
+		printf("Threads need a board of at most %dx%d! \n", MAX_PACKED_N, MAX_PACKED_N);
+		return 1;
+	}
+	workers = (Worker *) malloc(sizeof(Worker) * num_threads);
+	if (workers == NULL){
+		printf("Out of memory! \n");
+		return 1;
+	}
+	shared.workers = workers;
+	shared.num_threads = num_threads;
+	shared.heuristic = heuristic;
+	shared.num_active = num_threads;
+	shared.failed = 0;
+	shared.best_cost = MAX_G_SCORE;
+	shared.best_owner = -1;
+	shared.best_state = -1;
+	pthread_mutex_init(&shared.best_lock, NULL);
+	for (num_ready = 0; num_ready < num_threads; num_ready++){
+		workers[num_ready].shared = &shared;
+		workers[num_ready].id = num_ready;
+		workers[num_ready].inbox = NULL;
+		workers[num_ready].num_expanded = 0;
+		workers[num_ready].num_reopened = 0;
+#ifdef NPUZZLE_STATS
+		workers[num_ready].num_evaluations = 0;
+#endif
+		for (i = 0; i < num_threads; i++){
+			workers[num_ready].outgoing[i] = NULL;
+		}
+		new_state_pool(&workers[num_ready].pool, goal, N);
+		new_open_list(&workers[num_ready].open, options->open_list);
+		if (new_closed_set(&workers[num_ready].closed, INITIAL_CLOSED_SET_CAPACITY) != 0){
+			free_open_list(&workers[num_ready].open);
+			free_state_pool(&workers[num_ready].pool);
+			printf("Out of memory! \n");
+			goto CLEANUP;
+		}
+	}
+	
+	/* The start goes to the worker it belongs to */
+	message.board = pack_board(start, N);
+	message.parent = NO_PARENT;
+	message.parent_owner = 0;
+	message.move = 0;
+	message.g_score = 0;
+	state = reserve_state(&workers[0].pool);
+	if (state < 0){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	workers[0].pool.packed[state] = message.board;
+	message.h_score = (unsigned short) h_score(&workers[0].pool, state, heuristic, &wd_rows, &wd_cols);
+	message.blank = (unsigned char) find_blank(&workers[0].pool, state);
+	message.wd_rows = (unsigned short) wd_rows;
+	message.wd_cols = (unsigned short) wd_cols;
+	owner = owner_of(hash_state(&workers[0].pool, state), num_threads);
+	if (add_child(&shared, &workers[owner], &message) != 0){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	
+	printf("Threads: %d \n", num_threads);
+	for (num_started = 1; num_started < num_threads; num_started++){
+		if (pthread_create(&threads[num_started], NULL, parallel_worker, &workers[num_started]) != 0){
+			break;
+		}
+	}
+	if (num_started < num_threads){
+		/* The boards of the missing workers would never be expanded */
+		printf("Could not start %d threads! \n", num_threads);
+		shared.failed = 1;
+	}
+	parallel_worker(&workers[0]);
+	for (i = 1; i < num_started; i++){
+		pthread_join(threads[i], NULL);
+	}
+	
+	if (shared.failed){
+		printf("Out of memory! \n");
+	} else if (shared.best_state < 0){
+		printf("The heap is empty already! Something must be wrong! \n");
+	} else {
+		desc = build_parallel_desc((const Worker *) workers, shared.best_owner, shared.best_state);
+		print_solution(start, N, (const char *) desc);
+		free(desc);
+		for (i = 0; i < num_threads; i++){
+			num_expanded += workers[i].num_expanded;
+			num_generated += workers[i].pool.size;
+			num_reopened += workers[i].num_reopened;
+		}
+		printf("States expanded: %ld, generated: %ld, reopened: %ld \n", num_expanded, num_generated, num_reopened);
+		status = 0;
+	}
+#ifdef NPUZZLE_STATS
+	for (i = 0; i < num_threads; i++){
+		open[i] = workers[i].open;
+		num_evaluations += workers[i].num_evaluations;
+	}
+	record_search(num_threads, num_expanded, num_generated, num_evaluations, (const OpenList *) open, num_threads, 
+		seconds_since(&start_time));
+#endif
+	
+	CLEANUP: {
+		for (i = 0; i < num_ready; i++){
+			for (owner = 0; owner < num_threads; owner++){
+				free(workers[i].outgoing[owner]);
+			}
+			while (workers[i].inbox != NULL){
+				batch = workers[i].inbox;
+				workers[i].inbox = batch->next;
+				free(batch);
+			}
+			free_closed_set(&workers[i].closed);
+			free_open_list(&workers[i].open);
+			free_state_pool(&workers[i].pool);
+		}
+		pthread_mutex_destroy(&shared.best_lock);
+		free(workers);
+		return status;
+	}
+}
+
+/*
+ * Function:  seconds_since 
+ * --------------------
+ * Time elapsed since a point taken with clock_gettime(CLOCK_MONOTONIC)
+ *    
+ *  start: The starting point
+ * 
+ *  returns: the number of seconds
+ */
+double seconds_since(const struct timespec *start){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/*
+ * Function:  solve 
+ * --------------------
+ * Solve one instance with A-star, once the heuristic for its goal is set up
+ *    
+ *  start: The starting board
+ *  goal: The goal
+ *  N: width and height of the board 
+ *  heuristic: The heuristic for the goal, only read, so it can be shared between threads
+ *  open_list: OPEN_LIST_HEAP or OPEN_LIST_BUCKETS
+ *  desc: Set to the moves of the solution, starting with 'B', to be freed by the caller
+ *  num_expanded: Set to the number of states expanded
+ *  num_generated: Set to the number of states generated
+ *  num_reopened: Set to the number of closed states reached again by a shorter path
+ * 
+ *  returns: 0 if a solution was found, 1 if the open list ran out, -1 if out of memory
+ */
+int solve(const int** start, const int ** goal, int N, const Heuristic *heuristic, int open_list, char **desc, 
+	long *num_expanded, long *num_generated, long *num_reopened){
+	int i;
+	StatePool pool;
+	OpenList open;
+	ClosedSet closed;
+	int state, state_2;
+	int h_score_2;
+	int g_score, g_score_2;
+	int go_back_move;
+	int blank, new_blank, blank_row, blank_col, tile;
+	int wd_rows, wd_cols;
+	int status = -1;
+	unsigned int hash;
+#ifdef NPUZZLE_STATS
+	long num_evaluations = 1;
+	struct timespec start_time;
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+#endif
+	
+	*desc = NULL;
+	*num_expanded = 0;
+	*num_reopened = 0;
+	new_state_pool(&pool, goal, N);
+	new_open_list(&open, open_list);
+	if (new_closed_set(&closed, INITIAL_CLOSED_SET_CAPACITY) != 0){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	
+	/* First, insert the initial state into the heap */
+	if (reserve_state(&pool) < 0){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	if (N <= MAX_PACKED_N){
+		pool.packed[0] = pack_board(start, N);
+	} else {
+		encode_board(start, N, pool.codes);
+	}
+	h_score_2 = h_score(&pool, 0, heuristic, &wd_rows, &wd_cols);
+	state = new_state(&pool, NO_PARENT, 0, 0, h_score_2, find_blank(&pool, 0));
+	pool.states[state].wd_rows = (unsigned short) wd_rows;
+	pool.states[state].wd_cols = (unsigned short) wd_cols;
+	if ((insert_to_open_list(&open, state, h_score_2, 0) != 0)
+		|| (add_to_closed_set(&closed, state, hash_state(&pool, state)) != 0)){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	
+	while (1){
+		/* Extract the state with the lowest score from the heap
+		 */
+		if (extract_from_open_list(&open, &state) != 0){
+			status = 1;
+			goto CLEANUP;
+		}
+		if (pool.states[state].closed){
+			/* An outdated entry, left behind when a shorter path to the state was found */
+			continue;
+		}
+		g_score = pool.states[state].g_score;
+		
+		/* If it is the goal state then stop and hand back the solution 
+		 */
+		if (is_goal(&pool, state)){
+			*desc = build_desc(&pool, state);
+			status = 0;
+			goto CLEANUP;
+		}
+		
+		/* Else insert all neighboring states (those that can be reached in one move 
+		   from the extracted state) onto the heap
+		 */
+		go_back_move = (pool.states[state].parent == NO_PARENT) ? -1 : (pool.states[state].move ^ 1);
+		blank = pool.states[state].blank;
+		blank_row = blank / N;
+		blank_col = blank % N;
+		for (i = 0; i < NUM_OF_MOVES; i++){			
+			switch (i) {
+				case 0:
+					/* Up */
+					new_blank = (blank_row != 0) ? blank - N : -1;
+					break;
+				case 1:
+					/* Down */
+					new_blank = (blank_row != N - 1) ? blank + N : -1;
+					break;
+				case 2:
+					/* Left */
+					new_blank = (blank_col != 0) ? blank - 1 : -1;
+					break;
+				default:
+					/* Right */
+					new_blank = (blank_col != N - 1) ? blank + 1 : -1;
+					break;
+			}
+			if ((new_blank < 0) || (i == go_back_move)){
+				continue;			
+			}
+			
+			/* Build the child in the reserved slot of the pool */
+			state_2 = reserve_state(&pool);
+			if (state_2 < 0){
+				printf("Out of memory! \n");
+				goto CLEANUP;
+			}
+			tile = move_state(&pool, state, state_2, blank, new_blank);
+			g_score_2 = g_score + 1;
+			
+			/* Skip the child if its board has already been reached with no more moves, 
+			   and reopen it if this path is shorter */
+			hash = hash_state(&pool, state_2);
+			state_2 = find_in_closed_set(&closed, &pool, state_2, hash);
+			if (state_2 >= 0){
+				if (pool.states[state_2].g_score <= g_score_2){
+					continue;
+				}
+				pool.states[state_2].parent = state;
+				pool.states[state_2].move = (unsigned char) i;
+				pool.states[state_2].g_score = (unsigned short) g_score_2;
+				if (pool.states[state_2].closed){
+					pool.states[state_2].closed = 0;
+					(*num_reopened)++;
+				}
+				if (insert_to_open_list(&open, state_2, g_score_2 + pool.states[state_2].h_score, g_score_2) != 0){
+					printf("Out of memory! \n");
+					goto CLEANUP;
+				}
+				continue;
+			}
+			
+			/* Update h_score: only the moved tile changes its distance, along one axis */
+			wd_rows = pool.states[state].wd_rows;
+			wd_cols = pool.states[state].wd_cols;
+			STATS_COUNT(num_evaluations);
+			h_score_2 = child_h_score(heuristic, &pool, state, pool.states[state].h_score, pool.size, i, tile, 
+				blank, new_blank, &wd_rows, &wd_cols);
+			state_2 = new_state(&pool, state, i, g_score_2, h_score_2, new_blank);
+			pool.states[state_2].wd_rows = (unsigned short) wd_rows;
+			pool.states[state_2].wd_cols = (unsigned short) wd_cols;
+			if ((insert_to_open_list(&open, state_2, g_score_2 + h_score_2, g_score_2) != 0)
+				|| (add_to_closed_set(&closed, state_2, hash) != 0)){
+				printf("Out of memory! \n");
+				goto CLEANUP;
+			}
+		}
+		
+		/* The extracted state stays in the pool for duplicate detection and as the parent of its children */
+		pool.states[state].closed = 1;
+		(*num_expanded)++;
+	}
+	
+	CLEANUP: {
+		*num_generated = pool.size;
+#ifdef NPUZZLE_STATS
+		record_search(1, *num_expanded, *num_generated, num_evaluations, (const OpenList *) &open, 1, 
+			seconds_since(&start_time));
+#endif
+		free_closed_set(&closed);
+		free_open_list(&open);
+		free_state_pool(&pool);
+		return status;
+	}
+}
+
+/*
+ * Function:  solve_bidirectional 
+ * --------------------
+ * Solve one instance with bidirectional A-star (BAE*, Sadhukhan 2013): one search goes forward 
+ * from the start and one backward from the goal, each with its own state pool, open list and 
+ * closed set. A state is scored b = 2g + h - h', where h' estimates the distance back to the end 
+ * its search started from, so b is f plus what is known to be missing from that estimate. The 
+ * side that has generated fewer states expands next. Every child is looked up in the closed set 
+ * of the other side, which holds every board reached from there, and the shortest path through 
+ * such a meeting point is kept. It is optimal once it is no longer than the mean of the lowest 
+ * scores of the two sides, which needs consistent heuristics (as all of them are)
+ *    
+ *  start: The starting board
+ *  goal: The goal
+ *  N: width and height of the board 
+ *  heuristic: The heuristic for the goal, only read. The backward search sets up the same kind 
+ *             of heuristic for the start
+ *  open_list: OPEN_LIST_HEAP or OPEN_LIST_BUCKETS
+ *  desc: Set to the moves of the solution, starting with 'B', to be freed by the caller
+ *  meeting: Set to the number of moves of the solution made before the meeting point
+ *  num_expanded: Set to the number of states expanded by both searches
+ *  num_generated: Set to the number of states generated by both searches
+ *  num_reopened: Set to the number of closed states reached again by a shorter path
+ * 
+ *  returns: 0 if a solution was found, 1 if an open list ran out, -1 if out of memory 
+ *           or if the heuristic is not available for the start
+ */
+int solve_bidirectional(const int** start, const int ** goal, int N, const Heuristic *heuristic, int open_list, 
+	char **desc, int *meeting, long *num_expanded, long *num_generated, long *num_reopened){
+	int i, side, other;
+	StatePool pools[2]; /* Indexed by side: 0 searches from the start, 1 from the goal */
+	OpenList open[2];
+	ClosedSet closed[2];
+	Estimate *estimates[2] = {NULL, NULL}; /* estimates[side][i] = h' of state i of the pool of that side */
+	int num_estimates[2] = {0, 0};
+	Estimate *grown;
+	const Heuristic *heuristics[2];
+	Heuristic backward;
+	int *start_rows = NULL, *start_cols = NULL;
+	StatePool *pool;
+	int state, state_2, match;
+	int h_score_2, back_h_score, score[2];
+	int g_score, g_score_2;
+	int go_back_move;
+	int blank, new_blank, blank_row, blank_col, tile;
+	int wd_rows, wd_cols, back_wd_rows, back_wd_cols;
+	int best_cost = INT_MAX; /* Length of the shortest path found through a meeting point */
+	int best_states[2] = {-1, -1}; /* The meeting point, in the pool of each side */
+	int status = -1;
+	unsigned int hash;
+#ifdef NPUZZLE_STATS
+	long num_evaluations = 4;
+	struct timespec start_time;
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+#endif
+	
+	*desc = NULL;
+	*meeting = 0;
+	*num_expanded = 0;
+	*num_reopened = 0;
+	backward.rows.table = NULL;
+	backward.cols.table = NULL;
+	for (side = 0; side < 2; side++){
+		new_state_pool(&pools[side], (side == 0) ? goal : start, N);
+		new_open_list(&open[side], open_list);
+		closed[side].entries = NULL;
+	}
+	if ((new_closed_set(&closed[0], INITIAL_CLOSED_SET_CAPACITY) != 0) 
+		|| (new_closed_set(&closed[1], INITIAL_CLOSED_SET_CAPACITY) != 0)){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	
+	/* The backward search heads for the start */
+	start_rows = (int *) malloc(sizeof(int) * N * N);
+	start_cols = (int *) malloc(sizeof(int) * N * N);
+	if ((start_rows == NULL) || (start_cols == NULL)){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	for (i = 0; i < N*N; i++){
+		start_rows[start[i / N][i % N]] = i / N;
+		start_cols[start[i / N][i % N]] = i % N;
+	}
+	if (new_heuristic(&backward, heuristic->kind, (const int *) start_rows, (const int *) start_cols, N) != 0){
+		goto CLEANUP;
+	}
+	heuristics[0] = heuristic;
+	heuristics[1] = (const Heuristic *) &backward;
+	
+	/* Insert the start into the forward open list and the goal into the backward one */
+	for (side = 0; side < 2; side++){
+		pool = &pools[side];
+		if (reserve_state(pool) < 0){
+			printf("Out of memory! \n");
+			goto CLEANUP;
+		}
+		if (N <= MAX_PACKED_N){
+			pool->packed[0] = pack_board((side == 0) ? start : goal, N);
+		} else {
+			encode_board((side == 0) ? start : goal, N, pool->codes);
+		}
+		h_score_2 = h_score(pool, 0, heuristics[side], &wd_rows, &wd_cols);
+		back_h_score = h_score(pool, 0, heuristics[1 - side], &back_wd_rows, &back_wd_cols);
+		estimates[side] = (Estimate *) malloc(sizeof(Estimate) * pool->capacity);
+		if (estimates[side] == NULL){
+			printf("Out of memory! \n");
+			goto CLEANUP;
+		}
+		num_estimates[side] = pool->capacity;
+		state = new_state(pool, NO_PARENT, 0, 0, h_score_2, find_blank(pool, 0));
+		pool->states[state].wd_rows = (unsigned short) wd_rows;
+		pool->states[state].wd_cols = (unsigned short) wd_cols;
+		estimates[side][state].h_score = (unsigned short) back_h_score;
+		estimates[side][state].wd_rows = (unsigned short) back_wd_rows;
+		estimates[side][state].wd_cols = (unsigned short) back_wd_cols;
+		if ((insert_to_open_list(&open[side], state, h_score_2 - back_h_score, 0) != 0)
+			|| (add_to_closed_set(&closed[side], state, hash_state(pool, state)) != 0)){
+			printf("Out of memory! \n");
+			goto CLEANUP;
+		}
+	}
+	if (is_goal(&pools[0], 0)){
+		best_cost = 0;
+		best_states[0] = 0;
+		best_states[1] = 0;
+	}
+	
+	while (1){
+		/* Stop once no open state on either side can lead to a shorter path than the best one found. 
+		   Outdated entries can only make the scores lower, which never stops the search too early
+		 */
+		score[0] = min_score_in_open_list(&open[0]);
+		score[1] = min_score_in_open_list(&open[1]);
+		if ((score[0] < 0) || (score[1] < 0)){
+			status = (best_cost < INT_MAX) ? 0 : 1;
+			goto CLEANUP;
+		}
+		if (best_cost <= (score[0] + score[1] + 1) / 2){
+			status = 0;
+			goto CLEANUP;
+		}
+		
+		side = (pools[0].size <= pools[1].size) ? 0 : 1;
+		other = 1 - side;
+		pool = &pools[side];
+		extract_from_open_list(&open[side], &state);
+		if (pool->states[state].closed){
+			/* An outdated entry, left behind when a shorter path to the state was found */
+			continue;
+		}
+		g_score = pool->states[state].g_score;
+		
+		go_back_move = (pool->states[state].parent == NO_PARENT) ? -1 : (pool->states[state].move ^ 1);
+		blank = pool->states[state].blank;
+		blank_row = blank / N;
+		blank_col = blank % N;
+		for (i = 0; i < NUM_OF_MOVES; i++){			
+			switch (i) {
+				case 0:
+					/* Up */
+					new_blank = (blank_row != 0) ? blank - N : -1;
+					break;
+				case 1:
+					/* Down */
+					new_blank = (blank_row != N - 1) ? blank + N : -1;
+					break;
+				case 2:
+					/* Left */
+					new_blank = (blank_col != 0) ? blank - 1 : -1;
+					break;
+				default:
+					/* Right */
+					new_blank = (blank_col != N - 1) ? blank + 1 : -1;
+					break;
+			}
+			if ((new_blank < 0) || (i == go_back_move)){
+				continue;			
+			}
+			
+			/* Build the child in the reserved slot of the pool */
+			state_2 = reserve_state(pool);
+			if (state_2 < 0){
+				printf("Out of memory! \n");
+				goto CLEANUP;
+			}
+			tile = move_state(pool, state, state_2, blank, new_blank);
+			g_score_2 = g_score + 1;
+			
+			/* Skip the child if its board has already been reached from this side with no more moves, 
+			   and reopen it if this path is shorter */
+			hash = hash_state(pool, state_2);
+			state_2 = find_in_closed_set(&closed[side], pool, state_2, hash);
+			if (state_2 >= 0){
+				if (pool->states[state_2].g_score <= g_score_2){
+					continue;
+				}
+				pool->states[state_2].parent = state;
+				pool->states[state_2].move = (unsigned char) i;
+				pool->states[state_2].g_score = (unsigned short) g_score_2;
+				if (pool->states[state_2].closed){
+					pool->states[state_2].closed = 0;
+					(*num_reopened)++;
+				}
+				h_score_2 = pool->states[state_2].h_score;
+			} else {
+				/* Update both estimates: only the moved tile changes its distance, along one axis */
+				if (num_estimates[side] < pool->capacity){
+					grown = (Estimate *) realloc(estimates[side], sizeof(Estimate) * pool->capacity);
+					if (grown == NULL){
+						printf("Out of memory! \n");
+						goto CLEANUP;
+					}
+					estimates[side] = grown;
+					num_estimates[side] = pool->capacity;
+				}
+				wd_rows = pool->states[state].wd_rows;
+				wd_cols = pool->states[state].wd_cols;
+				back_wd_rows = estimates[side][state].wd_rows;
+				back_wd_cols = estimates[side][state].wd_cols;
+				STATS_COUNT(num_evaluations);
+				STATS_COUNT(num_evaluations);
+				h_score_2 = child_h_score(heuristics[side], pool, state, pool->states[state].h_score, pool->size, 
+					i, tile, blank, new_blank, &wd_rows, &wd_cols);
+				back_h_score = child_h_score(heuristics[other], pool, state, estimates[side][state].h_score, 
+					pool->size, i, tile, blank, new_blank, &back_wd_rows, &back_wd_cols);
+				state_2 = new_state(pool, state, i, g_score_2, h_score_2, new_blank);
+				pool->states[state_2].wd_rows = (unsigned short) wd_rows;
+				pool->states[state_2].wd_cols = (unsigned short) wd_cols;
+				estimates[side][state_2].h_score = (unsigned short) back_h_score;
+				estimates[side][state_2].wd_rows = (unsigned short) back_wd_rows;
+				estimates[side][state_2].wd_cols = (unsigned short) back_wd_cols;
+				if (add_to_closed_set(&closed[side], state_2, hash) != 0){
+					printf("Out of memory! \n");
+					goto CLEANUP;
+				}
+			}
+			
+			/* Meet the other side if it has reached this board too */
+			if (reserve_state(&pools[other]) < 0){
+				printf("Out of memory! \n");
+				goto CLEANUP;
+			}
+			copy_board(&pools[other], pools[other].size, pool, state_2);
+			match = find_in_closed_set(&closed[other], &pools[other], pools[other].size, hash);
+			if ((match >= 0) && (g_score_2 + pools[other].states[match].g_score < best_cost)){
+				best_cost = g_score_2 + pools[other].states[match].g_score;
+				best_states[side] = state_2;
+				best_states[other] = match;
+			}
+			
+			/* A child that cannot lead to a shorter path needs no expanding. Since h' is consistent 
+			   and 0 where the search started, h' <= g and the score is never below g */
+			if (g_score_2 + h_score_2 >= best_cost){
+				continue;
+			}
+			if (insert_to_open_list(&open[side], state_2, 
+				2 * g_score_2 + h_score_2 - estimates[side][state_2].h_score, g_score_2) != 0){
+				printf("Out of memory! \n");
+				goto CLEANUP;
+			}
+		}
+		
+		/* The extracted state stays in the pool for duplicate detection and as the parent of its children */
+		pool->states[state].closed = 1;
+		(*num_expanded)++;
+	}
+	
+	CLEANUP: {
+		if (status == 0){
+			*desc = build_bidirectional_desc(&pools[0], best_states[0], &pools[1], best_states[1], meeting);
+			if (*desc == NULL){
+				printf("Out of memory! \n");
+				status = -1;
+			}
+		}
+		*num_generated = pools[0].size + pools[1].size;
+#ifdef NPUZZLE_STATS
+		record_search(1, *num_expanded, *num_generated, num_evaluations, (const OpenList *) open, 2, 
+			seconds_since(&start_time));
+#endif
+		for (side = 0; side < 2; side++){
+			free_closed_set(&closed[side]);
+			free_open_list(&open[side]);
+			free_state_pool(&pools[side]);
+			free(estimates[side]);
+		}
+		free_heuristic(&backward);
+		free(start_rows);
+		free(start_cols);
+		return status;
+	}
+}
+
+/*
+ * Function:  bounded_score 
+ * --------------------
+ * The score of a node of solve_bounded: its f-score until it is expanded, then the lowest 
+ * score of its children that were evicted, as those are the ones that expanding it again brings back
+ *    
+ *  search: The bounded search
+ *  state: Index of the node
+ * 
+ *  returns: the score, SMA_INFINITY if there is nothing left to expand
+ */
+int bounded_score(const BoundedSearch *search, int state){
+	if (search->pool.states[state].closed){
+		return search->nodes[state].forgotten;
+	}
+	return search->nodes[state].f_score;
+}
+
+/*
+ * Function:  place_bounded_node 
+ * --------------------
+ * Put a node of solve_bounded in the heaps it belongs to, with its current score: the open 
+ * nodes if it has anything left to expand, and the leaves if it has no children in memory 
+ * (the start is never evicted), and take it out of the others
+ *    
+ *  search: The bounded search
+ *  state: Index of the node
+ * 
+ *  returns: 0
+ */
+int place_bounded_node(BoundedSearch *search, int state){
+	int score = bounded_score(search, state);
+	unsigned int key = ((unsigned int) score << 16) | (unsigned int) (MAX_G_SCORE - search->pool.states[state].g_score);
+	if (score < SMA_INFINITY){
+		update_indexed_heap(&search->best, state, key);
+	} else {
+		remove_from_indexed_heap(&search->best, state);
+	}
+	if ((search->nodes[state].num_children == 0) && (search->pool.states[state].parent != NO_PARENT)){
+		/* Highest score first, then the smaller g-score */
+		update_indexed_heap(&search->worst, state, ~key);
+	} else {
+		remove_from_indexed_heap(&search->worst, state);
+	}
+	return 0;
+}
+
+/*
+ * Function:  evict_worst_leaf 
+ * --------------------
+ * Free the slot of the leaf with the highest score, the shallowest one among those. Its parent 
+ * keeps the lowest score of its evicted children as what it is worth expanding again for, which 
+ * backs up what was learned below them
+ *    
+ *  search: The bounded search
+ *  expanding: The node being expanded, which is left out of the heaps until it is done
+ * 
+ *  returns: 0, or -1 if there is no leaf to evict
+ */
+int evict_worst_leaf(BoundedSearch *search, int expanding){
+	State *states = search->pool.states;
+	int leaf, parent, score;
+	if (search->worst.size == 0){
+		return -1;
+	}
+	leaf = search->worst.entries[1].state;
+	parent = states[leaf].parent;
+	score = bounded_score(search, leaf);
+	remove_from_indexed_heap(&search->best, leaf);
+	remove_from_indexed_heap(&search->worst, leaf);
+	remove_from_closed_set(&search->boards, leaf, hash_state(&search->pool, leaf)); /* Unless a shorter copy replaced it */
+	search->nodes[parent].children[states[leaf].move] = -1;
+	search->nodes[parent].num_children--;
+	if (score < search->nodes[parent].forgotten){
+		search->nodes[parent].forgotten = (unsigned short) score;
+	}
+	if (parent != expanding){
+		place_bounded_node(search, parent);
+	}
+	search->nodes[leaf].children[0] = search->free_slots;
+	search->free_slots = leaf;
+	search->num_free++;
+	search->num_evicted++;
+	return 0;
+}
+
+/*
+ * Function:  solve_bounded 
+ * --------------------
+ * Solve one instance with SMA* (simplified memory-bounded A*, Russell 1992) in a fixed amount 
+ * of memory, set aside before the search. It is best-first like solve, on a tree of moves 
+ * whose nodes can be evicted. Once every slot is taken, the leaf with the highest score is 
+ * evicted to make room, and its parent remembers its score so that it is expanded again when 
+ * that is the lowest one left. A node generated again gets at least the score of its parent, 
+ * so the scores only go up along a path, and the solution is optimal as long as its path fits 
+ * in memory. The boards in memory are kept in a hash table: a child whose board is already 
+ * there with no more moves is dropped, as the copy in memory stands for it, and one reached in 
+ * fewer moves takes the place of the old copy in the table. So with plenty of memory nothing 
+ * is evicted and every board is expanded about once, as in solve
+ *    
+ *  start: The starting board
+ *  goal: The goal
+ *  N: width and height of the board 
+ *  heuristic: The heuristic for the goal, only read, so it can be shared between threads
+ *  memory_megabytes: Memory for the nodes and their heaps
+ *  desc: Set to the moves of the solution, starting with 'B', to be freed by the caller
+ *  num_expanded: Set to the number of nodes expanded, again counted every time
+ *  num_generated: Set to the number of nodes generated, again counted every time
+ *  num_evicted: Set to the number of nodes evicted
+ * 
+ *  returns: 0 if a solution was found, 1 if none fits in memory, -1 if out of memory
+ */
+int solve_bounded(const int** start, const int ** goal, int N, const Heuristic *heuristic, long memory_megabytes, 
+	char **desc, long *num_expanded, long *num_generated, long *num_evicted){
+	BoundedSearch search;
+	StatePool *pool = &search.pool;
+	BoundedNode *nodes = NULL;
+	long capacity;
+	size_t slot_size;
+	unsigned long table_size;
+	unsigned int hash;
+	int i, state, state_2, copy, score;
+	int h_score_2, g_score_2;
+	int go_back_move;
+	int blank, new_blank, blank_row, blank_col, tile;
+	int wd_rows, wd_cols;
+	int status = -1;
+#ifdef NPUZZLE_STATS
+	long num_evaluations = 1;
+	struct timespec start_time;
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+#endif
+	
+	*desc = NULL;
+	*num_expanded = 0;
+	*num_generated = 1;
+	search.nodes = NULL;
+	search.best.entries = NULL;
+	search.best.positions = NULL;
+	search.worst.entries = NULL;
+	search.worst.positions = NULL;
+	search.boards.entries = NULL;
+	search.num_evicted = 0;
+	new_state_pool(pool, goal, N);
+	
+	/* Every slot costs a state, its board, a node, an entry and a position in each heap and two 
+	   entries of the hash table, which is kept at most half full */
+	slot_size = sizeof(State) + sizeof(BoundedNode) + ((N <= MAX_PACKED_N) ? sizeof(uint64_t) : (size_t) pool->code_length) 
+		+ 2 * (sizeof(HeapEntry) + sizeof(int));
+	capacity = (memory_megabytes << 20) / (long) (slot_size + 2 * sizeof(ClosedSetEntry));
+	capacity = (capacity > INT_MAX / 4) ? INT_MAX / 4 : capacity - 1; /* One more heap entry than slots */
+	for (table_size = 1; table_size < 2 * (unsigned long) (capacity + 1); table_size *= 2){
+		/* A power of two */
+	}
+	if (table_size * sizeof(ClosedSetEntry) + (unsigned long) capacity * slot_size > (unsigned long) memory_megabytes << 20){
+		/* Rather a smaller table and fewer slots than more memory */
+		table_size /= 2;
+		capacity = (long) table_size / 2 - 1;
+	}
+	pool->states = (State *) malloc(sizeof(State) * (capacity + 1));
+	if (N <= MAX_PACKED_N){
+		pool->packed = (uint64_t *) malloc(sizeof(uint64_t) * (capacity + 1));
+	} else {
+		pool->codes = (unsigned char *) malloc(sizeof(unsigned char) * (capacity + 1) * pool->code_length);
+	}
+	search.nodes = (BoundedNode *) malloc(sizeof(BoundedNode) * capacity);
+	nodes = search.nodes;
+	if ((pool->states == NULL) || ((pool->packed == NULL) && (pool->codes == NULL)) || (nodes == NULL) 
+		|| (new_indexed_heap(&search.best, (int) capacity) != 0) || (new_indexed_heap(&search.worst, (int) capacity) != 0)
+		|| (new_closed_set(&search.boards, table_size) != 0)){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	pool->capacity = (int) capacity + 1;
+	pool->size = (int) capacity; /* The slots are handed out by the free list */
+	search.scratch = (int) capacity;
+	search.free_slots = -1;
+	search.num_used = 1;
+	search.num_free = (int) capacity - 1;
+	
+	/* The start takes slot 0 */
+	if (N <= MAX_PACKED_N){
+		pool->packed[0] = pack_board(start, N);
+	} else {
+		encode_board(start, N, pool->codes);
+	}
+	h_score_2 = h_score(pool, 0, heuristic, &wd_rows, &wd_cols);
+	pool->states[0].parent = NO_PARENT;
+	pool->states[0].move = 0;
+	pool->states[0].g_score = 0;
+	pool->states[0].h_score = (unsigned short) h_score_2;
+	pool->states[0].closed = 0;
+	pool->states[0].blank = (unsigned char) find_blank(pool, 0);
+	pool->states[0].parent_owner = 0;
+	pool->states[0].wd_rows = (unsigned short) wd_rows;
+	pool->states[0].wd_cols = (unsigned short) wd_cols;
+	for (i = 0; i < NUM_OF_MOVES; i++){
+		nodes[0].children[i] = -1;
+	}
+	nodes[0].f_score = (unsigned short) h_score_2;
+	nodes[0].forgotten = SMA_INFINITY;
+	nodes[0].num_children = 0;
+	place_bounded_node(&search, 0);
+	add_to_closed_set(&search.boards, 0, hash_state(pool, 0));
+	
+	while (1){
+		if (search.best.size == 0){
+			/* Every path left runs out of memory before the goal */
+			status = 1;
+			goto CLEANUP;
+		}
+		state = search.best.entries[1].state;
+		score = bounded_score(&search, state);
+		if (!pool->states[state].closed && is_goal(pool, state)){
+			*desc = build_desc(pool, state);
+			status = 0;
+			goto CLEANUP;
+		}
+		
+		/* Generate the children that are not in memory: all of them the first time, 
+		   the evicted ones after that */
+		remove_from_indexed_heap(&search.best, state);
+		remove_from_indexed_heap(&search.worst, state);
+		pool->states[state].closed = 1;
+		nodes[state].forgotten = SMA_INFINITY;
+		go_back_move = (pool->states[state].parent == NO_PARENT) ? -1 : (pool->states[state].move ^ 1);
+		blank = pool->states[state].blank;
+		blank_row = blank / N;
+		blank_col = blank % N;
+		for (i = 0; i < NUM_OF_MOVES; i++){			
+			switch (i) {
+				case 0:
+					/* Up */
+					new_blank = (blank_row != 0) ? blank - N : -1;
+					break;
+				case 1:
+					/* Down */
+					new_blank = (blank_row != N - 1) ? blank + N : -1;
+					break;
+				case 2:
+					/* Left */
+					new_blank = (blank_col != 0) ? blank - 1 : -1;
+					break;
+				default:
+					/* Right */
+					new_blank = (blank_col != N - 1) ? blank + 1 : -1;
+					break;
+			}
+			if ((new_blank < 0) || (i == go_back_move) || (nodes[state].children[i] >= 0)){
+				continue;			
+			}
+			
+			/* A board in memory with no more moves already stands for the child */
+			tile = move_state(pool, state, search.scratch, blank, new_blank);
+			g_score_2 = pool->states[state].g_score + 1;
+			hash = hash_state(pool, search.scratch);
+			copy = find_in_closed_set(&search.boards, pool, search.scratch, hash);
+			if ((copy >= 0) && (pool->states[copy].g_score <= g_score_2)){
+				continue;
+			}
+			if ((search.num_free == 0) && (evict_worst_leaf(&search, state) != 0)){
+				/* Only the path to this node is left in memory: the child is dropped with an infinite 
+				   score, until this node is evicted and generated again */
+				continue;
+			}
+			
+			/* Move the child to a free slot. The copy reached in more moves stays in the tree 
+			   until it is evicted, but it is not looked up any more */
+			if (search.free_slots >= 0){
+				state_2 = search.free_slots;
+				search.free_slots = nodes[state_2].children[0];
+			} else {
+				state_2 = search.num_used;
+				search.num_used++;
+			}
+			search.num_free--;
+			copy_board(pool, state_2, (const StatePool *) pool, search.scratch);
+			if (copy >= 0){
+				remove_from_closed_set(&search.boards, copy, hash);
+			}
+			add_to_closed_set(&search.boards, state_2, hash);
+			wd_rows = pool->states[state].wd_rows;
+			wd_cols = pool->states[state].wd_cols;
+			STATS_COUNT(num_evaluations);
+			h_score_2 = child_h_score(heuristic, pool, state, pool->states[state].h_score, state_2, i, tile, 
+				blank, new_blank, &wd_rows, &wd_cols);
+			pool->states[state_2].parent = state;
+			pool->states[state_2].move = (unsigned char) i;
+			pool->states[state_2].g_score = (unsigned short) g_score_2;
+			pool->states[state_2].h_score = (unsigned short) h_score_2;
+			pool->states[state_2].closed = 0;
+			pool->states[state_2].blank = (unsigned char) new_blank;
+			pool->states[state_2].parent_owner = 0;
+			pool->states[state_2].wd_rows = (unsigned short) wd_rows;
+			pool->states[state_2].wd_cols = (unsigned short) wd_cols;
+			nodes[state_2].children[0] = -1;
+			nodes[state_2].children[1] = -1;
+			nodes[state_2].children[2] = -1;
+			nodes[state_2].children[3] = -1;
+			nodes[state_2].f_score = (unsigned short) ((g_score_2 + h_score_2 > score) ? g_score_2 + h_score_2 : score);
+			nodes[state_2].forgotten = SMA_INFINITY;
+			nodes[state_2].num_children = 0;
+			nodes[state].children[i] = state_2;
+			nodes[state].num_children++;
+			place_bounded_node(&search, state_2);
+			(*num_generated)++;
+		}
+		place_bounded_node(&search, state);
+		(*num_expanded)++;
+	}
+	
+	CLEANUP: {
+		*num_evicted = search.num_evicted;
+#ifdef NPUZZLE_STATS
+		record_search(1, *num_expanded, *num_generated, num_evaluations, NULL, 0, seconds_since(&start_time));
+#endif
+		free_indexed_heap(&search.best);
+		free_indexed_heap(&search.worst);
+		free_closed_set(&search.boards);
+		free(search.nodes);
+		free_state_pool(pool);
+		return status;
+	}
+}
+
+/*
+ * Function:  move_blank 
+ * --------------------
+ * Where 'x' ends up after a move
+ *    
+ *  blank: Position (row*N + col) of 'x'
+ *  move: The move, as an index into MOVE_CHARS
+ *  N: width and height of the board 
+ * 
+ *  returns: the new position of 'x', or -1 if the move would take it off the board
+ */
+int move_blank(int blank, int move, int N){
+	switch (move) {
+		case 0:
+			/* Up */
+			return (blank / N != 0) ? blank - N : -1;
+		case 1:
+			/* Down */
+			return (blank / N != N - 1) ? blank + N : -1;
+		case 2:
+			/* Left */
+			return (blank % N != 0) ? blank - 1 : -1;
+		default:
+			/* Right */
+			return (blank % N != N - 1) ? blank + 1 : -1;
+	}
+}
+
+/*
+ * Function:  encode_record 
+ * --------------------
+ * Write a board of solve_on_disk as a record: tile_bits bits per tile from the highest bit of the 
+ * first byte on, then zeros, and the move that reached it in the DISK_MOVE_BITS lowest bits of the 
+ * last byte. Comparing records byte by byte thus orders them by board first
+ *    
+ *  search: The disk search
+ *  tiles: The board, tiles[row*N + col]
+ *  move: The move that reached it, as an index into MOVE_CHARS
+ *  record: The record_length bytes receiving the record (output)
+ * 
+ *  returns: 0
+ */
+int encode_record(const DiskSearch *search, const int *tiles, int move, unsigned char *record){
+	unsigned long bits = 0;
+	int i, num_bits = 0, length = 0;
+	for (i = 0; i < search->N * search->N; i++){
+		bits = (bits << search->tile_bits) | (unsigned long) tiles[i];
+		num_bits += search->tile_bits;
+		while (num_bits >= 8){
+			num_bits -= 8;
+			record[length] = (unsigned char) (bits >> num_bits);
+			length++;
+		}
+	}
+	if (num_bits > 0){
+		record[length] = (unsigned char) (bits << (8 - num_bits));
+		length++;
+	}
+	while (length < search->record_length){
+		record[length] = 0;
+		length++;
+	}
+	record[search->record_length - 1] |= (unsigned char) move;
+	return 0;
+}
+
+/*
+ * Function:  decode_record 
+ * --------------------
+ * Read the board of a record written by encode_record
+ *    
+ *  search: The disk search
+ *  record: The record
+ *  tiles: The array of size N*N receiving the board (output)
+ * 
+ *  returns: the move that reached the board
+ */
+int decode_record(const DiskSearch *search, const unsigned char *record, int *tiles){
+	unsigned long bits = 0;
+	int i, num_bits = 0, length = 0;
+	for (i = 0; i < search->N * search->N; i++){
+		while (num_bits < search->tile_bits){
+			bits = (bits << 8) | record[length];
+			num_bits += 8;
+			length++;
+		}
+		num_bits -= search->tile_bits;
+		tiles[i] = (int) ((bits >> num_bits) & ((1UL << search->tile_bits) - 1));
+	}
+	return record[search->record_length - 1] & ((1 << DISK_MOVE_BITS) - 1);
+}
+
+/*
+ * Function:  compare_records 
+ * --------------------
+ * Compare the boards of two records, whatever the moves that reached them
+ *    
+ *  record_1: The first record
+ *  record_2: The second record
+ *  record_length: Bytes per record
+ * 
+ *  returns: less than, equal to or greater than 0 as the first board comes before, is the same as 
+ *           or comes after the second
+ */
+int compare_records(const unsigned char *record_1, const unsigned char *record_2, int record_length){
+	int comparison = memcmp(record_1, record_2, (size_t) (record_length - 1));
+	if (comparison != 0){
+		return comparison;
+	}
+	return (record_1[record_length - 1] >> DISK_MOVE_BITS) - (record_2[record_length - 1] >> DISK_MOVE_BITS);
+}
+
+/*
+ * Function:  sort_records 
+ * --------------------
+ * Sort records by board: insertion sort on blocks of SORT_BLOCK_SIZE records, then merge sort 
+ * from one array to the other and back
+ *    
+ *  records: The records
+ *  temp: An array as large
+ *  num_records: Number of records
+ *  record_length: Bytes per record
+ * 
+ *  returns: whichever of records and temp holds the sorted records
+ */
+unsigned char* sort_records(unsigned char *records, unsigned char *temp, long num_records, int record_length){
+	unsigned char *from = records;
+	unsigned char *to = temp;
+	unsigned char *swap;
+	size_t length = (size_t) record_length;
+	long width, left, middle, right, i, j, k;
+	
+	for (left = 0; left < num_records; left += SORT_BLOCK_SIZE){
+		right = (left + SORT_BLOCK_SIZE < num_records) ? left + SORT_BLOCK_SIZE : num_records;
+		for (i = left + 1; i < right; i++){
+			memcpy(to, from + i * length, length);
+			for (j = i; (j > left) && (compare_records(from + (j - 1) * length, to, record_length) > 0); j--){
+				memcpy(from + j * length, from + (j - 1) * length, length);
+			}
+			memcpy(from + j * length, to, length);
+		}
+	}
+	for (width = SORT_BLOCK_SIZE; width < num_records; width *= 2){
+		for (left = 0; left < num_records; left += 2 * width){
+			middle = (left + width < num_records) ? left + width : num_records;
+			right = (left + 2 * width < num_records) ? left + 2 * width : num_records;
+			i = left;
+			j = middle;
+			for (k = left; (i < middle) && (j < right); k++){
+				if (compare_records(from + i * length, from + j * length, record_length) <= 0){
+					memcpy(to + k * length, from + i * length, length);
+					i++;
+				} else {
+					memcpy(to + k * length, from + j * length, length);
+					j++;
+				}
+			}
+			memcpy(to + k * length, from + i * length, (size_t) (middle - i) * length);
+			k += middle - i;
+			memcpy(to + k * length, from + j * length, (size_t) (right - j) * length);
+		}
+		swap = from;
+		from = to;
+		to = swap;
+	}
+	return from;
+}
+
+/*
+ * Function:  disk_file_name 
+ * --------------------
+ * Build the name of a file of solve_on_disk, unique to the process and the search
+ *    
+ *  search: The disk search
+ *  kind: "layer" or "run"
+ *  number: Number of the layer or run
+ * 
+ *  returns: the name, in search->file_name until the next call
+ */
+const char* disk_file_name(DiskSearch *search, const char *kind, int number){
+	sprintf(search->file_name, "%s/npuzzle-%ld-%d-%s-%d.tmp", search->directory, (long) getpid(), search->id, 
+		kind, number);
+	return (const char *) search->file_name;
+}
+
+/*
+ * Function:  open_disk_file 
+ * --------------------
+ * Open a file of solve_on_disk, with a buffer of io_buffer_size bytes
+ *    
+ *  search: The disk search
+ *  file: The file (output)
+ *  kind: "layer" or "run"
+ *  number: Number of the layer or run
+ *  mode: Mode for fopen
+ * 
+ *  returns: 0, or -1 if it cannot be opened or there is not enough memory
+ */
+int open_disk_file(DiskSearch *search, DiskFile *file, const char *kind, int number, const char *mode){
+	const char *file_name = disk_file_name(search, kind, number);
+	file->fid = NULL;
+	file->buffer = (char *) malloc(search->io_buffer_size);
+	if (file->buffer == NULL){
+		printf("Out of memory! \n");
+		return -1;
+	}
+	file->fid = fopen(file_name, mode);
+	if (file->fid == NULL){
+		printf("Cannot open %s \n", file_name);
+		free(file->buffer);
+		file->buffer = NULL;
+		return -1;
+	}
+	setvbuf(file->fid, file->buffer, _IOFBF, search->io_buffer_size);
+	return 0;
+}
+
+/*
+ * Function:  close_disk_file 
+ * --------------------
+ * Close a file opened by open_disk_file, if it is open, and free its buffer
+ *    
+ *  search: The disk search
+ *  file: The file
+ * 
+ *  returns: 0, or -1 if reading or writing it failed at some point
+ */
+int close_disk_file(const DiskSearch *search, DiskFile *file){
+	int status = 0;
+	if (file->fid != NULL){
+		status = ferror(file->fid) ? -1 : 0;
+		if (fclose(file->fid) != 0){
+			status = -1;
+		}
+		if (status != 0){
+			printf("Input/output error in %s! \n", search->directory);
+		}
+	}
+	free(file->buffer);
+	file->fid = NULL;
+	file->buffer = NULL;
+	return status;
+}
+
+/*
+ * Function:  write_run 
+ * --------------------
+ * Sort the children waiting in memory and write them to the next run file, each board once
+ *    
+ *  search: The disk search
+ * 
+ *  returns: 0, or -1 if the run cannot be written
+ */
+int write_run(DiskSearch *search){
+	DiskFile run;
+	unsigned char *records;
+	unsigned char *last = NULL;
+	size_t length = (size_t) search->record_length;
+	long i;
+	if (search->num_sorted == 0){
+		return 0;
+	}
+	records = sort_records(search->sorted, search->temp, search->num_sorted, search->record_length);
+	if (open_disk_file(search, &run, "run", search->next_run, "wb") != 0){
+		return -1;
+	}
+	search->next_run++;
+	for (i = 0; i < search->num_sorted; i++){
+		if ((last == NULL) || (compare_records(last, records + i * length, search->record_length) != 0)){
+			last = records + i * length;
+			fwrite(last, length, 1, run.fid);
+			search->num_written++;
+		}
+	}
+	search->num_sorted = 0;
+	return close_disk_file(search, &run);
+}
+
+/*
+ * Function:  merge_runs 
+ * --------------------
+ * Merge sorted runs into one sorted file, each board once, and delete them. The boards of 
+ * another sorted file are left out as well
+ *    
+ *  search: The disk search
+ *  first: The first run
+ *  last: One past the last run, at most MAX_MERGE_WAYS after the first
+ *  output: The file receiving the records
+ *  previous: The file of boards to leave out, or NULL
+ *  num_records: Set to the number of records written
+ * 
+ *  returns: 0, or -1 if a run cannot be read or the output written
+ */
+int merge_runs(DiskSearch *search, int first, int last, DiskFile *output, DiskFile *previous, long *num_records){
+	DiskFile runs[MAX_MERGE_WAYS];
+	int left[MAX_MERGE_WAYS]; /* 1 while the run has records left */
+	unsigned char *heads; /* The next record of each run */
+	unsigned char *newest; /* The board written last */
+	unsigned char *removed; /* The next record of previous */
+	size_t length = (size_t) search->record_length;
+	int num_runs = last - first;
+	int i, best, has_newest = 0, has_removed = 0;
+	int status = -1;
+	
+	*num_records = 0;
+	for (i = 0; i < num_runs; i++){
+		runs[i].fid = NULL;
+		runs[i].buffer = NULL;
+	}
+	heads = (unsigned char *) malloc(length * (num_runs + 2));
+	if (heads == NULL){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	newest = heads + num_runs * length;
+	removed = newest + length;
+	for (i = 0; i < num_runs; i++){
+		if (open_disk_file(search, &runs[i], "run", first + i, "rb") != 0){
+			goto CLEANUP;
+		}
+		left[i] = (fread(heads + i * length, length, 1, runs[i].fid) == 1);
+	}
+	if (previous != NULL){
+		has_removed = (fread(removed, length, 1, previous->fid) == 1);
+	}
+	
+	while (1){
+		/* The smallest head, there are only a few runs to look through */
+		best = -1;
+		for (i = 0; i < num_runs; i++){
+			if (left[i] && ((best < 0) 
+				|| (compare_records(heads + i * length, heads + best * length, search->record_length) < 0))){
+				best = i;
+			}
+		}
+		if (best < 0){
+			break;
+		}
+		if (!has_newest || (compare_records(heads + best * length, newest, search->record_length) != 0)){
+			memcpy(newest, heads + best * length, length);
+			has_newest = 1;
+			while (has_removed && (compare_records(removed, newest, search->record_length) < 0)){
+				has_removed = (fread(removed, length, 1, previous->fid) == 1);
+			}
+			if (!has_removed || (compare_records(removed, newest, search->record_length) != 0)){
+				fwrite(newest, length, 1, output->fid);
+				(*num_records)++;
+			}
+		}
+		left[best] = (fread(heads + best * length, length, 1, runs[best].fid) == 1);
+	}
+	search->num_written += *num_records;
+	status = 0;
+	
+	CLEANUP: {
+		for (i = 0; i < num_runs; i++){
+			if (close_disk_file(search, &runs[i]) != 0){
+				status = -1;
+			}
+			remove(disk_file_name(search, "run", first + i));
+		}
+		free(heads);
+		return status;
+	}
+}
+
+/*
+ * Function:  find_record 
+ * --------------------
+ * Look a board up in a layer file by binary search. This reads a handful of records, 
+ * so it goes without a buffer
+ *    
+ *  search: The disk search
+ *  layer: The layer
+ *  record: The board to look up, replaced by its record in the layer if it is there
+ * 
+ *  returns: 0 if it was found, 1 if not, -1 if the layer cannot be read
+ */
+int find_record(DiskSearch *search, int layer, unsigned char *record){
+	FILE *fid;
+	unsigned char *middle;
+	size_t length = (size_t) search->record_length;
+	long low = 0, high, i;
+	int comparison, status = -1;
+	
+	middle = (unsigned char *) malloc(length);
+	fid = fopen(disk_file_name(search, "layer", layer), "rb");
+	if ((middle == NULL) || (fid == NULL) || (setvbuf(fid, NULL, _IONBF, 0) != 0) || (fseek(fid, 0, SEEK_END) != 0)){
+		goto CLEANUP;
+	}
+	high = ftell(fid) / (long) length;
+	status = 1;
+	while (low < high){
+		i = low + (high - low) / 2;
+		if ((fseek(fid, i * (long) length, SEEK_SET) != 0) || (fread(middle, length, 1, fid) != 1)){
+			status = -1;
+			break;
+		}
+		comparison = compare_records(middle, record, search->record_length);
+		if (comparison == 0){
+			memcpy(record, middle, length);
+			status = 0;
+			break;
+		} else if (comparison < 0){
+			low = i + 1;
+		} else {
+			high = i;
+		}
+	}
+	
+	CLEANUP: {
+		if (status < 0){
+			printf("Cannot read %s \n", search->file_name);
+		}
+		if (fid != NULL){
+			fclose(fid);
+		}
+		free(middle);
+		return status;
+	}
+}
+
+/*
+ * Function:  solve_on_disk 
+ * --------------------
+ * Solve one instance with breadth-first iterative-deepening A* (BFIDA*, Zhou and Hansen 2004), 
+ * keeping its layers on disk with delayed duplicate detection (Korf 2004). Each iteration 
+ * searches breadth-first from the start, leaving out the children whose f-score is over the 
+ * threshold, and the next one raises the threshold to the lowest f-score left out, so the first 
+ * layer where the goal shows up gives an optimal solution. Layer g is a file of the boards 
+ * first reached after g moves, sorted. Its children are gathered in memory, written as sorted 
+ * runs whenever the sort buffer fills up, and merged into layer g+1: the copies of a board come 
+ * together and only one is kept, and the boards of layer g-1 are dropped as they go by. Every 
+ * move can be undone and changes the parity of the position of 'x', so these are the only 
+ * boards seen before that a child can be. Apart from looking up the parents of the solution at 
+ * the end, every file is read and written in order. The layers of an iteration stay on disk 
+ * until the next one, to trace the solution back through them
+ *    
+ *  start: The starting board
+ *  goal: The goal
+ *  N: width and height of the board 
+ *  heuristic: The heuristic for the goal, only read, so it can be shared between threads
+ *  options: The directory and the sizes of the buffers
+ *  id: A number not used by another search running at the same time, for the names of the files
+ *  desc: Set to the moves of the solution, starting with 'B', to be freed by the caller
+ *  num_expanded: Set to the number of boards expanded, again counted in every iteration
+ *  num_generated: Set to the number of children within the threshold, before duplicates are dropped
+ *  megabytes_written: Set to the size of the runs and layers written
+ * 
+ *  returns: 0 if a solution was found, 1 if every board was searched, -1 if out of memory or 
+ *           the disk failed
+ */
+int solve_on_disk(const int** start, const int ** goal, int N, const Heuristic *heuristic, const Options *options, 
+	int id, char **desc, long *num_expanded, long *num_generated, double *megabytes_written){
+	DiskSearch search;
+	DiskFile layer, output, previous;
+	unsigned char *record = NULL;
+	unsigned char *goal_record;
+	int *tiles = NULL;
+	size_t length;
+	long num_records;
+	int i, g_score, f_score, threshold, next_threshold;
+	int move, go_back_move, blank, new_blank;
+	int wd_rows, wd_cols;
+	int status = -1;
+#ifdef NPUZZLE_STATS
+	long num_evaluations = 1;
+	struct timespec start_time;
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+#endif
+	
+	*desc = NULL;
+	*num_expanded = 0;
+	*num_generated = 1;
+	search.directory = options->disk_directory;
+	search.id = id;
+	search.N = N;
+	for (search.tile_bits = 1; (1 << search.tile_bits) < N * N; search.tile_bits++){
+		/* Enough bits for the tiles 0 to N*N-1 */
+	}
+	search.record_length = (N * N * search.tile_bits + DISK_MOVE_BITS + 7) / 8;
+	length = (size_t) search.record_length;
+	search.io_buffer_size = (size_t) options->io_buffer_kilobytes << 10;
+	search.sort_capacity = (options->sort_megabytes << 20) / (2 * (long) length);
+	search.num_sorted = 0;
+	search.first_run = 0;
+	search.next_run = 0;
+	search.num_layers = 0;
+	search.num_written = 0;
+	layer.fid = NULL;
+	layer.buffer = NULL;
+	output.fid = NULL;
+	output.buffer = NULL;
+	previous.fid = NULL;
+	previous.buffer = NULL;
+	search.file_name = (char *) malloc(strlen(search.directory) + 64);
+	search.sorted = (unsigned char *) malloc(length * search.sort_capacity);
+	search.temp = (unsigned char *) malloc(length * search.sort_capacity);
+	record = (unsigned char *) malloc(2 * length);
+	tiles = (int *) calloc((size_t) (N * N), sizeof(int));
+	if ((search.file_name == NULL) || (search.sorted == NULL) || (search.temp == NULL) || (record == NULL) 
+		|| (tiles == NULL)){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	goal_record = record + length;
+	for (i = 0; i < N; i++){
+		memcpy(&tiles[i*N], goal[i], sizeof(int) * N);
+	}
+	encode_record(&search, (const int *) tiles, 0, goal_record);
+	
+	/* Layer 0 is the start */
+	for (i = 0; i < N; i++){
+		memcpy(&tiles[i*N], start[i], sizeof(int) * N);
+	}
+	threshold = heuristic_value(heuristic, (const int *) tiles, &wd_rows, &wd_cols);
+	encode_record(&search, (const int *) tiles, 0, record);
+	if (open_disk_file(&search, &output, "layer", 0, "wb") != 0){
+		goto CLEANUP;
+	}
+	search.num_layers = 1;
+	fwrite(record, length, 1, output.fid);
+	search.num_written++;
+	if (close_disk_file(&search, &output) != 0){
+		goto CLEANUP;
+	}
+	
+	while (1){
+		next_threshold = INT_MAX;
+		for (g_score = 0; ; g_score++){
+			/* Expand layer g_score into runs */
+			if (open_disk_file(&search, &layer, "layer", g_score, "rb") != 0){
+				goto CLEANUP;
+			}
+			while (fread(record, length, 1, layer.fid) == 1){
+				if (compare_records(record, goal_record, search.record_length) == 0){
+					goto FOUND;
+				}
+				(*num_expanded)++;
+				move = decode_record(&search, record, tiles);
+				go_back_move = (g_score > 0) ? (move ^ 1) : -1;
+				for (blank = 0; tiles[blank] != 0; blank++){
+					/* Find 'x' */
+				}
+				for (i = 0; i < NUM_OF_MOVES; i++){
+					new_blank = move_blank(blank, i, N);
+					if ((new_blank < 0) || (i == go_back_move)){
+						continue;
+					}
+					tiles[blank] = tiles[new_blank];
+					tiles[new_blank] = 0;
+					STATS_COUNT(num_evaluations);
+					f_score = g_score + 1 + heuristic_value(heuristic, (const int *) tiles, &wd_rows, &wd_cols);
+					if (f_score <= threshold){
+						if ((search.num_sorted == search.sort_capacity) && (write_run(&search) != 0)){
+							goto CLEANUP;
+						}
+						encode_record(&search, (const int *) tiles, i, search.sorted + search.num_sorted * length);
+						search.num_sorted++;
+						(*num_generated)++;
+					} else if (f_score < next_threshold){
+						next_threshold = f_score;
+					}
+					tiles[new_blank] = tiles[blank];
+					tiles[blank] = 0;
+				}
+			}
+			if ((close_disk_file(&search, &layer) != 0) || (write_run(&search) != 0)){
+				goto CLEANUP;
+			}
+			
+			/* Merge the runs MAX_MERGE_WAYS at a time, until they all go into layer g_score+1 at once */
+			while (search.next_run - search.first_run > MAX_MERGE_WAYS){
+				if (open_disk_file(&search, &output, "run", search.next_run, "wb") != 0){
+					goto CLEANUP;
+				}
+				search.next_run++;
+				if ((merge_runs(&search, search.first_run, search.first_run + MAX_MERGE_WAYS, &output, NULL, 
+					&num_records) != 0) || (close_disk_file(&search, &output) != 0)){
+					goto CLEANUP;
+				}
+				search.first_run += MAX_MERGE_WAYS;
+			}
+			if (open_disk_file(&search, &output, "layer", g_score + 1, "wb") != 0){
+				goto CLEANUP;
+			}
+			search.num_layers++;
+			if ((g_score > 0) && (open_disk_file(&search, &previous, "layer", g_score - 1, "rb") != 0)){
+				goto CLEANUP;
+			}
+			if (merge_runs(&search, search.first_run, search.next_run, &output, (g_score > 0) ? &previous : NULL, 
+				&num_records) != 0){
+				goto CLEANUP;
+			}
+			search.first_run = search.next_run;
+			if ((close_disk_file(&search, &output) != 0) || (close_disk_file(&search, &previous) != 0)){
+				goto CLEANUP;
+			}
+			if (num_records == 0){
+				break;
+			}
+		}
+		if (next_threshold == INT_MAX){
+			/* Nothing was left out, and the goal was not reached */
+			status = 1;
+			goto CLEANUP;
+		}
+		
+		/* Search again from the start with the next threshold */
+		for (i = 1; i < search.num_layers; i++){
+			remove(disk_file_name(&search, "layer", i));
+		}
+		search.num_layers = 1;
+		threshold = next_threshold;
+	}
+	
+	FOUND: {
+		/* Each board was reached from a board of the layer before by the move in its record */
+		*desc = (char *) malloc(sizeof(char) * (g_score + 2));
+		if (*desc == NULL){
+			printf("Out of memory! \n");
+			goto CLEANUP;
+		}
+		(*desc)[0] = 'B';
+		(*desc)[g_score + 1] = '\0';
+		for (; g_score > 0; g_score--){
+			move = decode_record(&search, record, tiles);
+			(*desc)[g_score] = MOVE_CHARS[move];
+			for (blank = 0; tiles[blank] != 0; blank++){
+				/* Find 'x' */
+			}
+			new_blank = move_blank(blank, move ^ 1, N);
+			tiles[blank] = tiles[new_blank];
+			tiles[new_blank] = 0;
+			encode_record(&search, (const int *) tiles, 0, record);
+			status = find_record(&search, g_score - 1, record);
+			if (status != 0){
+				if (status > 0){
+					printf("A board is missing from layer %d! \n", g_score - 1);
+				}
+				status = -1;
+				free(*desc);
+				*desc = NULL;
+				goto CLEANUP;
+			}
+		}
+		status = 0;
+	}
+	
+	CLEANUP: {
+		close_disk_file(&search, &layer);
+		close_disk_file(&search, &output);
+		close_disk_file(&search, &previous);
+		if (search.file_name != NULL){
+			for (i = search.first_run; i < search.next_run; i++){
+				remove(disk_file_name(&search, "run", i));
+			}
+			for (i = 0; i < search.num_layers; i++){
+				remove(disk_file_name(&search, "layer", i));
+			}
+		}
+		*megabytes_written = (double) search.num_written * (double) length / (double) (1 << 20);
+#ifdef NPUZZLE_STATS
+		record_search(1, *num_expanded, *num_generated, num_evaluations, NULL, 0, seconds_since(&start_time));
+#endif
+		free(search.file_name);
+		free(search.sorted);
+		free(search.temp);
+		free(record);
+		free(tiles);
+		return status;
+	}
+}
+
+/*
+ * Function:  run 
+ * --------------------
+ * Run (N^2-1) solver using A-star algorithm
+ *    
+ *  start: The starting board
+ *  goal: The goal
+ *  N: width and height of the board 
+ *  options: Options from the command line
+ * 
+ *  returns: 0 if a solution was found, EXIT_UNSOLVABLE if the goal cannot be reached from the start, 
+ *           1 otherwise (the heuristic is not available for this board, no solution fits in the 
+ *           memory given, or the search ran out of memory)
+ */
+int run(const int** start, const int ** goal, int N, const Options *options){
+	int *goal_cols, *goal_rows; /* Position of each element */
+	int i,j;
+	int N_squared;
+	Heuristic heuristic;
+	char *desc;	
+	int status;
+	long num_expanded, num_generated, num_reopened, num_evicted;
+	double megabytes_written;
+	int meeting;
+	
+	if (is_solvable(start, goal, N) == 0){
+		printf("UNSOLVABLE! The goal cannot be reached from the start \n");
+		return EXIT_UNSOLVABLE;
+	}
+	
+	/* Precompute positions for goal */
+	N_squared = N*N;
+    goal_cols = (int *) malloc(sizeof(int) * N_squared);
+    goal_rows = (int *) malloc(sizeof(int) * N_squared);
+	for (i = 0; i < N; i++){		
+		for (j = 0; j < N; j++){
+			goal_rows[goal[i][j]] = i;
+			goal_cols[goal[i][j]] = j;
+		}		
+	}
+	if (new_heuristic(&heuristic, options->heuristic, (const int *) goal_rows, (const int *) goal_cols, N) != 0){
+		printf("This heuristic is not available for a %dx%d board! \n", N, N);
+		free(goal_cols);
+		free(goal_rows);
+		return 1;
+	}
+	if (options->disk_directory != NULL){
+		status = solve_on_disk(start, goal, N, (const Heuristic *) &heuristic, options, 0, &desc, &num_expanded, 
+			&num_generated, &megabytes_written);
+		if (status == 0){
+			print_solution(start, N, (const char *) desc);
+			printf("States expanded: %ld, generated: %ld, written to disk: %.1f MB \n", num_expanded, num_generated, 
+				megabytes_written);
+		} else if (status == 1){
+			printf("Every board was searched already! Something must be wrong! \n");
+		}
+		free(desc);
+	} else if (options->memory_megabytes > 0){
+		status = solve_bounded(start, goal, N, (const Heuristic *) &heuristic, options->memory_megabytes, &desc, 
+			&num_expanded, &num_generated, &num_evicted);
+		if (status == 0){
+			print_solution(start, N, (const char *) desc);
+			printf("States expanded: %ld, generated: %ld, evicted: %ld \n", num_expanded, num_generated, num_evicted);
+		} else if (status == 1){
+			printf("No solution fits in %ld MB! \n", options->memory_megabytes);
+		}
+		free(desc);
+	} else if (options->bidirectional){
+		status = solve_bidirectional(start, goal, N, (const Heuristic *) &heuristic, options->open_list, &desc, 
+			&meeting, &num_expanded, &num_generated, &num_reopened);
+		if (status == 0){
+			print_solution(start, N, (const char *) desc);
+			printf("Meeting point: after move %d of %d \n", meeting, (int) strlen(desc) - 1);
+			printf("States expanded: %ld, generated: %ld, reopened: %ld \n", num_expanded, num_generated, num_reopened);
+		} else if (status == 1){
+			printf("The heap is empty already! Something must be wrong! \n");
+		}
+		free(desc);
+	} else if (options->num_threads > 1){
+		status = run_parallel(start, goal, N, (const Heuristic *) &heuristic, options);
+	} else {
+		status = solve(start, goal, N, (const Heuristic *) &heuristic, options->open_list, &desc, 
+			&num_expanded, &num_generated, &num_reopened);
+		if (status == 0){
+			print_solution(start, N, (const char *) desc);
+			printf("States expanded: %ld, generated: %ld, reopened: %ld \n", num_expanded, num_generated, num_reopened);
+		} else if (status == 1){
+			printf("The heap is empty already! Something must be wrong! \n");
+		}
+		free(desc);
+	}
+	free_heuristic(&heuristic);
+	free(goal_cols);
+	free(goal_rows);
+	return (status == 0) ? 0 : 1;
+}
+
+/*
+ * Function:  read_instance 
+ * --------------------
+ * Read the next instance of a batch file: N, the start and the goal, as in temp.txt. 
+ * Blank lines and the "--------------" lines between instances are skipped
+ *    
+ *  fid: The batch file
+ *  N: Set to the width and height of the board 
+ *  start: Set to the starting board, to be freed by the caller
+ *  goal: Set to the goal, to be freed by the caller
+ * 
+ *  returns: 1 if an instance was read, 0 at the end of the file, -1 if the instance is malformed
+ */
+int read_instance(FILE *fid, int *N, int ***start, int ***goal){
+	char seen[MAX_LINE_LENGTH * MAX_LINE_LENGTH];
+	int **board;
+	int c, i, j, k;
+	
+	do {
+		c = fgetc(fid);
+	} while ((c != EOF) && (isspace(c) || (c == '-')));
+	if (c == EOF){
+		return 0;
+	}
+	ungetc(c, fid);
+	if ((fscanf(fid, "%d", N) != 1) || (*N < 2) || (*N > MAX_LINE_LENGTH)){
+		return -1;
+	}
+	*start = new_board(*N);
+	*goal = new_board(*N);
+	for (k = 0; k < 2; k++){
+		board = (k == 0) ? *start : *goal;
+		memset(seen, 0, sizeof(seen));
+		for (i = 0; i < *N; i++){
+			for (j = 0; j < *N; j++){
+				/* Every tile from 0 to N*N - 1 exactly once */
+				if ((fscanf(fid, "%d", &board[i][j]) != 1) || (board[i][j] < 0) || (board[i][j] >= (*N) * (*N)) 
+					|| seen[board[i][j]]){
+					free_board(*start, *N);
+					free_board(*goal, *N);
+					return -1;
+				}
+				seen[board[i][j]] = 1;
+			}
+		}
+	}
+	return 1;
+}
+
+/*
+ * Function:  goal_table 
+ * --------------------
+ * Find the goal table of a batch for this goal, or set one up. Called with the lock of the batch held
+ *    
+ *  batch: The batch
+ *  goal: The goal
+ *  N: width and height of the board 
+ * 
+ *  returns: The goal table, with ready set to 0 if the heuristic is not available for it, 
+ *           or NULL if out of memory
+ */
+GoalTable* goal_table(BatchSearch *batch, const int **goal, int N){
+	GoalTable *table;
+	int i, j;
+	struct timespec start_time;
+	
+	for (table = batch->goal_tables; table != NULL; table = table->next){
+		for (i = 0; i < N*N; i++){
+			if ((table->N != N) || (goal[table->goal_rows[i]][table->goal_cols[i]] != i)){
+				break;
+			}
+		}
+		if (i == N*N){
+			return table;
+		}
+	}
+	
+	table = (GoalTable *) malloc(sizeof(GoalTable));
+	if (table == NULL){
+		printf("Out of memory! \n");
+		return NULL;
+	}
+	table->N = N;
+	table->goal_rows = (int *) malloc(sizeof(int) * N * N);
+	table->goal_cols = (int *) malloc(sizeof(int) * N * N);
+	if ((table->goal_rows == NULL) || (table->goal_cols == NULL)){
+		free(table->goal_rows);
+		free(table->goal_cols);
+		free(table);
+		printf("Out of memory! \n");
+		return NULL;
+	}
+	for (i = 0; i < N; i++){		
+		for (j = 0; j < N; j++){
+			table->goal_rows[goal[i][j]] = i;
+			table->goal_cols[goal[i][j]] = j;
+		}		
+	}	
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+	table->ready = (new_heuristic(&table->heuristic, batch->options->heuristic, (const int *) table->goal_rows, 
+		(const int *) table->goal_cols, N) == 0);
+	if (!table->ready){
+		printf("This heuristic is not available for a %dx%d board! \n", N, N);
+	} else {
+		printf("Heuristic ready in %.3f s \n", seconds_since(&start_time));
+	}
+	table->next = batch->goal_tables;
+	batch->goal_tables = table;
+	return table;
+}
+
+/*
+ * Function:  peak_rss 
+ * --------------------
+ * Peak resident set size of the process so far. In a batch it covers every instance solved up to now
+ * 
+ *  returns: the peak in kilobytes, or -1 if it is not available
+ */
+long peak_rss(void){
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0){
+		return -1;
+	}
+	return usage.ru_maxrss;
+}
+
+/*
+ * Function:  report_instance 
+ * --------------------
+ * Print the result of one instance of a batch, and write it to the CSV and JSON files if there are any. 
+ * Called with the lock of the batch held
+ *    
+ *  batch: The batch
+ *  index: Number of the instance in the batch file, from 1
+ *  N: width and height of the board 
+ *  solution: The moves of the solution, starting with 'B', or NULL if the instance was not solved
+ *  num_expanded: Number of states expanded
+ *  seconds: Time taken by the search
+ * 
+ *  returns: 0
+ */
+int report_instance(BatchSearch *batch, int index, int N, int solvable, const char *solution, long num_expanded, 
+	double seconds){
+	int length = (solution != NULL) ? (int) strlen(solution) - 1 : solvable ? -1 : -2;
+	double rate = (seconds > 0) ? num_expanded / seconds : 0.0;
+	long rss = peak_rss();
+	
+	if (solution != NULL){
+		printf("Instance %d: %dx%d, length %d, expanded %ld, %.3f s, %s \n", index, N, N, length, num_expanded, 
+			seconds, solution + 1);
+	} else if (!solvable){
+		printf("Instance %d: %dx%d, UNSOLVABLE \n", index, N, N);
+	} else {
+		printf("Instance %d: %dx%d, NOT SOLVED, expanded %ld, %.3f s \n", index, N, N, num_expanded, seconds);
+	}
+	if (batch->csv != NULL){
+		fprintf(batch->csv, "%s,%s,%d,%d,%d,%d,%ld,%.6f,%.0f,%ld\n", (batch->options->disk_directory != NULL) ? DISK_NAME 
+			: (batch->options->memory_megabytes > 0) ? BOUNDED_NAME 
+			: (batch->options->bidirectional ? BIDIRECTIONAL_NAMES : OPEN_LIST_NAMES)[batch->options->open_list], 
+			HEURISTIC_NAMES[batch->options->heuristic], batch->options->num_threads, index, N, length, num_expanded, 
+			seconds, rate, rss);
+	}
+	if (batch->json != NULL){
+		fprintf(batch->json, "%s\n    {\"instance\": %d, \"n\": %d, \"length\": %d, \"nodes_expanded\": %ld, "
+			"\"seconds\": %.6f, \"nodes_per_sec\": %.0f, \"peak_rss_kb\": %ld}", (batch->num_reported > 0) ? "," : "", 
+			index, N, length, num_expanded, seconds, rate, rss);
+	}
+	batch->num_reported++;
+	return 0;
+}
+
+/*
+ * Function:  batch_worker 
+ * --------------------
+ * Take instances from the batch file one at a time and solve them, until the file runs out
+ *    
+ *  arg: The batch
+ * 
+ *  returns: NULL
+ */
+void* batch_worker(void *arg){
+	BatchSearch *batch = (BatchSearch *) arg;
+	GoalTable *table;
+	int **start, **goal;
+	int N, index, status, solvable, meeting;
+	long num_expanded, num_generated, num_reopened;
+	double seconds, megabytes_written;
+	char *solution;
+	struct timespec start_time;
+	
+	while (1){
+		pthread_mutex_lock(&batch->lock);
+		status = batch->malformed ? 0 : read_instance(batch->fid, &N, &start, &goal);
+		if (status < 0){
+			printf("Malformed instance after instance %d! \n", batch->num_read);
+			batch->malformed = 1;
+		}
+		if (status <= 0){
+			pthread_mutex_unlock(&batch->lock);
+			return NULL;
+		}
+		batch->num_read++;
+		index = batch->num_read;
+		solvable = (is_solvable((const int **) start, (const int **) goal, N) != 0);
+		table = solvable ? goal_table(batch, (const int **) goal, N) : NULL;
+		pthread_mutex_unlock(&batch->lock);
+		
+		solution = NULL;
+		num_expanded = 0;
+		status = -1;
+		clock_gettime(CLOCK_MONOTONIC, &start_time);
+		if ((table != NULL) && table->ready && (batch->options->disk_directory != NULL)){
+			status = solve_on_disk((const int **) start, (const int **) goal, N, (const Heuristic *) &table->heuristic, 
+				batch->options, index, &solution, &num_expanded, &num_generated, &megabytes_written);
+		} else if ((table != NULL) && table->ready && (batch->options->memory_megabytes > 0)){
+			status = solve_bounded((const int **) start, (const int **) goal, N, (const Heuristic *) &table->heuristic, 
+				batch->options->memory_megabytes, &solution, &num_expanded, &num_generated, &num_reopened);
+		} else if ((table != NULL) && table->ready && batch->options->bidirectional){
+			status = solve_bidirectional((const int **) start, (const int **) goal, N, 
+				(const Heuristic *) &table->heuristic, batch->options->open_list, &solution, &meeting, 
+				&num_expanded, &num_generated, &num_reopened);
+		} else if ((table != NULL) && table->ready){
+			status = solve((const int **) start, (const int **) goal, N, (const Heuristic *) &table->heuristic, 
+				batch->options->open_list, &solution, &num_expanded, &num_generated, &num_reopened);
+		}
+		seconds = seconds_since(&start_time);
+		
+		pthread_mutex_lock(&batch->lock);
+		report_instance(batch, index, N, solvable, (status == 0) ? (const char *) solution : NULL, num_expanded, seconds);
+		if (status == 0){
+			batch->num_solved++;
+		} else if (!solvable){
+			batch->num_unsolvable++;
+		}
+		batch->num_expanded += num_expanded;
+		pthread_mutex_unlock(&batch->lock);
+		free(solution);
+		free_board(start, N);
+		free_board(goal, N);
+	}
+}
+
+/*
+ * Function:  run_batch 
+ * --------------------
+ * Solve every instance of a batch file, in the format of temp.txt. The heuristic of each 
+ * distinct goal is set up once and shared by all the instances with that goal. With several 
+ * threads, each thread solves whole instances, so the results come out in the order they finish. 
+ * A solution length of -1 in the CSV and JSON files means the instance was not solved, and -2 
+ * that its goal cannot be reached from its start (see is_solvable), which is found without searching
+ *    
+ *  file_name: The batch file
+ *  options: Options from the command line
+ * 
+ *  returns: 0 if every instance was read and solved, EXIT_UNSOLVABLE if the only ones not solved 
+ *           cannot be, 1 otherwise
+ */
+int run_batch(const char *file_name, const Options *options){
+	BatchSearch batch;
+	GoalTable *table;
+	pthread_t threads[MAX_THREADS];
+	int i, num_started, num_goals = 0, status = 1;
+	double seconds;
+	struct timespec start_time;
+	
+	batch.fid = fopen(file_name, "rt");
+	if (batch.fid == NULL){
+		printf("Cannot open %s \n", file_name);
+		return 1;
+	}
+	if (pthread_mutex_init(&batch.lock, NULL) != 0){
+		fclose(batch.fid);
+		printf("Out of memory! \n");
+		return 1;
+	}
+	batch.options = options;
+	batch.num_read = 0;
+	batch.malformed = 0;
+	batch.goal_tables = NULL;
+	batch.num_solved = 0;
+	batch.num_unsolvable = 0;
+	batch.num_expanded = 0;
+	batch.csv = NULL;
+	batch.json = NULL;
+	batch.num_reported = 0;
+	if (options->csv_file != NULL){
+		batch.csv = fopen(options->csv_file, "w");
+		if (batch.csv == NULL){
+			printf("Cannot write %s \n", options->csv_file);
+			goto CLEANUP;
+		}
+		fprintf(batch.csv, "solver,heuristic,threads,instance,n,length,nodes_expanded,seconds,nodes_per_sec,peak_rss_kb\n");
+	}
+	if (options->json_file != NULL){
+		batch.json = fopen(options->json_file, "w");
+		if (batch.json == NULL){
+			printf("Cannot write %s \n", options->json_file);
+			goto CLEANUP;
+		}
+		fprintf(batch.json, "{\n  \"solver\": \"%s\",\n  \"heuristic\": \"%s\",\n  \"threads\": %d,\n  \"instances\": [", 
+			(options->bidirectional ? BIDIRECTIONAL_NAMES : OPEN_LIST_NAMES)[options->open_list], 
+			HEURISTIC_NAMES[options->heuristic], options->num_threads);
+	}
+	
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+	for (num_started = 1; num_started < options->num_threads; num_started++){
+		if (pthread_create(&threads[num_started], NULL, batch_worker, &batch) != 0){
+			break;
+		}
+	}
+	batch_worker(&batch);
+	for (i = 1; i < num_started; i++){
+		pthread_join(threads[i], NULL);
+	}
+	seconds = seconds_since(&start_time);
+	
+	while (batch.goal_tables != NULL){
+		table = batch.goal_tables;
+		batch.goal_tables = table->next;
+		if (table->ready){
+			free_heuristic(&table->heuristic);
+		}
+		free(table->goal_rows);
+		free(table->goal_cols);
+		free(table);
+		num_goals++;
+	}
+	printf("Solved %d of %d instances (%d unsolvable, %d goals) with %d threads in %.3f s, %.2f instances/s \n", 
+		batch.num_solved, batch.num_read, batch.num_unsolvable, num_goals, num_started, seconds, 
+		(seconds > 0) ? batch.num_solved / seconds : 0.0);
+	printf("States expanded: %ld, %.0f states/s, peak RSS %ld kB \n", batch.num_expanded, 
+		(seconds > 0) ? batch.num_expanded / seconds : 0.0, peak_rss());
+	if (batch.json != NULL){
+		fprintf(batch.json, "\n  ],\n  \"summary\": {\"instances\": %d, \"solved\": %d, \"unsolvable\": %d, \"goals\": %d, \"seconds\": %.6f, "
+			"\"instances_per_sec\": %.3f, \"nodes_expanded\": %ld, \"nodes_per_sec\": %.0f, \"peak_rss_kb\": %ld}\n}\n", 
+			batch.num_read, batch.num_solved, batch.num_unsolvable, num_goals, seconds, (seconds > 0) ? batch.num_solved / seconds : 0.0, 
+			batch.num_expanded, (seconds > 0) ? batch.num_expanded / seconds : 0.0, peak_rss());
+	}
+	status = (batch.malformed || (batch.num_solved + batch.num_unsolvable < batch.num_read)) ? 1 
+		: (batch.num_unsolvable > 0) ? EXIT_UNSOLVABLE : 0;
+	
+	CLEANUP: {
+		if (batch.csv != NULL){
+			fclose(batch.csv);
+		}
+		if (batch.json != NULL){
+			fclose(batch.json);
+		}
+		pthread_mutex_destroy(&batch.lock);
+		fclose(batch.fid);
+		return status;
+	}
+}
+
+#ifdef NPUZZLE_STATS
+/*
+ * Function:  record_search 
+ * --------------------
+ * Keep the counters of one search for the report on exit
+ *    
+ *  num_threads: Number of threads of the search
+ *  num_expanded: States expanded
+ *  num_generated: States generated
+ *  num_evaluations: Heuristic evaluations
+ *  open: The open list of each thread, with their counters
+ *  num_open: Number of open lists
+ *  seconds: Time taken by the search
+ * 
+ *  returns: 0, or -1 if out of memory
+ */
+int record_search(int num_threads, long num_expanded, long num_generated, long num_evaluations, 
+	const OpenList *open, int num_open, double seconds){
+	SearchStats *searches;
+	SearchStats *record;
+	int i, status = 0;
+	pthread_mutex_lock(&statistics.lock);
+	statistics.num_searches++;
+	if (statistics.num_recorded == statistics.capacity){
+		statistics.capacity = (statistics.capacity == 0) ? INITIAL_STATS_CAPACITY : statistics.capacity * 2;
+		searches = (SearchStats *) realloc(statistics.searches, sizeof(SearchStats) * statistics.capacity);
+		if (searches == NULL){
+			statistics.capacity = statistics.num_recorded;
+			status = -1;
+			goto CLEANUP;
+		}
+		statistics.searches = searches;
+	}
+	record = &statistics.searches[statistics.num_recorded];
+	record->search = statistics.num_searches;
+	record->num_threads = num_threads;
+	record->num_expanded = num_expanded;
+	record->num_generated = num_generated;
+	record->num_evaluations = num_evaluations;
+	record->num_pushes = 0;
+	record->num_pops = 0;
+	record->max_open_size = 0;
+	for (i = 0; i < num_open; i++){
+		record->num_pushes += open[i].num_pushes;
+		record->num_pops += open[i].num_pops;
+		if (open[i].max_size > record->max_open_size){
+			record->max_open_size = open[i].max_size;
+		}
+	}
+	record->seconds = seconds;
+	statistics.num_recorded++;
+	CLEANUP: {
+		pthread_mutex_unlock(&statistics.lock);
+		return status;
+	}
+}
+
+/*
+ * Function:  print_statistics 
+ * --------------------
+ * Print every search recorded and the totals, one "stats:" line each. Registered with atexit
+ */
+void print_statistics(void){
+	const SearchStats *record;
+	long num_expanded = 0, num_generated = 0, num_evaluations = 0, num_pushes = 0, num_pops = 0, max_open_size = 0;
+	double seconds = 0;
+	int i;
+	for (i = 0; i < statistics.num_recorded; i++){
+		record = &statistics.searches[i];
+		printf("stats: search=%d threads=%d expanded=%ld generated=%ld evaluations=%ld pushes=%ld pops=%ld "
+			"max_open=%ld seconds=%.6f \n", record->search, record->num_threads, record->num_expanded, 
+			record->num_generated, record->num_evaluations, record->num_pushes, record->num_pops, 
+			record->max_open_size, record->seconds);
+		num_expanded += record->num_expanded;
+		num_generated += record->num_generated;
+		num_evaluations += record->num_evaluations;
+		num_pushes += record->num_pushes;
+		num_pops += record->num_pops;
+		if (record->max_open_size > max_open_size){
+			max_open_size = record->max_open_size;
+		}
+		seconds += record->seconds;
+	}
+	printf("stats: total searches=%d expanded=%ld generated=%ld evaluations=%ld pushes=%ld pops=%ld "
+		"max_open=%ld seconds=%.6f \n", statistics.num_searches, num_expanded, num_generated, num_evaluations, 
+		num_pushes, num_pops, max_open_size, seconds);
+	free(statistics.searches);
+}
+#endif
@@ -1,466 +1,5138 @@
-/* 
-	https://www.cs.princeton.edu/courses/archive/spr08/cos226/assignments/8puzzle.html	
-	(N^2-1) puzzle using Iterative deepening A-star (IDA*) algorithm, as described here: 
-	https://algorithmsinsight.wordpress.com/graph-theory-2/ida-star-algorithm-in-general/
-	The Manhattan distance is used as the heuristic estimate.
-	Heuristic calculation has been relatively optimized (updating after every move).
-	Input: "start.txt" and "goal.txt". 
-	Output: The solution printed to screen
-	To compile with gcc, use:
-	gcc -ansi -pedantic -W -Wall -o N_puzzles_IDA N_puzzles_IDA.c -pg
-	Then run:
-	./N_puzzles_IDA
-*/
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <limits.h>
-
-#define NUM_OF_POSSIBLE_MOVES 4 /* Up, down, left, right */
-#define MAX_SOLUTION_LENGTH 1000
-#define MAX_F_VALUE 100
-
-int print_array(const int *arr, int N);
-
-int** new_board(int N);
-
-int print_board(const int** board, int N);
-
-int free_board(int** board, int N);
-
-int valid_moves(int N, int* result, int x_row, int x_col);
-
-int print_solution(const int **start, int N, const char *desc);
-	
-int search(int **board, const int **goal, int N, int depth, int threshold, int *found, char *desc,
-	char **solution, int *current_rows, int *current_cols, const int *goal_rows, const int * goal_cols, int N_squared, 
-	int x_row, int x_col, int h_score);
-	
-int run(int **start, const int **goal, int N);
-
-int main()
-{
-   
-   FILE *fid;
-   int N, i, j;   
-   int **start, **goal;  
-
-   /* Read start position */
-   fid = fopen("start.txt", "rt");
-   fscanf(fid, "%d ", &N);   
-   start = new_board(N);
-   for (i = 0; i < N; i++){
-	   for (j = 0; j < N; j++){
-		   fscanf(fid, "%d ", &start[i][j]);
-	   }
-   }
-   fclose(fid);
-      
-   /* Read goal position */
-   fid = fopen("goal.txt", "rt");   
-   goal = new_board(N);
-   for (i = 0; i < N; i++){
-	   for (j = 0; j < N; j++){
-		   fscanf(fid, "%d ", &goal[i][j]);
-	   }
-   }
-   fclose(fid);   
-   
-   
-   run(start, (const int **) goal, N);    
-    
-   free_board(start, N);   
-   free_board(goal, N);    
-   return 0;
-}
-
-int print_array(const int *arr, int N){
-	int i;
-	for (i = 0; i < N; i++){
-		printf("%d ", arr[i]);
-	}
-	printf("\n");
-	return 0;
-}
-int** new_board(int N){
-   int **board, i;
-   board = (int **) malloc(sizeof(int *) * N);
-   for (i = 0; i < N; i++){
-	   board[i] = (int *) malloc(sizeof(int) * N);
-   }
-   return board;
-}
-
-/*
- * Function:  print_board 
- * --------------------
- * Print the board
- *    
- *  board: The board configuration 
- *  N: width and height of the board 
- * 
- *  returns: 0
- */
-int print_board(const int** board, int N){
-	int i, j;	
-	for (i = 0; i < N; i++){		
-		for (j = 0; j < N; j++){
-			if (board[i][j] == 0) {
-				printf("%2c ",'x');
-			} else {
-				printf("%2d ", board[i][j]);
-			}
-		}
-		printf("\n");
-	}
-	return 0;
-}
-
-/*
- * Function:  free_board 
- * --------------------
- * Free the board
- *    
- *  board: The board configuration 
- *  N: width and height of the board 
- * 
- *  returns: 0
- */
-int free_board(int** board, int N){
-	int i;
-	for (i = 0; i < N; i++){
-		free(board[i]);
-	}
-	free(board);
-	return 0;
-}
-
-/*
- * Function:  print_solution 
- * --------------------
- * Print the optimal solution
- *    
- *  start: The start state *  
- *  N: width and height of the board 
- *  desc: A descriptions of the moves to get from the start state to the goal state'
- *  For example : "Brdrd" would be "right, down, right, down" 
- *  u: Up, d: Down, l: Left, r: Right. B denotes the starting position
- *
- *  returns: 0
- */
-int print_solution(const int **start, int N, const char *desc){
-	int **board, i, j, temp, x_row, x_col, new_x_row, new_x_col;	
-	char move;
-	board = new_board(N);
-	for (i = 0; i < N; i++){		
-		for (j = 0; j < N; j++){
-			board[i][j] = start[i][j];	
-			if (board[i][j] == 0) {
-				x_row = i;
-				x_col = j;
-			} 			
-		}		
-	}
-	printf("Moves to get to the solution: %s \n", desc);
-	
-	printf("The solution: \n");	
-	i = 1;
-	while (1) {
-		print_board((const int **) board, N);
-		printf(" => \n\n");		
-		move = desc[i];
-		if (move == '\0'){
-			printf("The end!\n");
-			for (i = 0; i < N; i++){
-				free(board[i]);
-			}
-			free(board);
-			return 0;
-		}
-		switch (move){
-			case 'u':
-				/* Up */
-				new_x_row = x_row - 1;
-				new_x_col = x_col;
-				break;
-			case 'd':
-				/* Down */
-				new_x_row = x_row + 1;
-				new_x_col = x_col;
-				break;
-			case 'l':
-				/* Left */
-				new_x_row = x_row;
-				new_x_col = x_col - 1;
-				break;
-			case 'r':
-				/* Right */
-				new_x_row = x_row;
-				new_x_col = x_col + 1;
-				break;		
-		}
-		temp = board[new_x_row][new_x_col];
-		board[new_x_row][new_x_col] = board[x_row][x_col];
-		board[x_row][x_col] = temp;	
-		x_row = new_x_row;
-		x_col = new_x_col;
-		i++;
-	}	
-	return 0;
-}
-
-int search(int **board, const int **goal, int N, int depth, int threshold, int *found, char *desc,
-	char **solution, int *current_rows, int *current_cols, const int *goal_rows, const int * goal_cols, int N_squared, 
-	int x_row, int x_col, int h_score){
-		
-	int f_score;
-	int min, temp;
-	int solution_length;
-	int i;
-	char move, go_back_move, last_move_by_current;	
-	int old_x_row, old_x_col, new_x_row, new_x_col;
-	int new_h_score;
-	int temp_1, goal_row_temp, goal_col_temp;
-	int N_minus_one = N - 1;
-	
-	/* printf("in search \n");
-	*/
-	
-	f_score = depth + h_score;	
-	if (f_score > threshold) {
-		return f_score;
-	}	
-	if (h_score == 0){		
-		*found = 1;		
-		solution_length = 0;
-		while (desc[solution_length] != '\0'){
-			solution_length++;
-		}
-		*solution = (char *) malloc(sizeof(char) * solution_length);
-		for (i = 0; i < solution_length; i++){
-			(*solution)[i] = desc[i];
-		}
-		(*solution)[solution_length] = '\0';
-		return f_score;		
-	}
-	min = INT_MAX;
-	last_move_by_current = desc[depth]; /* desc always starts with 'B' so this is okay */	
-	old_x_row = x_row;
-	old_x_col = x_col;
-	for (i = 0; i < NUM_OF_POSSIBLE_MOVES; i++){		
-		switch (i) {
-			case 0:
-				move = 'u';
-				go_back_move = 'd';
-				new_x_row = x_row - 1;
-				new_x_col = x_col;
-				break;
-			case 1:
-				move = 'd';
-				go_back_move = 'u';
-				new_x_row = x_row + 1;
-				new_x_col = x_col;
-				break;
-			case 2:
-				move = 'l';
-				go_back_move = 'r';
-				new_x_row = x_row;
-				new_x_col = x_col - 1;
-				break;
-			case 3:
-				move = 'r';
-				go_back_move = 'l';
-				new_x_row = x_row;
-				new_x_col = x_col + 1;
-				break;
-		}	
-		if (move == 'u'){
-			if (x_row == 0) {
-				continue;
-			}
-		}
-		if (move == 'd'){
-			if (x_row == N_minus_one){
-				continue;
-			}
-		}
-		if (move == 'l'){
-			if (x_col == 0){
-				continue;
-			}
-		}
-		if (move == 'r'){
-			if (x_col == N_minus_one){
-				continue;
-			}
-		}		
-		if (last_move_by_current == go_back_move){
-			/* No need to consider going back to the previous state */			
-			continue;			
-		}				
-		
-		/* Update h_score */
-		new_h_score = h_score;
-		temp_1 = board[new_x_row][new_x_col];
-		goal_row_temp = goal_rows[temp_1];
-		goal_col_temp = goal_cols[temp_1];
-		/*
-		new_h_score -= abs(current_rows[temp_1] - goal_row_temp);
-		new_h_score -= abs(current_cols[temp_1] - goal_col_temp);			
-		new_h_score += abs(current_rows[0] - goal_row_temp);
-		new_h_score += abs(current_cols[0] - goal_col_temp);
-		*/
-		switch (go_back_move){
-			case 'u':
-				if (goal_row_temp < current_rows[temp_1]){
-					new_h_score--;
-				} else {
-					new_h_score++;
-				}
-				break;
-			case 'd':
-				if (goal_row_temp > current_rows[temp_1]){
-					new_h_score--;
-				} else {
-					new_h_score++;
-				}
-				break;
-			case 'l':
-				if (goal_col_temp < current_cols[temp_1]){
-					new_h_score--;
-				} else {
-					new_h_score++;
-				}
-				break;
-			case 'r':
-				if (goal_col_temp > current_cols[temp_1]){
-					new_h_score--;
-				} else {
-					new_h_score++;
-				}
-				break;				
-		}
-		
-		/* Move */
-		current_rows[0] = new_x_row;
-		current_cols[0] = new_x_col;
-		current_rows[temp_1] = old_x_row;
-		current_cols[temp_1] = old_x_col;		
-		board[old_x_row][old_x_col] = temp_1;
-		board[new_x_row][new_x_col] = 0;		
-		desc[depth+1] = move;
-		desc[depth+2] = '\0';
-		
-		/* Search further down the game tree */
-		temp = search(board, goal, N, depth+1, threshold, found, desc, solution, current_rows, current_cols,
-			goal_rows, goal_cols, N_squared, new_x_row, new_x_col, new_h_score);		
-		
-		/* Move back */
-		board[old_x_row][old_x_col] = 0;
-		board[new_x_row][new_x_col] = temp_1;		
-		desc[depth+1] = '\0';		
-		current_rows[0] = old_x_row;
-		current_cols[0] = old_x_col;
-		current_rows[temp_1] = new_x_row;
-		current_cols[temp_1] = new_x_col;
-		
-		if (*found == 1){
-			return temp;
-		}
-		
-		if (temp < min){
-			 /* find the minimum of all f_score greater than threshold encountered */
-			min = temp;
-		}
-	}
-	*found = 0;
-	return min;  /* return the minimum f_score encountered greater than threshold */
-}
-
-/*
- * Function:  run 
- * --------------------
- * Run (N^2-1) solver using A-star algorithm
- *    
- *  start: The starting board
- *  goal: The goal
- *  N: width and height of the board 
- * 
- *  returns: 0
- */ 
-int run(int **start, const int **goal, int N){
-	int threshold;
-	int found = 0;	
-	int *current_cols, *current_rows, *goal_cols, *goal_rows; /* Position of each element */
-	int N_squared;
-	int temp;
-	char *desc = (char *) malloc(sizeof(char) * MAX_SOLUTION_LENGTH);
-	char *solution = NULL;
-	int i,j;
-	int x_row, x_col;
-	int h_score;	
-	
-	/* Precompute positions for goal */
-	N_squared = N*N;
-	current_cols = (int *) malloc(sizeof(int) * N_squared);
-    current_rows = (int *) malloc(sizeof(int) * N_squared);
-    goal_cols = (int *) malloc(sizeof(int) * N_squared);
-    goal_rows = (int *) malloc(sizeof(int) * N_squared);
-	for (i = 0; i < N; i++){		
-		for (j = 0; j < N; j++){
-			goal_rows[goal[i][j]] = i;
-			goal_cols[goal[i][j]] = j;
-		}		
-	}	
-	for (i = 0; i < N; i++){		
-		for (j = 0; j < N; j++){
-			current_rows[start[i][j]] = i;
-			current_cols[start[i][j]] = j;
-		}		
-	}	
-	
-	/* Find 'x' position */
-	for (i = 0; i < N; i++){		
-		for (j = 0; j < N; j++){
-			if (start[i][j] == 0) {
-				x_row = i;
-				x_col = j;				
-			} 			
-		}		
-	}
-	
-	desc[0] = 'B';
-	desc[1] = '\0';
-	/* Here we use Manhattan score for the heuristic estimate */
-	h_score = 0;
-	for (i = 1; i < N_squared; i++){
-	   /* Do not care about 'x' */
-	   h_score += (abs(current_rows[i] - goal_rows[i]) + abs(current_cols[i] - goal_cols[i]));
-    }
-	threshold = h_score;	
-	while (1){			
-		temp = search(start, goal, N, 0, threshold, &found, desc, &solution, 
-			current_rows, current_cols, (const int *)goal_rows, (const int *) goal_cols, N_squared, 
-			x_row, x_col, h_score);
-		if (found == 1){
-			printf("FOUND SOLUTION!\n");
-			print_solution((const int **) start, N, (const char *) solution);
-			goto CLEANUP;				
-		}
-		if (temp > MAX_F_VALUE){
-			/* Threshold larger than maximum possible f value */
-			printf("MAXIMUM F VALUE REACHED! TERMINATING! \n");
-			goto CLEANUP;
-		}
-		threshold = temp;
-	}		
-	CLEANUP: {
-		free(solution);
-		free(current_cols);
-		free(current_rows);
-		free(goal_cols);
-		free(goal_rows);
-		free(desc);
-		return 0;
-	}	
-}
+/* 
+	https://www.cs.princeton.edu/courses/archive/spr08/cos226/assignments/8puzzle.html	
+	(N^2-1) puzzle using Iterative deepening A-star (IDA*) algorithm, as described here: 
+	https://algorithmsinsight.wordpress.com/graph-theory-2/ida-star-algorithm-in-general/
+	The heuristic estimate is the Manhattan distance by default, or Manhattan distance plus linear 
+	conflicts, or the walking distance (up to 4x4), or an additive pattern database (up to 5x5). 
+	All of them are updated after every move.
+	Input: "start.txt" and "goal.txt". 
+	Output: The solution printed to screen
+	To compile with gcc, use:
+	gcc -ansi -pedantic -W -Wall -pthread -o N_puzzles_IDA N_puzzles_IDA.c
+	Add -pg only to profile it with gprof: the build then writes gmon.out on every run, and is slower.
+	Then run:
+	./N_puzzles_IDA [-heuristic manhattan|linear|walking|pattern] [-pdb file] [-prefault] [-threads T] 
+		[-transposition MB] [-frontier MB] [-automaton D] [-distances file]
+	-threads searches with T threads. The start is expanded into a frontier of subtrees, which the 
+	threads share out by work stealing in every iteration. The solution is still an optimal one.
+	-prefault reads the whole pattern database in before the search instead of on first use. 
+	-transposition gives each search a transposition table of at most MB megabytes, shared by its 
+	threads without locks. A board reached again in the same iteration with no fewer moves is cut 
+	off, as its subtree has been searched already. The table is overwritten as it fills, so it 
+	only prunes some of the duplicates, but the solution stays optimal.
+	-frontier keeps the boards cut off by the threshold, in at most MB megabytes, so that the next 
+	iteration carries on from those within the new threshold instead of starting over. If they do 
+	not fit, or would not going by how fast they grew so far, the iterations after that start over 
+	as usual. It saves the boards of the earlier iterations, but there are more boards at the edge 
+	than inside, and each is written out and read back, so it only pays off when a board costs more 
+	to expand than that. Only for searches on one thread.
+	-automaton sets the length D of the longest move sequences (2 to 13, 8 by default) looked 
+	at to learn the move automaton, before the search. It knows every sequence that leads to the 
+	same board as a shorter one or an earlier one of the same length, e.g. "ud" or "urdlur" 
+	("ruldru" gets there too), and the search never makes the last move of one. With -automaton 2 
+	it only stops the search from going straight back.
+	The time to set up the heuristic and the search time are reported separately.
+	To solve every instance of a file in the format of temp.txt instead of start.txt and goal.txt:
+	./N_puzzles_IDA -batch file [-heuristic ...] [-pdb file] [-prefault] [-threads T] [-transposition MB] 
+		[-frontier MB] [-automaton D] [-distances file]
+	The heuristic tables are set up once per distinct goal. In batch mode, -threads solves T 
+	instances at a time. The time, nodes expanded and length of each instance are reported, 
+	followed by the number of instances solved per second. -csv file and -json file also write 
+	them, with nodes/s and the peak RSS of the process, for benchmarks/run_benchmarks.sh.
+	A start from which the goal cannot be reached is turned down before any search, with exit 
+	status 2. In batch mode such an instance is reported as UNSOLVABLE, and the batch exits with 2 
+	if every other instance was solved. Any other instance that is not solved gives exit status 1.
+	The pattern database (patterns.pdb by default) is built once for the goal in goal.txt with:
+	./N_puzzles_IDA -build-pdb file [-partition tiles/tiles/...]
+	The partition lists the tiles of each pattern, e.g. 1,5,6,9,10,13/7,8,11,12,14,15/2,3,4 
+	(this is the default 6-6-3 split for the 4x4 board when the blank is last; for other goals the 
+	same blocks are turned or mirrored so that the blank's cell drops out of the 7-cell one, e.g. 
+	3,6,7,10,11,15/1,2,4,5,8,9/12,13,14 for the goal 0 1 2 ... 15)
+	For boards up to 3x3, the number of moves to the goal in goal.txt from every board (181440 of 
+	them for 3x3, 4 bits each) is found once with:
+	./N_puzzles_IDA -build-distances file
+	With -distances file, the instances with that goal are then solved by always moving to the 
+	board one move closer, without any search. Instances with other goals are searched as usual.
+	Compiled with -DNPUZZLE_STATS, the search also counts the boards generated and expanded, the 
+	heuristic evaluations and the time of every threshold iteration, and prints them on exit as 
+	"stats:" lines of key=value pairs
+*/
+#define _POSIX_C_SOURCE 200112L /* For mmap, posix_madvise, clock_gettime and pthreads */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define NUM_OF_POSSIBLE_MOVES 4 /* Up, down, left, right */
+#define EXIT_UNSOLVABLE 2 /* Exit status when the goal cannot be reached from the start */
+#define MAX_F_VALUE 1000 /* Only there to give up on a board that cannot be solved. The search stack grows with the threshold */
+#define SEARCH_PAUSED -1 /* Returned by the search functions when they stop at stop_expanded, to be called again */
+#define SEARCH_SLICE 65536 /* Boards a worker expands between looking for another worker having reached the goal */
+#define MAX_PACKED_N 4 /* Up to 4x4, a board fits in a uint64_t with 4 bits per tile */
+#define HEURISTIC_MANHATTAN 0
+#define HEURISTIC_LINEAR_CONFLICT 1 /* Manhattan distance plus 2 moves per tile that must leave its goal line */
+#define HEURISTIC_WALKING_DISTANCE 2
+#define MAX_WALKING_DISTANCE_N 4 /* A walking distance key holds N*N counts of 3 bits and the line of 'x' */
+#define WALKING_DISTANCE_TABLE_SIZE (1UL << 16) /* Enough for the 24964 states of the 4x4 board */
+#define MAX_LINE_LENGTH 16 /* Longest row or column handled by line_conflicts */
+#define HEURISTIC_PATTERN_DATABASE 3 /* Manhattan distance plus the extra moves stored for each pattern */
+#define MAX_PATTERN_DATABASE_N 5
+#define MAX_PATTERNS 8
+#define MAX_PATTERN_SIZE 8 /* Tiles in one pattern. 6 tiles on the 4x4 board is a 92MB search to build */
+#define DEFAULT_PATTERN_SIZE 5
+#define PATTERN_PENDING 0x80 /* Marks a state waiting to be expanded in build_pattern */
+#define PATTERN_FILE_MAGIC "NPUZPDB\0"
+#define PATTERN_FILE_VERSION 1 /* Bump whenever the layout or the meaning of the entries changes */
+#define PATTERN_TABLE_ALIGNMENT 4096 /* Tables start on a page boundary in the file and in the mapping */
+#define DEFAULT_PATTERN_FILE "patterns.pdb"
+#define MAX_DISTANCE_TABLE_N 3 /* A distance table has N*N * (N*N - 1)! / 2 entries, 181440 for the 3x3 board */
+#define DISTANCE_UNREACHABLE 0xF /* Entry of a distance table for a board the goal cannot be reached from. The others are the distance modulo this */
+#define DISTANCE_FILE_MAGIC "NPUZDST\0"
+#define DISTANCE_FILE_VERSION 1
+#define MAX_THREADS 256
+#define FRONTIER_NODES_PER_THREAD 128 /* Enough subtrees per thread that stealing evens out their sizes */
+#define MAX_FRONTIER_DEPTH 32
+#define INITIAL_STATS_CAPACITY 64
+#define TRANSPOSITION_G_BITS 16 /* An entry of the transposition table keeps the g-score in these bits, */
+#define TRANSPOSITION_STATE_BITS 16 /* the state of the move automaton in these, and the iteration above */
+#define MAX_AUTOMATON_STATES (1 << TRANSPOSITION_STATE_BITS)
+#define MAX_AUTOMATON_DEPTH 13 /* Beyond this, the automaton has more than MAX_AUTOMATON_STATES states */
+#define DEFAULT_AUTOMATON_DEPTH 8 /* Learned in a few milliseconds, where depth 10 takes about 0.05 s */
+#define TRANSPOSITION_MIN_SLACK 4 /* Boards with fewer moves to spare below the threshold are not looked up, their subtrees cost less than the cache miss */
+
+#ifdef NPUZZLE_STATS
+#define STATS_COUNT(counter) ((counter)++)
+#else
+#define STATS_COUNT(counter) ((void) 0) /* The counters do not even exist without NPUZZLE_STATS */
+#endif
+
+static const char *HEURISTIC_NAMES[] = {"manhattan", "linear", "walking", "pattern"}; /* By HEURISTIC_* */
+
+typedef struct WalkingDistanceStruct {
+	int N;
+	int num_states;
+	int capacity;
+	uint64_t *keys; /* keys[index] = tile counts and the line of 'x' (see walking_distance_key) */
+	unsigned char *distance; /* distance[index] = number of moves from the goal counts */
+	int *next; /* next[(index*2 + direction)*N + group] = index after a tile whose goal line is 'group' 
+	              slides into the line of 'x' from the line before it (direction 0) or after it (direction 1), 
+	              or -1 if there is no such tile */
+	int *table; /* Open addressing from keys to indices, WALKING_DISTANCE_TABLE_SIZE slots */
+} WalkingDistance;
+
+typedef struct PatternFileHeaderStruct {
+	char magic[8]; /* PATTERN_FILE_MAGIC */
+	int version; /* PATTERN_FILE_VERSION */
+	int N;
+	uint64_t goal_fingerprint; /* See goal_fingerprint(). The tables only hold for this goal */
+	uint64_t table_offsets[MAX_PATTERNS]; /* Where the table of each pattern starts in the file */
+	int num_patterns;
+	int num_tiles[MAX_PATTERNS];
+	int tiles[MAX_PATTERNS][MAX_PATTERN_SIZE];
+} PatternFileHeader; /* The table of each pattern, (num_entries + 1) / 2 bytes, follows at its offset */
+
+typedef struct PatternDatabaseStruct {
+	int N;
+	int num_patterns;
+	int num_tiles[MAX_PATTERNS];
+	int tiles[MAX_PATTERNS][MAX_PATTERN_SIZE];
+	int pattern_of[MAX_PATTERN_DATABASE_N * MAX_PATTERN_DATABASE_N]; /* pattern_of[tile] = the pattern it is in */
+	int slot_of[MAX_PATTERN_DATABASE_N * MAX_PATTERN_DATABASE_N]; /* slot_of[tile] = its place in the pattern */
+	unsigned long num_entries[MAX_PATTERNS]; /* (N*N)! / (N*N - num_tiles)! */
+	const unsigned char *tables[MAX_PATTERNS]; /* 4 bits per entry (see pattern_entry), inside the mapping */
+	void *mapping; /* The whole file, mapped read-only */
+	size_t mapping_size;
+} PatternDatabase;
+
+typedef struct DistanceFileHeaderStruct {
+	char magic[8]; /* DISTANCE_FILE_MAGIC */
+	int version; /* DISTANCE_FILE_VERSION */
+	int N;
+	int max_distance; /* Moves from the farthest board to the goal */
+	uint64_t goal_fingerprint; /* See goal_fingerprint(). The table only holds for this goal */
+} DistanceFileHeader; /* The entries, (num_entries + 1) / 2 bytes, follow */
+
+typedef struct SuccessorStruct {
+	char move; /* 'u', 'd', 'l' or 'r' */
+	int direction; /* Index of the move in u, d, l, r */
+	int blank; /* Position of 'x' after the move, row*N + col */
+	int row;
+	int col;
+} Successor;
+
+typedef struct MoveTableStruct {
+	int N;
+	Successor *successors; /* successors[blank*NUM_OF_POSSIBLE_MOVES + k] = k-th move of 'x' at blank, 
+	                          for k < num_successors[blank] */
+	int *num_successors;
+	signed char *manhattan_delta; /* manhattan_delta[(blank*NUM_OF_POSSIBLE_MOVES + k)*N*N + tile] = change 
+	                                 in the Manhattan distance of tile when the k-th move of 'x' at blank 
+	                                 slides it into blank */
+} MoveTable;
+
+typedef struct MoveAutomatonStruct {
+	int num_states;
+	int *next; /* next[state*NUM_OF_POSSIBLE_MOVES + direction] = state after the move, or -1 if the moves 
+	              so far end with a redundant sequence (see new_move_automaton). The search starts in state 0 */
+} MoveAutomaton;
+
+typedef struct ReachedBoardStruct {
+	uint64_t key[2]; /* Two Zobrist keys of the board a move sequence leads to (see learn_sequences) */
+	signed char box[4]; /* Lowest and highest row, lowest and highest column of 'x' on the way, from its start */
+	char used; /* 0 for an empty slot */
+} ReachedBoard;
+
+typedef struct AutomatonLearnerStruct {
+	int depth; /* Length of the longest sequences tried */
+	int width; /* Of the board they are tried on, 2*depth + 1 with 'x' starting in the middle */
+	int *cells; /* cells[row*width + col] = starting position of the tile there, or -1 for 'x' */
+	ReachedBoard *reached; /* Open addressing, one slot for every sequence kept so far */
+	unsigned long reached_mask; /* Number of slots - 1, a power of two */
+	unsigned long num_reached;
+	uint64_t *pruned; /* Open addressing of the redundant sequences, 2 bits per move after a leading 1 bit */
+	unsigned long pruned_mask;
+	unsigned long num_pruned;
+} AutomatonLearner;
+
+typedef struct DistanceTableStruct {
+	int N;
+	int max_distance;
+	unsigned long num_entries; /* N*N * (N*N - 1)! / 2, one per board with the goal reachable from it */
+	unsigned char *entries; /* 4 bits per board (see distance_entry), two to a byte */
+	MoveTable moves;
+} DistanceTable;
+
+typedef struct HeuristicStruct {
+	int kind; /* HEURISTIC_MANHATTAN, HEURISTIC_LINEAR_CONFLICT or HEURISTIC_WALKING_DISTANCE */
+	int N;
+	const int *goal_rows;
+	const int *goal_cols;
+	WalkingDistance rows; /* Walking distance along the rows, only for HEURISTIC_WALKING_DISTANCE */
+	WalkingDistance cols; /* Walking distance along the columns */
+	PatternDatabase pdb; /* Only for HEURISTIC_PATTERN_DATABASE */
+	MoveTable moves;
+	const MoveAutomaton *automaton; /* Which moves the search tries, not owned */
+} Heuristic;
+
+typedef struct TranspositionEntryStruct {
+	volatile uint64_t check; /* key ^ data, so that an entry torn by two threads writing it at once does not match */
+	volatile uint64_t data; /* Iteration, state of the move automaton and g-score */
+} TranspositionEntry;
+
+typedef struct TranspositionTableStruct {
+	TranspositionEntry *entries; /* entries[hash of the key & mask], the latest board to land there wins */
+	unsigned long mask; /* Number of entries - 1, a power of two */
+	int N;
+	uint64_t *zobrist; /* If N > MAX_PACKED_N, the key of a board is the xor of zobrist[tile*N*N + position] 
+	                      over its tiles. Up to MAX_PACKED_N, it is the packed board itself */
+	uint64_t iteration; /* Of IDA*, from 1. Entries from earlier iterations never match */
+} TranspositionTable;
+
+typedef struct SearchFrameStruct {
+	int blank; /* Position of 'x', row*N + col */
+	int x_row, x_col;
+	int k; /* The next move to try, successors[blank*NUM_OF_POSSIBLE_MOVES + k] in the MoveTable */
+	int state; /* Of the heuristic's MoveAutomaton, after the moves to this board */
+	int num_successors; /* num_successors[blank] in the MoveTable */
+	int h_score;
+	int wd_rows, wd_cols; /* Only for HEURISTIC_WALKING_DISTANCE */
+	uint64_t board; /* If N <= MAX_PACKED_N, the board itself, else its key in the transposition table if there is one */
+	int pattern; /* For HEURISTIC_PATTERN_DATABASE, the pattern of the tile moved to get here */
+	unsigned long old_rank; /* And its placement before that move */
+} SearchFrame;
+
+typedef struct CutBoardStruct {
+	unsigned short f_score; /* At most MAX_F_VALUE */
+	unsigned short depth;
+	unsigned short state; /* Of the heuristic's MoveAutomaton, after the moves to the board */
+} CutBoard; /* In CutBoards, followed by the board and its moves from the start (see cut_board_size) */
+
+typedef struct CutBoardsStruct {
+	unsigned char *records; /* One record after another (see cut_board_size) */
+	size_t size; /* Bytes in use */
+	size_t capacity;
+	size_t limit; /* The records must fit in this many bytes */
+	int overflowed; /* Set to 1 when a board did not fit, which makes the boards kept of no use */
+} CutBoards;
+
+typedef struct SearchContextStruct {
+	const int **goal;
+	uint64_t packed_goal; /* Only if N <= MAX_PACKED_N */
+	int N;
+	int threshold; /* The current f-score threshold */
+	volatile int *found; /* Set to 1 when the goal is reached, shared by all the threads */
+	char *desc; /* The moves made so far, starting with 'B', capacity + 2 characters */
+	char **solution; /* A copy of desc once the goal is reached, by the thread that set found */
+	int *current_rows; /* Row position for each of the value in the current board (current_rows[value] = position) */
+	int *current_cols;
+	const int *goal_rows; /* Row position for each of the value in the goal (goal_rows[value] = position) */
+	const int *goal_cols;
+	const Heuristic *heuristic;
+	unsigned long pattern_ranks[MAX_PATTERNS]; /* Placement of each pattern on the current board */
+	int **board; /* Only if N > MAX_PACKED_N, the current board */
+	TranspositionTable *table; /* NULL without -transposition, shared by all the threads */
+	CutBoards *cut_boards; /* NULL, or where the boards cut off by the threshold are kept for the next iteration */
+	SearchFrame *frames; /* frames[d] = the board after d moves, for d from base_depth to depth */
+	int capacity; /* Of frames */
+	int base_depth; /* Depth of the board given to start_search */
+	int depth; /* Depth of the current board, below base_depth once the search is over */
+	int min; /* Minimum f_score greater than threshold so far */
+	long num_expanded;
+#ifdef NPUZZLE_STATS
+	long num_generated; /* In the current iteration */
+	long num_evaluations;
+#endif
+} SearchContext;
+
+typedef int (*SearchFunction)(SearchContext *context, long stop_expanded);
+
+typedef struct FrontierNodeStruct {
+	int *tiles; /* The board, tiles[row*N + col] */
+	char *desc; /* 'B' followed by the moves from the start */
+	int *path_f; /* path_f[d] = f-score of the board after the first d moves, up to the node itself */
+	int depth;
+	int state; /* Of the heuristic's MoveAutomaton, after desc */
+	int x_row, x_col;
+	int h_score;
+	int wd_rows, wd_cols;
+	unsigned long pattern_ranks[MAX_PATTERNS];
+} FrontierNode;
+
+typedef struct FrontierStruct {
+	FrontierNode *nodes; /* Every board reachable in exactly 'depth' moves without going straight back */
+	int num_nodes;
+	int capacity;
+	int depth;
+} Frontier;
+
+typedef struct WorkQueueStruct {
+	pthread_mutex_t lock;
+	int *items; /* Indices into the frontier */
+	int top; /* Thieves take items[top] */
+	int bottom; /* The owner takes items[bottom - 1] */
+} WorkQueue;
+
+typedef struct ParallelSearchStruct {
+	const Frontier *frontier;
+	WorkQueue *queues; /* One per worker */
+	int num_threads;
+	int threshold;
+	volatile int found; /* Set to 1 by the first worker to reach the goal */
+	char *solution; /* Written by that worker only */
+	volatile int next_threshold; /* Minimum f-score above the threshold over all workers */
+	volatile long num_expanded;
+#ifdef NPUZZLE_STATS
+	volatile long num_generated; /* In the current iteration */
+	volatile long num_evaluations;
+#endif
+} ParallelSearch;
+
+typedef struct WorkerStruct {
+	ParallelSearch *shared;
+	int id;
+	SearchContext context; /* Its own copy, with its own desc, search stack, board, positions and pattern ranks */
+} Worker;
+
+#ifdef NPUZZLE_STATS
+typedef struct IterationStatsStruct {
+	int search; /* Number of the search, from 1, to tell apart the instances of a batch */
+	int iteration;
+	int threshold;
+	long num_generated;
+	long num_expanded;
+	long num_evaluations;
+	double seconds;
+} IterationStats;
+
+typedef struct StatisticsStruct {
+	pthread_mutex_t lock;
+	int num_searches;
+	IterationStats *iterations; /* In the order they finished */
+	int num_iterations;
+	int capacity;
+} Statistics;
+
+static Statistics statistics = {PTHREAD_MUTEX_INITIALIZER, 0, NULL, 0, 0};
+#endif
+
+typedef struct OptionsStruct {
+	int heuristic; /* HEURISTIC_MANHATTAN, HEURISTIC_LINEAR_CONFLICT, HEURISTIC_WALKING_DISTANCE or HEURISTIC_PATTERN_DATABASE */
+	const char *pattern_file; /* Pattern database to load */
+	int prefault; /* 1 to read the whole pattern database in before searching */
+	int num_threads;
+	const char *build_pattern_file; /* If set, build a pattern database into this file instead of solving */
+	const char *partition; /* Partition for the pattern database to build, or NULL for the default */
+	const char *batch_file; /* If set, solve every instance of this file instead of start.txt and goal.txt */
+	const char *csv_file; /* If set, the results of the batch also go to this file as CSV */
+	const char *json_file; /* And to this one as JSON */
+	long table_megabytes; /* Size of the transposition table of each search, 0 for none */
+	long frontier_megabytes; /* Memory for the boards each search keeps between its iterations, 0 for none */
+	int automaton_depth; /* Length of the longest move sequences the move automaton is learned from */
+	const char *distance_file; /* If set, the instances it was built for are solved from this distance table */
+	const char *build_distance_file; /* If set, build a distance table into this file instead of solving */
+} Options;
+
+typedef struct GoalTableStruct {
+	struct GoalTableStruct *next;
+	int N;
+	int *goal_rows;
+	int *goal_cols;
+	int ready; /* 0 if the heuristic is not available for this goal */
+	Heuristic heuristic; /* Only read once set up, by every thread solving an instance with this goal */
+	int has_distances; /* 1 if the instances with this goal are solved from the distance table instead */
+	DistanceTable distances;
+} GoalTable;
+
+typedef struct BatchSearchStruct {
+	FILE *fid;
+	const Options *options;
+	pthread_mutex_t lock; /* Held to read the file, to set up goal tables, to update the counts and to print */
+	int num_read;
+	int malformed; /* Set to 1 when an instance cannot be read, which ends the batch */
+	GoalTable *goal_tables; /* One per distinct goal read so far */
+	int num_solved;
+	int num_unsolvable; /* Instances whose goal cannot be reached, not searched */
+	long num_expanded;
+	FILE *csv; /* NULL without -csv */
+	FILE *json; /* NULL without -json */
+	int num_reported;
+	MoveAutomaton automaton; /* Shared by the heuristics of every goal */
+} BatchSearch;
+
+
+int print_array(const int *arr, int N);
+
+int** new_board(int N);
+
+int print_board(const int** board, int N);
+
+int free_board(int** board, int N);
+
+uint64_t pack_board(const int **board, int N);
+
+int is_solvable(const int **start, const int **goal, int N);
+
+int valid_moves(int N, int* result, int x_row, int x_col);
+
+int print_solution(const int **start, int N, const char *desc);
+
+int line_conflicts(const Heuristic *heuristic, const int *tiles, int line, int is_row);
+
+uint64_t walking_distance_key(const int *tiles, const int *goal_lines, int N, int is_row);
+
+int find_walking_distance(const WalkingDistance *wd, uint64_t key);
+
+int add_walking_distance(WalkingDistance *wd, uint64_t key, int distance);
+
+int build_walking_distance(WalkingDistance *wd, uint64_t goal_key, int N);
+
+int free_walking_distance(WalkingDistance *wd);
+
+int symmetric_cell(int cell, int N, int symmetry);
+
+int default_partition(const int **goal, int N, int *num_tiles, int tiles[][MAX_PATTERN_SIZE]);
+
+int parse_partition(const char *spec, int N, int *num_tiles, int tiles[][MAX_PATTERN_SIZE]);
+
+int set_patterns(PatternDatabase *pdb, int N, int num_patterns, const int *num_tiles, 
+	const int tiles[][MAX_PATTERN_SIZE]);
+
+unsigned long pattern_rank(const PatternDatabase *pdb, int pattern, const int *positions);
+
+int pattern_unrank(const PatternDatabase *pdb, int pattern, unsigned long rank, int *positions);
+
+int pattern_entry(const PatternDatabase *pdb, int pattern, unsigned long rank);
+
+int build_pattern(const PatternDatabase *pdb, int pattern, const int *goal_rows, const int *goal_cols, 
+	unsigned char *table);
+
+uint64_t goal_fingerprint(const int *goal_rows, const int *goal_cols, int N);
+
+int build_pattern_database(const int **goal, int N, const char *partition, const char *file_name);
+
+int load_pattern_database(PatternDatabase *pdb, const char *file_name, int N, uint64_t fingerprint);
+
+int prefault_pattern_database(const PatternDatabase *pdb);
+
+int free_pattern_database(PatternDatabase *pdb);
+
+unsigned long packed_pattern_rank(const PatternDatabase *pdb, int pattern, uint64_t board);
+
+unsigned long board_pattern_rank(const PatternDatabase *pdb, int pattern, const int *rows, const int *cols);
+
+int pattern_ranks(const PatternDatabase *pdb, const int *tiles, unsigned long *ranks);
+
+int new_move_table(MoveTable *moves, const int *goal_rows, const int *goal_cols, int N);
+
+int free_move_table(MoveTable *moves);
+
+uint64_t automaton_zobrist(int seed, int tile, int position, int width);
+
+int is_pruned_sequence(const AutomatonLearner *learner, uint64_t code);
+
+int add_pruned_sequence(AutomatonLearner *learner, uint64_t code);
+
+int reach_board(AutomatonLearner *learner, const ReachedBoard *reached);
+
+int learn_sequences(AutomatonLearner *learner, int length, uint64_t code, int num_moves, 
+	const ReachedBoard *reached, int blank);
+
+int compile_automaton(MoveAutomaton *automaton, const AutomatonLearner *learner);
+
+int new_move_automaton(MoveAutomaton *automaton, int depth);
+
+int free_move_automaton(MoveAutomaton *automaton);
+
+unsigned long distance_rank(const DistanceTable *distances, uint64_t board);
+
+int distance_entry(const DistanceTable *distances, unsigned long rank);
+
+int set_distance_entry(DistanceTable *distances, unsigned long rank, int entry);
+
+int new_distance_table(DistanceTable *distances, const int *goal_rows, const int *goal_cols, int N);
+
+int build_distance_table(const int **goal, int N, const char *file_name);
+
+int load_distance_table(DistanceTable *distances, const char *file_name, const int *goal_rows, 
+	const int *goal_cols, int N);
+
+int free_distance_table(DistanceTable *distances);
+
+int solve_by_distances(const DistanceTable *distances, int **start, const int **goal, char **solution, 
+	long *num_expanded);
+
+int new_heuristic(Heuristic *heuristic, int kind, const int *goal_rows, const int *goal_cols, int N, 
+	const char *pattern_file, const MoveAutomaton *automaton);
+
+int free_heuristic(Heuristic *heuristic);
+
+int heuristic_value(const Heuristic *heuristic, const int *tiles, int *wd_rows, int *wd_cols);
+
+int packed_line(uint64_t board, int N, int line, int is_row, int *tiles);
+
+int packed_conflicts_change(const Heuristic *heuristic, uint64_t board, uint64_t child, int is_row, 
+	int line_1, int line_2);
+
+int board_line(int **board, int N, int line, int is_row, int *tiles);
+
+double seconds_since(const struct timespec *start);
+
+int new_transposition_table(TranspositionTable *table, long megabytes, int N);
+
+int free_transposition_table(TranspositionTable *table);
+
+uint64_t transposition_key(const TranspositionTable *table, const int *tiles);
+
+int transposition_cut(TranspositionTable *table, uint64_t key, int state, int g_score);
+
+int found_goal(SearchContext *context, int depth);
+	
+int reserve_search_stack(SearchContext *context, int max_depth);
+
+int new_cut_boards(CutBoards *boards, size_t limit);
+
+int free_cut_boards(CutBoards *boards);
+
+unsigned char* reserve_cut_board(CutBoards *boards, size_t size);
+
+size_t cut_board_size(int N, int depth);
+
+int keep_cut_board(SearchContext *context, uint64_t board, int depth, int f_score, int state, char move);
+
+int resume_cut_board(SearchContext *context, const unsigned char *record);
+
+int start_search(SearchContext *context, uint64_t board, int depth, int x_row, int x_col, int h_score, 
+	int wd_rows, int wd_cols, int state);
+
+int search(SearchContext *context, long stop_expanded);
+
+int search_5(SearchContext *context, long stop_expanded);
+
+int search_packed(SearchContext *context, long stop_expanded);
+
+int search_packed_3(SearchContext *context, long stop_expanded);
+
+int search_packed_4(SearchContext *context, long stop_expanded);
+
+SearchFunction search_for(int N);
+
+int search_cut_boards(SearchContext *context, const CutBoards *boards);
+	
+int new_frontier(Frontier *frontier);
+
+int free_frontier(Frontier *frontier);
+
+int add_to_frontier(Frontier *frontier, const int *tiles, const char *desc, const int *path_f, int depth, 
+	int state, const Heuristic *heuristic);
+
+int build_frontier(Frontier *frontier, const int *start, const int *goal_tiles, const Heuristic *heuristic, 
+	int min_nodes);
+
+int take_work(ParallelSearch *shared, int id);
+
+int reduce_min(volatile int *target, int value);
+
+void* search_worker(void *arg);
+
+int parallel_search(ParallelSearch *shared, Worker *workers);
+
+int run_parallel(const int *tiles, const SearchContext *context, int num_threads, char **solution, 
+	long *num_expanded);
+
+int solve(int **start, const int **goal, int N, const Heuristic *heuristic, int num_threads, long table_megabytes, 
+	long frontier_megabytes, char **solution, long *num_expanded);
+
+int run(int **start, const int **goal, int N, const Options *options);
+
+int read_instance(FILE *fid, int *N, int ***start, int ***goal);
+
+GoalTable* goal_table(BatchSearch *batch, const int **goal, int N);
+
+long peak_rss(void);
+
+int report_instance(BatchSearch *batch, int index, int N, int solvable, const char *solution, long num_expanded, 
+	double seconds);
+
+void* batch_worker(void *arg);
+
+int run_batch(const char *file_name, const Options *options);
+
+#ifdef NPUZZLE_STATS
+int new_search_stats(void);
+
+int record_iteration(int search, int iteration, int threshold, long num_generated, long num_expanded, 
+	long num_evaluations, double seconds);
+
+void print_statistics(void);
+#endif
+
+int main(int argc, char **argv)
+{
+   
+   FILE *fid;
+   int N, i, j, status = 0;   
+   int **start, **goal;  
+   Options options;
+   
+   options.heuristic = HEURISTIC_MANHATTAN;
+   options.pattern_file = DEFAULT_PATTERN_FILE;
+   options.prefault = 0;
+   options.num_threads = 1;
+   options.table_megabytes = 0;
+   options.frontier_megabytes = 0;
+   options.automaton_depth = DEFAULT_AUTOMATON_DEPTH;
+   options.distance_file = NULL;
+   options.build_distance_file = NULL;
+   options.build_pattern_file = NULL;
+   options.partition = NULL;
+   options.batch_file = NULL;
+   options.csv_file = NULL;
+   options.json_file = NULL;
+#ifdef NPUZZLE_STATS
+   atexit(print_statistics);
+#endif
+   for (i = 1; i < argc; i++){
+	   if ((strcmp(argv[i], "-heuristic") == 0) && (i + 1 < argc)){
+		   i++;
+		   if (strcmp(argv[i], "manhattan") == 0){
+			   options.heuristic = HEURISTIC_MANHATTAN;
+		   } else if (strcmp(argv[i], "linear") == 0){
+			   options.heuristic = HEURISTIC_LINEAR_CONFLICT;
+		   } else if (strcmp(argv[i], "walking") == 0){
+			   options.heuristic = HEURISTIC_WALKING_DISTANCE;
+		   } else if (strcmp(argv[i], "pattern") == 0){
+			   options.heuristic = HEURISTIC_PATTERN_DATABASE;
+		   } else {
+			   printf("Unknown heuristic: %s \n", argv[i]);
+			   return 1;
+		   }
+	   } else if ((strcmp(argv[i], "-pdb") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.pattern_file = argv[i];
+	   } else if ((strcmp(argv[i], "-threads") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.num_threads = atoi(argv[i]);
+		   if ((options.num_threads < 1) || (options.num_threads > MAX_THREADS)){
+			   printf("The number of threads must be between 1 and %d \n", MAX_THREADS);
+			   return 1;
+		   }
+	   } else if ((strcmp(argv[i], "-transposition") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.table_megabytes = atol(argv[i]);
+		   if (options.table_megabytes < 1){
+			   printf("The transposition table needs at least 1 megabyte \n");
+			   return 1;
+		   }
+	   } else if ((strcmp(argv[i], "-frontier") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.frontier_megabytes = atol(argv[i]);
+		   if (options.frontier_megabytes < 1){
+			   printf("The boards kept between iterations need at least 1 megabyte \n");
+			   return 1;
+		   }
+	   } else if ((strcmp(argv[i], "-automaton") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.automaton_depth = atoi(argv[i]);
+		   if ((options.automaton_depth < 2) || (options.automaton_depth > MAX_AUTOMATON_DEPTH)){
+			   printf("The depth of the move automaton must be between 2 and %d \n", MAX_AUTOMATON_DEPTH);
+			   return 1;
+		   }
+	   } else if (strcmp(argv[i], "-prefault") == 0){
+		   options.prefault = 1;
+	   } else if ((strcmp(argv[i], "-build-pdb") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.build_pattern_file = argv[i];
+	   } else if ((strcmp(argv[i], "-partition") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.partition = argv[i];
+	   } else if ((strcmp(argv[i], "-distances") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.distance_file = argv[i];
+	   } else if ((strcmp(argv[i], "-build-distances") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.build_distance_file = argv[i];
+	   } else if ((strcmp(argv[i], "-batch") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.batch_file = argv[i];
+	   } else if ((strcmp(argv[i], "-csv") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.csv_file = argv[i];
+	   } else if ((strcmp(argv[i], "-json") == 0) && (i + 1 < argc)){
+		   i++;
+		   options.json_file = argv[i];
+	   } else {
+		   printf("Usage: %s [-heuristic manhattan|linear|walking|pattern] [-pdb file] [-prefault] [-threads T] [-transposition MB] \n", argv[0]);
+		   printf("          [-frontier MB] [-automaton D] [-distances file] \n");
+		   printf("       %s -batch file [-heuristic ...] [-pdb file] [-prefault] [-threads T] [-transposition MB] \n", argv[0]);
+		   printf("          [-frontier MB] [-automaton D] [-distances file] [-csv file] [-json file] \n");
+		   printf("       %s -build-pdb file [-partition tiles/tiles/...] \n", argv[0]);
+		   printf("       %s -build-distances file \n", argv[0]);
+		   return 1;
+	   }
+   }
+
+   if (options.batch_file != NULL){
+	   return run_batch(options.batch_file, (const Options *) &options);
+   }
+
+   /* Read start position */
+   fid = fopen("start.txt", "rt");
+   fscanf(fid, "%d ", &N);   
+   start = new_board(N);
+   for (i = 0; i < N; i++){
+	   for (j = 0; j < N; j++){
+		   fscanf(fid, "%d ", &start[i][j]);
+	   }
+   }
+   fclose(fid);
+      
+   /* Read goal position */
+   fid = fopen("goal.txt", "rt");   
+   goal = new_board(N);
+   for (i = 0; i < N; i++){
+	   for (j = 0; j < N; j++){
+		   fscanf(fid, "%d ", &goal[i][j]);
+	   }
+   }
+   fclose(fid);   
+   
+   
+   if (options.build_pattern_file != NULL){
+	   if (build_pattern_database((const int **) goal, N, options.partition, options.build_pattern_file) != 0){
+		   free_board(start, N);   
+		   free_board(goal, N);    
+		   return 1;
+	   }
+   } else if (options.build_distance_file != NULL){
+	   if (build_distance_table((const int **) goal, N, options.build_distance_file) != 0){
+		   free_board(start, N);   
+		   free_board(goal, N);    
+		   return 1;
+	   }
+   } else {
+	   status = run(start, (const int **) goal, N, &options);    
+   }
+    
+   free_board(start, N);   
+   free_board(goal, N);    
+   return status;
+}
+
+int print_array(const int *arr, int N){
+	int i;
+	for (i = 0; i < N; i++){
+		printf("%d ", arr[i]);
+	}
+	printf("\n");
+	return 0;
+}
+int** new_board(int N){
+   int **board, i;
+   board = (int **) malloc(sizeof(int *) * N);
+   for (i = 0; i < N; i++){
+	   board[i] = (int *) malloc(sizeof(int) * N);
+   }
+   return board;
+}
+
+/*
+ * Function:  print_board 
+ * --------------------
+ * Print the board
+ *    
+ *  board: The board configuration 
+ *  N: width and height of the board 
+ * 
+ *  returns: 0
+ */
+int print_board(const int** board, int N){
+	int i, j;	
+	for (i = 0; i < N; i++){		
+		for (j = 0; j < N; j++){
+			if (board[i][j] == 0) {
+				printf("%2c ",'x');
+			} else {
+				printf("%2d ", board[i][j]);
+			}
+		}
+		printf("\n");
+	}
+	return 0;
+}
+
+/*
+ * Function:  free_board 
+ * --------------------
+ * Free the board
+ *    
+ *  board: The board configuration 
+ *  N: width and height of the board 
+ * 
+ *  returns: 0
+ */
+int free_board(int** board, int N){
+	int i;
+	for (i = 0; i < N; i++){
+		free(board[i]);
+	}
+	free(board);
+	return 0;
+}
+
+/*
+ * Function:  pack_board 
+ * --------------------
+ * Pack a board of width at most MAX_PACKED_N into 64 bits. 
+ * The tile at position p = row*N + col takes bits 4p to 4p+3
+ *    
+ *  board: The board configuration 
+ *  N: width and height of the board 
+ * 
+ *  returns: the packed board
+ */
+uint64_t pack_board(const int **board, int N){
+	uint64_t packed = 0;
+	int i, j;
+	for (i = 0; i < N; i++){
+		for (j = 0; j < N; j++){
+			packed |= (uint64_t) board[i][j] << (4 * (i*N + j));
+		}
+	}
+	return packed;
+}
+
+/*
+ * Function:  is_solvable 
+ * --------------------
+ * Whether the goal can be reached from the start at all. Every move swaps 'x' with a tile, which 
+ * flips both the parity of the permutation taking the start to the goal and the parity of the 
+ * distance of 'x' from its place in the goal, and the goal is reachable exactly when the two agree. 
+ * For the usual goal with 'x' in the last row this is the familiar rule on inversions and the row 
+ * of 'x', but it holds for any goal
+ *    
+ *  start: The starting board
+ *  goal: The goal
+ *  N: width and height of the board 
+ * 
+ *  returns: 1 if the goal can be reached, 0 if not, -1 if there is not enough memory to tell
+ */
+int is_solvable(const int **start, const int **goal, int N){
+	int *goal_positions, *permutation;
+	int i, j, next, num_cycles = 0, blank_distance = 0, solvable;
+	goal_positions = (int *) malloc(sizeof(int) * 2 * N * N);
+	if (goal_positions == NULL){
+		return -1;
+	}
+	permutation = goal_positions + N*N;
+	for (i = 0; i < N; i++){
+		for (j = 0; j < N; j++){
+			goal_positions[goal[i][j]] = i*N + j;
+		}
+	}
+	for (i = 0; i < N; i++){
+		for (j = 0; j < N; j++){
+			/* Where the tile at (i, j) has to go */
+			permutation[i*N + j] = goal_positions[start[i][j]];
+			if (start[i][j] == 0){
+				blank_distance = abs(i - goal_positions[0] / N) + abs(j - goal_positions[0] % N);
+			}
+		}
+	}
+	for (i = 0; i < N*N; i++){
+		if (permutation[i] < 0){
+			continue;
+		}
+		num_cycles++;
+		for (j = i; permutation[j] >= 0; j = next){
+			next = permutation[j];
+			permutation[j] = -1;
+		}
+	}
+	/* A permutation of N*N elements with c cycles is N*N - c transpositions */
+	solvable = ((N*N - num_cycles) % 2 == blank_distance % 2);
+	free(goal_positions);
+	return solvable;
+}
+
+/*
+ * Function:  print_solution 
+ * --------------------
+ * Print the optimal solution
+ *    
+ *  start: The start state *  
+ *  N: width and height of the board 
+ *  desc: A descriptions of the moves to get from the start state to the goal state'
+ *  For example : "Brdrd" would be "right, down, right, down" 
+ *  u: Up, d: Down, l: Left, r: Right. B denotes the starting position
+ *
+ *  returns: 0
+ */
+int print_solution(const int **start, int N, const char *desc){
+	int **board, i, j, temp, x_row, x_col, new_x_row, new_x_col;	
+	char move;
+	board = new_board(N);
+	x_row = 0; /* Found below, the start always has an 'x' */
+	x_col = 0;
+	for (i = 0; i < N; i++){		
+		for (j = 0; j < N; j++){
+			board[i][j] = start[i][j];	
+			if (board[i][j] == 0) {
+				x_row = i;
+				x_col = j;
+			} 			
+		}		
+	}
+	printf("Moves to get to the solution: %s \n", desc);
+	
+	printf("The solution: \n");	
+	i = 1;
+	while (1) {
+		print_board((const int **) board, N);
+		printf(" => \n\n");		
+		move = desc[i];
+		if (move == '\0'){
+			printf("The end!\n");
+			for (i = 0; i < N; i++){
+				free(board[i]);
+			}
+			free(board);
+			return 0;
+		}
+		switch (move){
+			case 'u':
+				/* Up */
+				new_x_row = x_row - 1;
+				new_x_col = x_col;
+				break;
+			case 'd':
+				/* Down */
+				new_x_row = x_row + 1;
+				new_x_col = x_col;
+				break;
+			case 'l':
+				/* Left */
+				new_x_row = x_row;
+				new_x_col = x_col - 1;
+				break;
+			default:
+				/* Right */
+				new_x_row = x_row;
+				new_x_col = x_col + 1;
+				break;		
+		}
+		temp = board[new_x_row][new_x_col];
+		board[new_x_row][new_x_col] = board[x_row][x_col];
+		board[x_row][x_col] = temp;	
+		x_row = new_x_row;
+		x_col = new_x_col;
+		i++;
+	}	
+	return 0;
+}
+
+/*
+ * Function:  line_conflicts 
+ * --------------------
+ * Linear conflicts on one row or column: the tiles whose goal is on this line must be in 
+ * increasing goal order to reach it without leaving the line. Every tile outside the longest 
+ * increasing run has to step out of the line and back, which costs 2 moves on top of its 
+ * Manhattan distance
+ *    
+ *  heuristic: The heuristic
+ *  tiles: The N tiles on the line, in order
+ *  line: Index of the row or column
+ *  is_row: 1 if the line is a row, 0 if it is a column
+ * 
+ *  returns: the number of extra moves
+ */
+int line_conflicts(const Heuristic *heuristic, const int *tiles, int line, int is_row){
+	const int *goal_lines = is_row ? heuristic->goal_rows : heuristic->goal_cols;
+	const int *goal_places = is_row ? heuristic->goal_cols : heuristic->goal_rows;
+	int places[MAX_LINE_LENGTH], longest[MAX_LINE_LENGTH];
+	int i, j, num_places = 0, longest_run = 0;
+	for (i = 0; i < heuristic->N; i++){
+		if ((tiles[i] != 0) && (goal_lines[tiles[i]] == line)){
+			places[num_places] = goal_places[tiles[i]];
+			num_places++;
+		}
+	}
+	for (i = 0; i < num_places; i++){
+		longest[i] = 1;
+		for (j = 0; j < i; j++){
+			if ((places[j] < places[i]) && (longest[j] + 1 > longest[i])){
+				longest[i] = longest[j] + 1;
+			}
+		}
+		if (longest[i] > longest_run){
+			longest_run = longest[i];
+		}
+	}
+	return 2 * (num_places - longest_run);
+}
+
+/*
+ * Function:  walking_distance_key 
+ * --------------------
+ * Encode a board for the walking distance: for every line and every goal line, how many tiles 
+ * on that line belong to that goal line (3 bits each), plus the line of 'x' on top
+ *    
+ *  tiles: The board, tiles[row*N + col]
+ *  goal_lines: Goal row (or column) of each tile
+ *  N: width and height of the board 
+ *  is_row: 1 to count along rows, 0 along columns
+ * 
+ *  returns: the key
+ */
+uint64_t walking_distance_key(const int *tiles, const int *goal_lines, int N, int is_row){
+	uint64_t key = 0;
+	int i, line;
+	for (i = 0; i < N*N; i++){
+		line = is_row ? (i / N) : (i % N);
+		if (tiles[i] == 0){
+			key |= (uint64_t) line << (3 * MAX_WALKING_DISTANCE_N * MAX_WALKING_DISTANCE_N);
+		} else {
+			key += (uint64_t) 1 << (3 * (line * N + goal_lines[tiles[i]]));
+		}
+	}
+	return key;
+}
+
+/*
+ * Function:  find_walking_distance 
+ * --------------------
+ * Look up the index of a walking distance key
+ *    
+ *  wd: The walking distance tables
+ *  key: The key
+ * 
+ *  returns: the index, or -1 if the key is not in the tables
+ */
+int find_walking_distance(const WalkingDistance *wd, uint64_t key){
+	unsigned long slot = (unsigned long) ((key * (uint64_t) 0x9E3779B97F4A7C15UL) >> 48);
+	while (wd->table[slot] != -1){
+		if (wd->keys[wd->table[slot]] == key){
+			return wd->table[slot];
+		}
+		slot = (slot + 1) & (WALKING_DISTANCE_TABLE_SIZE - 1);
+	}
+	return -1;
+}
+
+/*
+ * Function:  add_walking_distance 
+ * --------------------
+ * Append a new key to the walking distance tables
+ *    
+ *  wd: The walking distance tables
+ *  key: The key, not in the tables yet
+ *  distance: Number of moves from the goal key
+ * 
+ *  returns: the index of the key, or -1 if there is not enough memory
+ */
+int add_walking_distance(WalkingDistance *wd, uint64_t key, int distance){
+	unsigned long slot;
+	int capacity;
+	void *grown;
+	if (2 * (wd->num_states + 1) > (int) WALKING_DISTANCE_TABLE_SIZE){
+		return -1;
+	}
+	if (wd->num_states == wd->capacity){
+		capacity = (wd->capacity == 0) ? 1024 : 2 * wd->capacity;
+		grown = realloc(wd->keys, sizeof(uint64_t) * capacity);
+		if (grown == NULL){
+			return -1;
+		}
+		wd->keys = (uint64_t *) grown;
+		grown = realloc(wd->distance, sizeof(unsigned char) * capacity);
+		if (grown == NULL){
+			return -1;
+		}
+		wd->distance = (unsigned char *) grown;
+		grown = realloc(wd->next, sizeof(int) * capacity * 2 * wd->N);
+		if (grown == NULL){
+			return -1;
+		}
+		wd->next = (int *) grown;
+		wd->capacity = capacity;
+	}
+	wd->keys[wd->num_states] = key;
+	wd->distance[wd->num_states] = (unsigned char) distance;
+	slot = (unsigned long) ((key * (uint64_t) 0x9E3779B97F4A7C15UL) >> 48);
+	while (wd->table[slot] != -1){
+		slot = (slot + 1) & (WALKING_DISTANCE_TABLE_SIZE - 1);
+	}
+	wd->table[slot] = wd->num_states;
+	wd->num_states++;
+	return wd->num_states - 1;
+}
+
+/*
+ * Function:  build_walking_distance 
+ * --------------------
+ * Breadth-first search over walking distance keys from the goal key. A move takes one tile 
+ * from the line next to 'x' into the line of 'x', so only the counts matter, not the order 
+ * of the tiles within a line
+ *    
+ *  wd: The walking distance tables (output)
+ *  goal_key: walking_distance_key() of the goal
+ *  N: width and height of the board (at most MAX_WALKING_DISTANCE_N)
+ * 
+ *  returns: 0, or -1 if there is not enough memory
+ */
+int build_walking_distance(WalkingDistance *wd, uint64_t goal_key, int N){
+	int index, direction, group, next_index, blank_line, next_line;
+	int blank_shift = 3 * MAX_WALKING_DISTANCE_N * MAX_WALKING_DISTANCE_N;
+	unsigned long i;
+	uint64_t key, next_key;
+	
+	wd->N = N;
+	wd->num_states = 0;
+	wd->capacity = 0;
+	wd->keys = NULL;
+	wd->distance = NULL;
+	wd->next = NULL;
+	wd->table = (int *) malloc(sizeof(int) * WALKING_DISTANCE_TABLE_SIZE);
+	if (wd->table == NULL){
+		return -1;
+	}
+	for (i = 0; i < WALKING_DISTANCE_TABLE_SIZE; i++){
+		wd->table[i] = -1;
+	}
+	if (add_walking_distance(wd, goal_key, 0) == -1){
+		return -1;
+	}
+	
+	/* The tables double as the queue: keys are appended in order of distance */
+	for (index = 0; index < wd->num_states; index++){
+		key = wd->keys[index];
+		blank_line = (int) (key >> blank_shift);
+		for (direction = 0; direction < 2; direction++){
+			next_line = (direction == 0) ? blank_line - 1 : blank_line + 1;
+			for (group = 0; group < N; group++){
+				if ((next_line < 0) || (next_line >= N) || (((key >> (3 * (next_line * N + group))) & 7) == 0)){
+					wd->next[(index*2 + direction)*N + group] = -1;
+					continue;
+				}
+				next_key = key - ((uint64_t) 1 << (3 * (next_line * N + group))) 
+					+ ((uint64_t) 1 << (3 * (blank_line * N + group)));
+				next_key = (next_key & (((uint64_t) 1 << blank_shift) - 1)) | ((uint64_t) next_line << blank_shift);
+				next_index = find_walking_distance(wd, next_key);
+				if (next_index == -1){
+					next_index = add_walking_distance(wd, next_key, wd->distance[index] + 1);
+					if (next_index == -1){
+						return -1;
+					}
+				}
+				wd->next[(index*2 + direction)*N + group] = next_index;
+			}
+		}
+	}
+	return 0;
+}
+
+/*
+ * Function:  free_walking_distance 
+ * --------------------
+ * Free the walking distance tables
+ *    
+ *  wd: The walking distance tables
+ * 
+ *  returns: 0
+ */
+int free_walking_distance(WalkingDistance *wd){
+	free(wd->keys);
+	free(wd->distance);
+	free(wd->next);
+	free(wd->table);
+	wd->keys = NULL;
+	wd->distance = NULL;
+	wd->next = NULL;
+	wd->table = NULL;
+	wd->num_states = 0;
+	return 0;
+}
+
+/*
+ * Function:  symmetric_cell 
+ * --------------------
+ * Map a cell through one of the 8 symmetries of the square board
+ *    
+ *  cell: The cell, row * N + column
+ *  N: width and height of the board 
+ *  symmetry: 0 to 7. Bit 0 swaps rows and columns, then bit 1 flips the rows and bit 2 the 
+ *            columns. 0 leaves the cell where it is
+ * 
+ *  returns: the cell it is mapped to
+ */
+int symmetric_cell(int cell, int N, int symmetry){
+	int row = cell / N, col = cell % N, swap;
+	if (symmetry & 1){
+		swap = row;
+		row = col;
+		col = swap;
+	}
+	if (symmetry & 2){
+		row = N - 1 - row;
+	}
+	if (symmetry & 4){
+		col = N - 1 - col;
+	}
+	return row * N + col;
+}
+
+/*
+ * Function:  default_partition 
+ * --------------------
+ * Split the tiles into patterns. On the 4x4 board these are the usual 6-6-3 blocks by goal 
+ * position: the left column with the middle two cells of rows 2 and 3, the lower right 
+ * corner, and the rest of the top row (1,5,6,9,10,13 / 7,8,11,12,14,15 / 2,3,4 for the 
+ * standard goal). The blank's cell must fall in the 7-cell block for the split to be 6-6-3, 
+ * so the blocks are turned or mirrored until it does (every cell of the board can be mapped 
+ * into that block). Other boards get the tiles in goal order, cut into groups of DEFAULT_PATTERN_SIZE
+ *    
+ *  goal: The goal
+ *  N: width and height of the board 
+ *  num_tiles: Number of tiles in each pattern (output)
+ *  tiles: The tiles of each pattern (output)
+ * 
+ *  returns: the number of patterns
+ */
+int default_partition(const int **goal, int N, int *num_tiles, int tiles[][MAX_PATTERN_SIZE]){
+	static const int BLOCKS_4X4[16] = {0, 2, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 1, 1, 1};
+	int cell, tile, pattern, symmetry = 0, count = 0, num_patterns = 0;
+	for (pattern = 0; pattern < MAX_PATTERNS; pattern++){
+		num_tiles[pattern] = 0;
+	}
+	if (N == 4){
+		for (cell = 0; cell < N*N; cell++){
+			if (goal[cell / N][cell % N] == 0){
+				break;
+			}
+		}
+		while ((symmetry < 7) && (BLOCKS_4X4[symmetric_cell(cell, N, symmetry)] != 1)){
+			symmetry++;
+		}
+	}
+	for (cell = 0; cell < N*N; cell++){
+		tile = goal[cell / N][cell % N];
+		if (tile == 0){
+			continue;
+		}
+		pattern = (N == 4) ? BLOCKS_4X4[symmetric_cell(cell, N, symmetry)] : count / DEFAULT_PATTERN_SIZE;
+		tiles[pattern][num_tiles[pattern]] = tile;
+		num_tiles[pattern]++;
+		count++;
+		if (pattern + 1 > num_patterns){
+			num_patterns = pattern + 1;
+		}
+	}
+	return num_patterns;
+}
+
+/*
+ * Function:  parse_partition 
+ * --------------------
+ * Read a partition given on the command line, such as "1,5,6,9,10,13/7,8,11,12,14,15/2,3,4". 
+ * Every tile must be in exactly one pattern
+ *    
+ *  spec: The partition, patterns separated by '/' and tiles by ','
+ *  N: width and height of the board 
+ *  num_tiles: Number of tiles in each pattern (output)
+ *  tiles: The tiles of each pattern (output)
+ * 
+ *  returns: the number of patterns, or -1 if the partition is not valid
+ */
+int parse_partition(const char *spec, int N, int *num_tiles, int tiles[][MAX_PATTERN_SIZE]){
+	int seen[MAX_PATTERN_DATABASE_N * MAX_PATTERN_DATABASE_N];
+	int i, tile, length, num_patterns = 1;
+	for (i = 0; i < N*N; i++){
+		seen[i] = 0;
+	}
+	for (i = 0; i < MAX_PATTERNS; i++){
+		num_tiles[i] = 0;
+	}
+	while (*spec != '\0'){
+		if (sscanf(spec, "%d%n", &tile, &length) != 1){
+			return -1;
+		}
+		spec += length;
+		if ((tile <= 0) || (tile >= N*N) || seen[tile] || (num_tiles[num_patterns - 1] == MAX_PATTERN_SIZE)){
+			return -1;
+		}
+		seen[tile] = 1;
+		tiles[num_patterns - 1][num_tiles[num_patterns - 1]] = tile;
+		num_tiles[num_patterns - 1]++;
+		if (*spec == '/'){
+			if (num_patterns == MAX_PATTERNS){
+				return -1;
+			}
+			num_patterns++;
+			spec++;
+		} else if (*spec == ','){
+			spec++;
+		} else if (*spec != '\0'){
+			return -1;
+		}
+	}
+	for (i = 1; i < N*N; i++){
+		if (!seen[i]){
+			return -1;
+		}
+	}
+	return num_patterns;
+}
+
+/*
+ * Function:  set_patterns 
+ * --------------------
+ * Fill in a pattern database from its partition: which pattern each tile belongs to and 
+ * how many entries each table has. The tables themselves are not touched
+ *    
+ *  pdb: The pattern database
+ *  N: width and height of the board 
+ *  num_patterns: Number of patterns
+ *  num_tiles: Number of tiles in each pattern
+ *  tiles: The tiles of each pattern
+ * 
+ *  returns: 0
+ */
+int set_patterns(PatternDatabase *pdb, int N, int num_patterns, const int *num_tiles, 
+	const int tiles[][MAX_PATTERN_SIZE]){
+	int pattern, i;
+	pdb->N = N;
+	pdb->num_patterns = num_patterns;
+	pdb->pattern_of[0] = -1;
+	for (pattern = 0; pattern < num_patterns; pattern++){
+		pdb->num_tiles[pattern] = num_tiles[pattern];
+		pdb->num_entries[pattern] = 1;
+		for (i = 0; i < num_tiles[pattern]; i++){
+			pdb->tiles[pattern][i] = tiles[pattern][i];
+			pdb->pattern_of[tiles[pattern][i]] = pattern;
+			pdb->slot_of[tiles[pattern][i]] = i;
+			pdb->num_entries[pattern] *= (unsigned long) (N*N - i);
+		}
+		pdb->tables[pattern] = NULL;
+	}
+	return 0;
+}
+
+/*
+ * Function:  pattern_rank 
+ * --------------------
+ * Index of a placement of the tiles of a pattern. The i-th tile is numbered among the 
+ * cells not taken by the tiles before it, so the indices run from 0 to 
+ * (N*N)! / (N*N - num_tiles)! - 1 without gaps
+ *    
+ *  pdb: The pattern database
+ *  pattern: The pattern
+ *  positions: Position (row*N + col) of each tile of the pattern, in pattern order
+ * 
+ *  returns: the index
+ */
+unsigned long pattern_rank(const PatternDatabase *pdb, int pattern, const int *positions){
+	unsigned long rank = 0;
+	int i, j, smaller;
+	for (i = 0; i < pdb->num_tiles[pattern]; i++){
+		smaller = 0;
+		for (j = 0; j < i; j++){
+			if (positions[j] < positions[i]){
+				smaller++;
+			}
+		}
+		rank = rank * (unsigned long) (pdb->N * pdb->N - i) + (unsigned long) (positions[i] - smaller);
+	}
+	return rank;
+}
+
+/*
+ * Function:  pattern_unrank 
+ * --------------------
+ * The placement of a pattern with a given index (the reverse of pattern_rank)
+ *    
+ *  pdb: The pattern database
+ *  pattern: The pattern
+ *  rank: The index
+ *  positions: Position of each tile of the pattern, in pattern order (output)
+ * 
+ *  returns: 0
+ */
+int pattern_unrank(const PatternDatabase *pdb, int pattern, unsigned long rank, int *positions){
+	int used[MAX_PATTERN_DATABASE_N * MAX_PATTERN_DATABASE_N];
+	int i, cell, free_cells, num_cells = pdb->N * pdb->N;
+	for (i = pdb->num_tiles[pattern] - 1; i >= 0; i--){
+		positions[i] = (int) (rank % (unsigned long) (num_cells - i));
+		rank /= (unsigned long) (num_cells - i);
+	}
+	for (cell = 0; cell < num_cells; cell++){
+		used[cell] = 0;
+	}
+	for (i = 0; i < pdb->num_tiles[pattern]; i++){
+		free_cells = positions[i];
+		for (cell = 0; used[cell] || (free_cells > 0); cell++){
+			if (!used[cell]){
+				free_cells--;
+			}
+		}
+		positions[i] = cell;
+		used[cell] = 1;
+	}
+	return 0;
+}
+
+/*
+ * Function:  pattern_entry 
+ * --------------------
+ * Read an entry of a pattern table. Two entries of 4 bits share a byte
+ *    
+ *  pdb: The pattern database
+ *  pattern: The pattern
+ *  rank: Index of the placement (see pattern_rank)
+ * 
+ *  returns: the entry
+ */
+int pattern_entry(const PatternDatabase *pdb, int pattern, unsigned long rank){
+	return (pdb->tables[pattern][rank >> 1] >> (4 * (rank & 1))) & 0xF;
+}
+
+/*
+ * Function:  build_pattern 
+ * --------------------
+ * Fill the table of one pattern by a breadth-first search backwards from the goal. A state 
+ * is the placement of the pattern plus the position of 'x'. Moving a tile of the pattern 
+ * costs 1 and moving any other tile costs 0, which keeps the patterns additive. Each entry 
+ * is the distance of the placement minus the Manhattan distance of its tiles, halved 
+ * (the two always have the same parity) and capped at 15
+ *    
+ *  pdb: The pattern database, partition already set
+ *  pattern: The pattern to build
+ *  goal_rows: Row position for each of the value in the goal (goal_rows[value] = position)
+ *  goal_cols: Column position for each of the value in the goal (goal_cols[value] = position)
+ *  table: The table, (num_entries + 1) / 2 bytes (output)
+ * 
+ *  returns: 0, or -1 if there is not enough memory
+ */
+int build_pattern(const PatternDatabase *pdb, int pattern, const int *goal_rows, const int *goal_cols, 
+	unsigned char *table){
+	int N = pdb->N;
+	int num_cells = N*N;
+	int num_tiles = pdb->num_tiles[pattern];
+	unsigned long num_entries = pdb->num_entries[pattern];
+	unsigned char *distance;
+	unsigned long *current, *next, *temp;
+	unsigned long num_current, num_next = 0, capacity_current, capacity_next, k;
+	unsigned long rank, index, index_2;
+	int positions[MAX_PATTERN_SIZE], positions_2[MAX_PATTERN_SIZE];
+	int slots[MAX_PATTERN_DATABASE_N * MAX_PATTERN_DATABASE_N];
+	int stack[MAX_PATTERN_DATABASE_N * MAX_PATTERN_DATABASE_N];
+	int i, blank, cell, tile, level, stack_size, min_distance, manhattan, extra;
+	int status = -1;
+	void *grown;
+	
+	/* distance[rank*num_cells + blank]: 0xFF if not reached yet, the level with PATTERN_PENDING set 
+	   while the state waits in a list, the plain level once the state has been expanded */
+	distance = (unsigned char *) malloc(sizeof(unsigned char) * num_entries * num_cells);
+	capacity_current = 1024;
+	capacity_next = 1024;
+	current = (unsigned long *) malloc(sizeof(unsigned long) * capacity_current);
+	next = (unsigned long *) malloc(sizeof(unsigned long) * capacity_next);
+	if ((distance == NULL) || (current == NULL) || (next == NULL)){
+		goto CLEANUP;
+	}
+	memset(distance, 0xFF, num_entries * num_cells);
+	
+	for (i = 0; i < num_tiles; i++){
+		tile = pdb->tiles[pattern][i];
+		positions[i] = goal_rows[tile] * N + goal_cols[tile];
+	}
+	index = pattern_rank(pdb, pattern, positions) * num_cells + goal_rows[0] * N + goal_cols[0];
+	distance[index] = PATTERN_PENDING;
+	current[0] = index;
+	num_current = 1;
+	
+	for (level = 0; num_current > 0; level++){
+		if (level + 1 >= PATTERN_PENDING){
+			goto CLEANUP;
+		}
+		for (k = 0; k < num_current; k++){
+			if (distance[current[k]] != (PATTERN_PENDING | level)){
+				/* Already expanded, from another state with the same placement */
+				continue;
+			}
+			rank = current[k] / num_cells;
+			pattern_unrank(pdb, pattern, rank, positions);
+			for (cell = 0; cell < num_cells; cell++){
+				slots[cell] = -1;
+			}
+			for (i = 0; i < num_tiles; i++){
+				slots[positions[i]] = i;
+			}
+			
+			/* Everywhere 'x' can go without moving a tile of the pattern is at the same level */
+			stack[0] = (int) (current[k] % num_cells);
+			distance[current[k]] = (unsigned char) level;
+			stack_size = 1;
+			while (stack_size > 0){
+				stack_size--;
+				blank = stack[stack_size];
+				for (i = 0; i < NUM_OF_POSSIBLE_MOVES; i++){
+					if (((i == 0) && (blank / N == 0)) || ((i == 1) && (blank / N == N - 1)) 
+						|| ((i == 2) && (blank % N == 0)) || ((i == 3) && (blank % N == N - 1))){
+						continue;
+					}
+					cell = blank + ((i == 0) ? -N : (i == 1) ? N : (i == 2) ? -1 : 1);
+					if (slots[cell] == -1){
+						index_2 = rank * num_cells + cell;
+						if (distance[index_2] & PATTERN_PENDING){
+							distance[index_2] = (unsigned char) level;
+							stack[stack_size] = cell;
+							stack_size++;
+						}
+						continue;
+					}
+					memcpy(positions_2, positions, sizeof(int) * num_tiles);
+					positions_2[slots[cell]] = blank;
+					index_2 = pattern_rank(pdb, pattern, positions_2) * num_cells + cell;
+					if (distance[index_2] != 0xFF){
+						continue;
+					}
+					distance[index_2] = (unsigned char) (PATTERN_PENDING | (level + 1));
+					if (num_next == capacity_next){
+						capacity_next *= 2;
+						grown = realloc(next, sizeof(unsigned long) * capacity_next);
+						if (grown == NULL){
+							goto CLEANUP;
+						}
+						next = (unsigned long *) grown;
+					}
+					next[num_next] = index_2;
+					num_next++;
+				}
+			}
+		}
+		temp = current;
+		current = next;
+		next = temp;
+		num_current = num_next;
+		num_next = 0;
+		k = capacity_current;
+		capacity_current = capacity_next;
+		capacity_next = k;
+	}
+	
+	/* The distance of a placement is the smallest over the positions of 'x' */
+	memset(table, 0, (num_entries + 1) / 2);
+	for (rank = 0; rank < num_entries; rank++){
+		min_distance = PATTERN_PENDING;
+		for (blank = 0; blank < num_cells; blank++){
+			if (distance[rank * num_cells + blank] < min_distance){
+				min_distance = distance[rank * num_cells + blank];
+			}
+		}
+		pattern_unrank(pdb, pattern, rank, positions);
+		manhattan = 0;
+		for (i = 0; i < num_tiles; i++){
+			tile = pdb->tiles[pattern][i];
+			manhattan += abs(positions[i] / N - goal_rows[tile]) + abs(positions[i] % N - goal_cols[tile]);
+		}
+		extra = (min_distance - manhattan) / 2;
+		if (extra > 0xF){
+			extra = 0xF;
+		}
+		table[rank >> 1] |= (unsigned char) (extra << (4 * (rank & 1)));
+	}
+	status = 0;
+	
+	CLEANUP: {
+		free(distance);
+		free(current);
+		free(next);
+		return status;
+	}
+}
+
+/*
+ * Function:  goal_fingerprint 
+ * --------------------
+ * FNV-1a hash of the goal position of every tile, stored in a pattern database file so that 
+ * tables built for another goal are refused
+ *    
+ *  goal_rows: Row position for each of the value in the goal (goal_rows[value] = position)
+ *  goal_cols: Column position for each of the value in the goal (goal_cols[value] = position)
+ *  N: width and height of the board 
+ * 
+ *  returns: the fingerprint
+ */
+uint64_t goal_fingerprint(const int *goal_rows, const int *goal_cols, int N){
+	uint64_t hash = (uint64_t) 0xCBF29CE484222325UL;
+	int tile;
+	for (tile = 0; tile < N*N; tile++){
+		hash = (hash ^ (uint64_t) (goal_rows[tile] * N + goal_cols[tile])) * (uint64_t) 0x100000001B3UL;
+	}
+	return hash;
+}
+
+/*
+ * Function:  build_pattern_database 
+ * --------------------
+ * Build the tables of every pattern for a goal and write them to a file
+ *    
+ *  goal: The goal
+ *  N: width and height of the board 
+ *  partition: The partition (see parse_partition), or NULL for default_partition()
+ *  file_name: The file to write
+ * 
+ *  returns: 0, or -1 on failure
+ */
+int build_pattern_database(const int **goal, int N, const char *partition, const char *file_name){
+	PatternDatabase pdb;
+	PatternFileHeader header;
+	int num_tiles[MAX_PATTERNS];
+	int tiles[MAX_PATTERNS][MAX_PATTERN_SIZE];
+	int goal_rows[MAX_PATTERN_DATABASE_N * MAX_PATTERN_DATABASE_N];
+	int goal_cols[MAX_PATTERN_DATABASE_N * MAX_PATTERN_DATABASE_N];
+	int num_patterns, pattern, i, j;
+	unsigned char *table;
+	size_t table_size, offset;
+	FILE *fid;
+	
+	if ((N < 2) || (N > MAX_PATTERN_DATABASE_N)){
+		printf("Pattern databases are only available up to %dx%d! \n", MAX_PATTERN_DATABASE_N, MAX_PATTERN_DATABASE_N);
+		return -1;
+	}
+	if (partition == NULL){
+		num_patterns = default_partition(goal, N, num_tiles, tiles);
+	} else {
+		num_patterns = parse_partition(partition, N, num_tiles, tiles);
+		if (num_patterns < 0){
+			printf("Invalid partition: %s \n", partition);
+			return -1;
+		}
+	}
+	for (i = 0; i < N; i++){
+		for (j = 0; j < N; j++){
+			goal_rows[goal[i][j]] = i;
+			goal_cols[goal[i][j]] = j;
+		}
+	}
+	set_patterns(&pdb, N, num_patterns, (const int *) num_tiles, (const int (*)[MAX_PATTERN_SIZE]) tiles);
+	
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, PATTERN_FILE_MAGIC, sizeof(header.magic));
+	header.version = PATTERN_FILE_VERSION;
+	header.N = N;
+	header.goal_fingerprint = goal_fingerprint(goal_rows, goal_cols, N);
+	header.num_patterns = num_patterns;
+	offset = sizeof(header);
+	for (pattern = 0; pattern < num_patterns; pattern++){
+		header.num_tiles[pattern] = num_tiles[pattern];
+		for (i = 0; i < num_tiles[pattern]; i++){
+			header.tiles[pattern][i] = tiles[pattern][i];
+		}
+		offset = (offset + PATTERN_TABLE_ALIGNMENT - 1) / PATTERN_TABLE_ALIGNMENT * PATTERN_TABLE_ALIGNMENT;
+		header.table_offsets[pattern] = (uint64_t) offset;
+		offset += (pdb.num_entries[pattern] + 1) / 2;
+	}
+	fid = fopen(file_name, "wb");
+	if (fid == NULL){
+		printf("Cannot write %s \n", file_name);
+		return -1;
+	}
+	if (fwrite(&header, sizeof(header), 1, fid) != 1){
+		printf("Cannot write %s \n", file_name);
+		fclose(fid);
+		return -1;
+	}
+	offset = sizeof(header);
+	for (pattern = 0; pattern < num_patterns; pattern++){
+		for (; offset < header.table_offsets[pattern]; offset++){
+			fputc(0, fid);
+		}
+		table_size = (pdb.num_entries[pattern] + 1) / 2;
+		table = (unsigned char *) malloc(table_size);
+		if ((table == NULL) || (build_pattern(&pdb, pattern, goal_rows, goal_cols, table) != 0)){
+			printf("Out of memory! \n");
+			free(table);
+			fclose(fid);
+			return -1;
+		}
+		if (fwrite(table, 1, table_size, fid) != table_size){
+			printf("Cannot write %s \n", file_name);
+			free(table);
+			fclose(fid);
+			return -1;
+		}
+		printf("Pattern %d: %d tiles, %lu entries \n", pattern, num_tiles[pattern], pdb.num_entries[pattern]);
+		offset += table_size;
+		free(table);
+	}
+	if (fclose(fid) != 0){
+		printf("Cannot write %s \n", file_name);
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Function:  load_pattern_database 
+ * --------------------
+ * Map a file written by build_pattern_database() into memory. The mapping is read-only and 
+ * shared, so every solver process on the host uses the same pages of the page cache, and the 
+ * tables are used in place: pages are only read from disk when the search first touches them. 
+ * Lookups jump around the tables, so read-ahead is turned off (see prefault_pattern_database)
+ *    
+ *  pdb: The pattern database (output)
+ *  file_name: The file
+ *  N: width and height of the board 
+ *  fingerprint: goal_fingerprint() of the goal being searched for
+ * 
+ *  returns: 0, or -1 if the file cannot be used for this board and goal
+ */
+int load_pattern_database(PatternDatabase *pdb, const char *file_name, int N, uint64_t fingerprint){
+	const PatternFileHeader *header;
+	struct stat file_stat;
+	size_t offset;
+	int seen[MAX_PATTERN_DATABASE_N * MAX_PATTERN_DATABASE_N];
+	int fid, pattern, i, tile, count;
+	
+	pdb->mapping = NULL;
+	pdb->mapping_size = 0;
+	fid = open(file_name, O_RDONLY);
+	if (fid < 0){
+		printf("Cannot open %s \n", file_name);
+		return -1;
+	}
+	if ((fstat(fid, &file_stat) != 0) || ((size_t) file_stat.st_size < sizeof(PatternFileHeader))){
+		printf("%s is not a pattern database! \n", file_name);
+		close(fid);
+		return -1;
+	}
+	pdb->mapping = mmap(NULL, (size_t) file_stat.st_size, PROT_READ, MAP_SHARED, fid, 0);
+	close(fid);
+	if (pdb->mapping == MAP_FAILED){
+		pdb->mapping = NULL;
+		printf("Cannot map %s \n", file_name);
+		return -1;
+	}
+	pdb->mapping_size = (size_t) file_stat.st_size;
+	
+	posix_madvise(pdb->mapping, pdb->mapping_size, POSIX_MADV_RANDOM);
+	
+	header = (const PatternFileHeader *) pdb->mapping;
+	if (memcmp(header->magic, PATTERN_FILE_MAGIC, sizeof(header->magic)) != 0){
+		printf("%s is not a pattern database! \n", file_name);
+		free_pattern_database(pdb);
+		return -1;
+	}
+	if (header->version != PATTERN_FILE_VERSION){
+		printf("%s has version %d, this solver reads version %d! \n", file_name, header->version, PATTERN_FILE_VERSION);
+		free_pattern_database(pdb);
+		return -1;
+	}
+	if ((N > MAX_PATTERN_DATABASE_N) || (header->N != N) || (header->num_patterns < 1) || (header->num_patterns > MAX_PATTERNS)){
+		printf("%s is not a pattern database for a %dx%d board! \n", file_name, N, N);
+		free_pattern_database(pdb);
+		return -1;
+	}
+	if (header->goal_fingerprint != fingerprint){
+		printf("%s was built for another goal! \n", file_name);
+		free_pattern_database(pdb);
+		return -1;
+	}
+	for (tile = 0; tile < N*N; tile++){
+		seen[tile] = 0;
+	}
+	count = 0;
+	for (pattern = 0; pattern < header->num_patterns; pattern++){
+		if ((header->num_tiles[pattern] < 1) || (header->num_tiles[pattern] > MAX_PATTERN_SIZE)){
+			break;
+		}
+		for (i = 0; i < header->num_tiles[pattern]; i++){
+			tile = header->tiles[pattern][i];
+			if ((tile > 0) && (tile < N*N) && !seen[tile]){
+				seen[tile] = 1;
+				count++;
+			}
+		}
+	}
+	if ((pattern < header->num_patterns) || (count != N*N - 1)){
+		printf("%s is not a pattern database for a %dx%d board! \n", file_name, N, N);
+		free_pattern_database(pdb);
+		return -1;
+	}
+	set_patterns(pdb, N, header->num_patterns, header->num_tiles, (const int (*)[MAX_PATTERN_SIZE]) header->tiles);
+	for (pattern = 0; pattern < pdb->num_patterns; pattern++){
+		offset = (size_t) header->table_offsets[pattern];
+		if ((offset < sizeof(PatternFileHeader)) || (offset > pdb->mapping_size) 
+			|| (pdb->mapping_size - offset < (pdb->num_entries[pattern] + 1) / 2)){
+			printf("%s has the wrong size! \n", file_name);
+			free_pattern_database(pdb);
+			return -1;
+		}
+		pdb->tables[pattern] = (const unsigned char *) pdb->mapping + offset;
+	}
+	return 0;
+}
+
+/*
+ * Function:  prefault_pattern_database 
+ * --------------------
+ * Read every page of a pattern database in before the search starts, so that the time 
+ * to load the tables from disk is not counted as search time
+ *    
+ *  pdb: The pattern database
+ * 
+ *  returns: 0
+ */
+int prefault_pattern_database(const PatternDatabase *pdb){
+	const volatile unsigned char *bytes = (const volatile unsigned char *) pdb->mapping;
+	size_t offset, page_size = (size_t) sysconf(_SC_PAGESIZE);
+	posix_madvise(pdb->mapping, pdb->mapping_size, POSIX_MADV_WILLNEED);
+	for (offset = 0; offset < pdb->mapping_size; offset += page_size){
+		bytes[offset];
+	}
+	return 0;
+}
+
+/*
+ * Function:  free_pattern_database 
+ * --------------------
+ * Unmap the tables of a pattern database
+ *    
+ *  pdb: The pattern database
+ * 
+ *  returns: 0
+ */
+int free_pattern_database(PatternDatabase *pdb){
+	if (pdb->mapping != NULL){
+		munmap(pdb->mapping, pdb->mapping_size);
+	}
+	pdb->mapping = NULL;
+	pdb->mapping_size = 0;
+	return 0;
+}
+
+/*
+ * Function:  packed_pattern_rank 
+ * --------------------
+ * Index of the placement of a pattern on a packed board
+ *    
+ *  pdb: The pattern database
+ *  pattern: The pattern
+ *  board: The packed board
+ * 
+ *  returns: the index (see pattern_rank)
+ */
+unsigned long packed_pattern_rank(const PatternDatabase *pdb, int pattern, uint64_t board){
+	int positions[MAX_PATTERN_SIZE];
+	int cell, tile;
+	for (cell = 0; cell < pdb->N * pdb->N; cell++){
+		tile = (int) ((board >> (4 * cell)) & 0xF);
+		if ((tile != 0) && (pdb->pattern_of[tile] == pattern)){
+			positions[pdb->slot_of[tile]] = cell;
+		}
+	}
+	return pattern_rank(pdb, pattern, positions);
+}
+
+/*
+ * Function:  board_pattern_rank 
+ * --------------------
+ * Index of the placement of a pattern, from the position of each tile
+ *    
+ *  pdb: The pattern database
+ *  pattern: The pattern
+ *  rows: Row position of each tile (rows[value] = position)
+ *  cols: Column position of each tile
+ * 
+ *  returns: the index (see pattern_rank)
+ */
+unsigned long board_pattern_rank(const PatternDatabase *pdb, int pattern, const int *rows, const int *cols){
+	int positions[MAX_PATTERN_SIZE];
+	int i, tile;
+	for (i = 0; i < pdb->num_tiles[pattern]; i++){
+		tile = pdb->tiles[pattern][i];
+		positions[i] = rows[tile] * pdb->N + cols[tile];
+	}
+	return pattern_rank(pdb, pattern, positions);
+}
+
+/*
+ * Function:  pattern_ranks 
+ * --------------------
+ * Index of the placement of every pattern on a board
+ *    
+ *  pdb: The pattern database
+ *  tiles: The board, tiles[row*N + col]
+ *  ranks: The index for each pattern (output)
+ * 
+ *  returns: 0
+ */
+int pattern_ranks(const PatternDatabase *pdb, const int *tiles, unsigned long *ranks){
+	int rows[MAX_PATTERN_DATABASE_N * MAX_PATTERN_DATABASE_N];
+	int cols[MAX_PATTERN_DATABASE_N * MAX_PATTERN_DATABASE_N];
+	int cell, pattern;
+	for (cell = 0; cell < pdb->N * pdb->N; cell++){
+		rows[tiles[cell]] = cell / pdb->N;
+		cols[tiles[cell]] = cell % pdb->N;
+	}
+	for (pattern = 0; pattern < pdb->num_patterns; pattern++){
+		ranks[pattern] = board_pattern_rank(pdb, pattern, (const int *) rows, (const int *) cols);
+	}
+	return 0;
+}
+
+/*
+ * Function:  new_move_table 
+ * --------------------
+ * Tabulate the moves of 'x' from each position, and what each of them does to the Manhattan distance 
+ * of the tile it swaps with, so that the search makes a child with lookups instead of bounds checks
+ *    
+ *  moves: The tables (output)
+ *  goal_rows: Row position for each of the value in the goal (goal_rows[value] = position)
+ *  goal_cols: Column position for each of the value in the goal (goal_cols[value] = position)
+ *  N: width and height of the board 
+ * 
+ *  returns: 0, or -1 if there is not enough memory
+ */
+int new_move_table(MoveTable *moves, const int *goal_rows, const int *goal_cols, int N){
+	static const char MOVES[NUM_OF_POSSIBLE_MOVES] = {'u', 'd', 'l', 'r'};
+	static const int ROW_STEPS[NUM_OF_POSSIBLE_MOVES] = {-1, 1, 0, 0};
+	static const int COL_STEPS[NUM_OF_POSSIBLE_MOVES] = {0, 0, -1, 1};
+	Successor *successor;
+	int blank, direction, k, row, col, tile;
+	moves->N = N;
+	moves->successors = (Successor *) malloc(sizeof(Successor) * N * N * NUM_OF_POSSIBLE_MOVES);
+	moves->num_successors = (int *) malloc(sizeof(int) * N * N);
+	moves->manhattan_delta = (signed char *) malloc(sizeof(signed char) * N * N * NUM_OF_POSSIBLE_MOVES * N * N);
+	if ((moves->successors == NULL) || (moves->num_successors == NULL) || (moves->manhattan_delta == NULL)){
+		free_move_table(moves);
+		return -1;
+	}
+	for (blank = 0; blank < N*N; blank++){
+		k = 0;
+		for (direction = 0; direction < NUM_OF_POSSIBLE_MOVES; direction++){
+			row = blank / N + ROW_STEPS[direction];
+			col = blank % N + COL_STEPS[direction];
+			if ((row < 0) || (row >= N) || (col < 0) || (col >= N)){
+				continue;
+			}
+			successor = &moves->successors[blank * NUM_OF_POSSIBLE_MOVES + k];
+			successor->move = MOVES[direction];
+			successor->direction = direction;
+			successor->blank = row * N + col;
+			successor->row = row;
+			successor->col = col;
+			for (tile = 0; tile < N*N; tile++){
+				/* The tile goes from (row, col) to where 'x' was */
+				moves->manhattan_delta[(blank * NUM_OF_POSSIBLE_MOVES + k) * N * N + tile] = (signed char) (
+					abs(blank / N - goal_rows[tile]) + abs(blank % N - goal_cols[tile]) 
+					- abs(row - goal_rows[tile]) - abs(col - goal_cols[tile]));
+			}
+			k++;
+		}
+		moves->num_successors[blank] = k;
+	}
+	return 0;
+}
+
+/*
+ * Function:  free_move_table 
+ * --------------------
+ * Free the tables made by new_move_table
+ *    
+ *  moves: The tables
+ * 
+ *  returns: 0
+ */
+int free_move_table(MoveTable *moves){
+	free(moves->successors);
+	free(moves->num_successors);
+	free(moves->manhattan_delta);
+	moves->successors = NULL;
+	moves->num_successors = NULL;
+	moves->manhattan_delta = NULL;
+	return 0;
+}
+
+/*
+ * Function:  automaton_zobrist 
+ * --------------------
+ * Random number for a tile at a position of the board the move sequences are tried on 
+ * (splitmix64 of the pair, so nothing needs to be stored)
+ *    
+ *  seed: Which of the two keys (see learn_sequences)
+ *  tile: The tile, named after its starting position
+ *  position: Its position
+ *  width: Width of the board
+ * 
+ *  returns: the number
+ */
+uint64_t automaton_zobrist(int seed, int tile, int position, int width){
+	uint64_t z = ((uint64_t) (tile * width * width + position) + 1) * (uint64_t) 0x9E3779B97F4A7C15UL 
+		+ (uint64_t) seed * (uint64_t) 0xD1B54A32D192ED03UL;
+	z = (z ^ (z >> 30)) * (uint64_t) 0xBF58476D1CE4E5B9UL;
+	z = (z ^ (z >> 27)) * (uint64_t) 0x94D049BB133111EBUL;
+	return z ^ (z >> 31);
+}
+
+/*
+ * Function:  is_pruned_sequence 
+ * --------------------
+ * Whether a move sequence was found to be redundant
+ *    
+ *  learner: The learner
+ *  code: The sequence, 2 bits per move after a leading 1 bit
+ * 
+ *  returns: 1 if it was, else 0
+ */
+int is_pruned_sequence(const AutomatonLearner *learner, uint64_t code){
+	unsigned long slot = (unsigned long) ((code * (uint64_t) 0x9E3779B97F4A7C15UL) >> 32) & learner->pruned_mask;
+	while (learner->pruned[slot] != 0){
+		if (learner->pruned[slot] == code){
+			return 1;
+		}
+		slot = (slot + 1) & learner->pruned_mask;
+	}
+	return 0;
+}
+
+/*
+ * Function:  add_pruned_sequence 
+ * --------------------
+ * Record a redundant move sequence, growing the table when it is half full
+ *    
+ *  learner: The learner
+ *  code: The sequence, 2 bits per move after a leading 1 bit
+ * 
+ *  returns: 0, or -1 if there is not enough memory
+ */
+int add_pruned_sequence(AutomatonLearner *learner, uint64_t code){
+	uint64_t *old_pruned = learner->pruned;
+	unsigned long old_mask = learner->pruned_mask;
+	unsigned long slot;
+	if (2 * (learner->num_pruned + 1) > learner->pruned_mask + 1){
+		learner->pruned = (uint64_t *) calloc(2 * (old_mask + 1), sizeof(uint64_t));
+		if (learner->pruned == NULL){
+			learner->pruned = old_pruned;
+			return -1;
+		}
+		learner->pruned_mask = 2 * old_mask + 1;
+		learner->num_pruned = 0;
+		for (slot = 0; slot <= old_mask; slot++){
+			if (old_pruned[slot] != 0){
+				add_pruned_sequence(learner, old_pruned[slot]);
+			}
+		}
+		free(old_pruned);
+	}
+	slot = (unsigned long) ((code * (uint64_t) 0x9E3779B97F4A7C15UL) >> 32) & learner->pruned_mask;
+	while (learner->pruned[slot] != 0){
+		slot = (slot + 1) & learner->pruned_mask;
+	}
+	learner->pruned[slot] = code;
+	learner->num_pruned++;
+	return 0;
+}
+
+/*
+ * Function:  reach_board 
+ * --------------------
+ * Look for a sequence kept so far that leads to the same board as a new one, with 'x' staying 
+ * within the rows and columns the new one visits. The new sequence comes later in the order 
+ * of learn_sequences, so it is redundant if there is one. Otherwise it is kept
+ *    
+ *  learner: The learner
+ *  reached: The board the new sequence leads to and where 'x' went on the way
+ * 
+ *  returns: 1 if the sequence is redundant, 0 if it was kept, -1 if there is not enough memory
+ */
+int reach_board(AutomatonLearner *learner, const ReachedBoard *reached){
+	ReachedBoard *old_boards = learner->reached;
+	const ReachedBoard *board;
+	unsigned long old_mask = learner->reached_mask;
+	unsigned long slot;
+	slot = (unsigned long) (reached->key[0] >> 32) & learner->reached_mask;
+	for (; learner->reached[slot].used; slot = (slot + 1) & learner->reached_mask){
+		board = &learner->reached[slot];
+		if ((board->key[0] == reached->key[0]) && (board->key[1] == reached->key[1]) 
+			&& (board->box[0] >= reached->box[0]) && (board->box[1] <= reached->box[1]) 
+			&& (board->box[2] >= reached->box[2]) && (board->box[3] <= reached->box[3])){
+			return 1;
+		}
+	}
+	if (2 * (learner->num_reached + 1) > learner->reached_mask + 1){
+		learner->reached = (ReachedBoard *) calloc(2 * (old_mask + 1), sizeof(ReachedBoard));
+		if (learner->reached == NULL){
+			learner->reached = old_boards;
+			return -1;
+		}
+		learner->reached_mask = 2 * old_mask + 1;
+		learner->num_reached = 0;
+		for (slot = 0; slot <= old_mask; slot++){
+			if (old_boards[slot].used){
+				reach_board(learner, &old_boards[slot]);
+			}
+		}
+		free(old_boards);
+	}
+	slot = (unsigned long) (reached->key[0] >> 32) & learner->reached_mask;
+	while (learner->reached[slot].used){
+		slot = (slot + 1) & learner->reached_mask;
+	}
+	learner->reached[slot] = *reached;
+	learner->reached[slot].used = 1;
+	learner->num_reached++;
+	return 0;
+}
+
+/*
+ * Function:  learn_sequences 
+ * --------------------
+ * Try every move sequence of a given length that has no redundant part, depth first with 
+ * the moves in the order u, d, l, r, on a board too wide for 'x' to reach an edge. Taken 
+ * over the lengths from 1 up, the sequences come shortest first and, for one length, in 
+ * alphabetical order. A sequence is redundant if one that comes before it leads to the same 
+ * board (see reach_board), as the search then never needs to go past its last move. Any 
+ * sequence containing it is then redundant too, so sequences are only extended while no 
+ * ending of them is redundant. Each board is named by two independent Zobrist keys, of 
+ * where every tile is against where it started, so that two boards are only taken for the 
+ * same one by chance with odds of about 2^-128
+ *    
+ *  learner: The learner
+ *  length: Moves left to make
+ *  code: The moves so far, 2 bits per move after a leading 1 bit
+ *  num_moves: Number of moves so far
+ *  reached: The board after them and where 'x' went on the way
+ *  blank: Position of 'x'
+ * 
+ *  returns: 0, or -1 if there is not enough memory
+ */
+int learn_sequences(AutomatonLearner *learner, int length, uint64_t code, int num_moves, 
+	const ReachedBoard *reached, int blank){
+	static const int ROW_STEPS[NUM_OF_POSSIBLE_MOVES] = {-1, 1, 0, 0};
+	static const int COL_STEPS[NUM_OF_POSSIBLE_MOVES] = {0, 0, -1, 1};
+	ReachedBoard next;
+	uint64_t next_code, ending;
+	int direction, i, tile, new_blank, row, col, redundant, status = 0;
+	int width = learner->width;
+	int center = learner->depth;
+	
+	if (length == 0){
+		status = reach_board(learner, reached);
+		if (status == 1){
+			status = add_pruned_sequence(learner, code);
+		}
+		return status;
+	}
+	for (direction = 0; (direction < NUM_OF_POSSIBLE_MOVES) && (status == 0); direction++){
+		next_code = (code << 2) | (uint64_t) direction;
+		redundant = 0;
+		for (i = 1; (i <= num_moves + 1) && !redundant; i++){
+			ending = ((uint64_t) 1 << (2 * i)) | (next_code & (((uint64_t) 1 << (2 * i)) - 1));
+			redundant = is_pruned_sequence(learner, ending);
+		}
+		if (redundant){
+			continue;
+		}
+		row = blank / width + ROW_STEPS[direction];
+		col = blank % width + COL_STEPS[direction];
+		new_blank = row * width + col;
+		next = *reached;
+		if (row - center < next.box[0]){
+			next.box[0] = (signed char) (row - center);
+		}
+		if (row - center > next.box[1]){
+			next.box[1] = (signed char) (row - center);
+		}
+		if (col - center < next.box[2]){
+			next.box[2] = (signed char) (col - center);
+		}
+		if (col - center > next.box[3]){
+			next.box[3] = (signed char) (col - center);
+		}
+		
+		/* The tile at new_blank slides to blank */
+		tile = learner->cells[new_blank];
+		for (i = 0; i < 2; i++){
+			next.key[i] ^= automaton_zobrist(i, tile, new_blank, width) ^ automaton_zobrist(i, tile, blank, width);
+		}
+		learner->cells[blank] = tile;
+		learner->cells[new_blank] = -1;
+		status = learn_sequences(learner, length - 1, next_code, num_moves + 1, (const ReachedBoard *) &next, 
+			new_blank);
+		learner->cells[new_blank] = tile;
+		learner->cells[blank] = -1;
+	}
+	return status;
+}
+
+/*
+ * Function:  compile_automaton 
+ * --------------------
+ * Turn the redundant sequences found by learn_sequences into a finite-state machine that 
+ * reads the moves one at a time (Aho-Corasick): a state is the longest ending of the moves 
+ * so far that begins some redundant sequence, and a move that completes one has no state
+ *    
+ *  automaton: The automaton (output)
+ *  learner: The learner, done
+ * 
+ *  returns: 0, or -1 if there is not enough memory or too many states
+ */
+int compile_automaton(MoveAutomaton *automaton, const AutomatonLearner *learner){
+	int *child, *fail, *queue, *pruned;
+	int num_nodes = 1, capacity = 1, head, tail, node, next, direction, i, length, status = -1;
+	unsigned long slot;
+	uint64_t code;
+	
+	for (slot = 0; slot <= learner->pruned_mask; slot++){
+		if (learner->pruned[slot] != 0){
+			for (code = learner->pruned[slot]; code > 1; code >>= 2){
+				capacity++;
+			}
+		}
+	}
+	child = (int *) malloc(sizeof(int) * capacity * NUM_OF_POSSIBLE_MOVES);
+	fail = (int *) malloc(sizeof(int) * capacity);
+	queue = (int *) malloc(sizeof(int) * capacity);
+	pruned = (int *) calloc(capacity, sizeof(int));
+	automaton->next = NULL;
+	if ((child == NULL) || (fail == NULL) || (queue == NULL) || (pruned == NULL)){
+		goto CLEANUP;
+	}
+	
+	/* A trie of the redundant sequences */
+	for (direction = 0; direction < NUM_OF_POSSIBLE_MOVES; direction++){
+		child[direction] = -1;
+	}
+	for (slot = 0; slot <= learner->pruned_mask; slot++){
+		code = learner->pruned[slot];
+		if (code == 0){
+			continue;
+		}
+		for (length = 0; (code >> (2 * length)) > 1; length++){
+		}
+		node = 0;
+		for (i = length - 1; i >= 0; i--){
+			direction = (int) ((code >> (2 * i)) & 3);
+			if (child[node * NUM_OF_POSSIBLE_MOVES + direction] == -1){
+				for (next = 0; next < NUM_OF_POSSIBLE_MOVES; next++){
+					child[num_nodes * NUM_OF_POSSIBLE_MOVES + next] = -1;
+				}
+				child[node * NUM_OF_POSSIBLE_MOVES + direction] = num_nodes++;
+			}
+			node = child[node * NUM_OF_POSSIBLE_MOVES + direction];
+		}
+		pruned[node] = 1;
+	}
+	
+	/* Breadth first, a missing child becomes the transition of the longest proper ending */
+	head = 0;
+	tail = 0;
+	fail[0] = 0;
+	for (direction = 0; direction < NUM_OF_POSSIBLE_MOVES; direction++){
+		next = child[direction];
+		if (next == -1){
+			child[direction] = 0;
+		} else {
+			fail[next] = 0;
+			queue[tail++] = next;
+		}
+	}
+	while (head < tail){
+		node = queue[head++];
+		pruned[node] |= pruned[fail[node]];
+		for (direction = 0; direction < NUM_OF_POSSIBLE_MOVES; direction++){
+			next = child[node * NUM_OF_POSSIBLE_MOVES + direction];
+			if (next == -1){
+				child[node * NUM_OF_POSSIBLE_MOVES + direction] = child[fail[node] * NUM_OF_POSSIBLE_MOVES + direction];
+			} else {
+				fail[next] = child[fail[node] * NUM_OF_POSSIBLE_MOVES + direction];
+				queue[tail++] = next;
+			}
+		}
+	}
+	
+	/* The states are the nodes that end no redundant sequence, numbered in the same order */
+	automaton->num_states = 0;
+	for (node = 0; node < num_nodes; node++){
+		queue[node] = pruned[node] ? -1 : automaton->num_states++;
+	}
+	if (automaton->num_states > MAX_AUTOMATON_STATES){
+		printf("The move automaton needs %d states, more than %d! \n", automaton->num_states, MAX_AUTOMATON_STATES);
+		goto CLEANUP;
+	}
+	automaton->next = (int *) malloc(sizeof(int) * automaton->num_states * NUM_OF_POSSIBLE_MOVES);
+	if (automaton->next == NULL){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	for (node = 0; node < num_nodes; node++){
+		if (queue[node] == -1){
+			continue;
+		}
+		for (direction = 0; direction < NUM_OF_POSSIBLE_MOVES; direction++){
+			automaton->next[queue[node] * NUM_OF_POSSIBLE_MOVES + direction] = 
+				queue[child[node * NUM_OF_POSSIBLE_MOVES + direction]];
+		}
+	}
+	status = 0;
+	CLEANUP: {
+		free(child);
+		free(fail);
+		free(queue);
+		free(pruned);
+		return status;
+	}
+}
+
+/*
+ * Function:  new_move_automaton 
+ * --------------------
+ * Learn which move sequences of up to depth moves are redundant (Taylor and Korf's duplicate 
+ * pruning), and build the automaton that the search steps through with every move instead of 
+ * only checking that the move does not undo the last one. A sequence is redundant if another 
+ * one, shorter or of the same length and earlier in alphabetical order, leads to the same board 
+ * and keeps 'x' within the rows and columns it visits, so that it fits wherever the sequence 
+ * fits. Of all the shortest ways to a board, the first in alphabetical order is then never 
+ * pruned. With depth 2, only the moves that undo the last one are
+ *    
+ *  automaton: The automaton (output)
+ *  depth: Length of the longest sequences tried, 2 to MAX_AUTOMATON_DEPTH
+ * 
+ *  returns: 0, or -1 on failure
+ */
+int new_move_automaton(MoveAutomaton *automaton, int depth){
+	AutomatonLearner learner;
+	ReachedBoard start;
+	int length, i, status = -1;
+	
+	learner.depth = depth;
+	learner.width = 2 * depth + 1;
+	learner.cells = (int *) malloc(sizeof(int) * learner.width * learner.width);
+	learner.reached_mask = 1023;
+	learner.reached = (ReachedBoard *) calloc(learner.reached_mask + 1, sizeof(ReachedBoard));
+	learner.num_reached = 0;
+	learner.pruned_mask = 1023;
+	learner.pruned = (uint64_t *) calloc(learner.pruned_mask + 1, sizeof(uint64_t));
+	learner.num_pruned = 0;
+	automaton->next = NULL;
+	automaton->num_states = 0;
+	if ((learner.cells == NULL) || (learner.reached == NULL) || (learner.pruned == NULL)){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	for (i = 0; i < learner.width * learner.width; i++){
+		learner.cells[i] = i;
+	}
+	learner.cells[depth * learner.width + depth] = -1;
+	memset(&start, 0, sizeof(start));
+	if (reach_board(&learner, (const ReachedBoard *) &start) != 0){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	for (length = 1; length <= depth; length++){
+		if (learn_sequences(&learner, length, 1, 0, (const ReachedBoard *) &start, 
+			depth * learner.width + depth) != 0){
+			printf("Out of memory! \n");
+			goto CLEANUP;
+		}
+	}
+	status = compile_automaton(automaton, (const AutomatonLearner *) &learner);
+	CLEANUP: {
+		free(learner.cells);
+		free(learner.reached);
+		free(learner.pruned);
+		return status;
+	}
+}
+
+/*
+ * Function:  free_move_automaton 
+ * --------------------
+ * Free the transitions of a move automaton
+ *    
+ *  automaton: The automaton
+ * 
+ *  returns: 0
+ */
+int free_move_automaton(MoveAutomaton *automaton){
+	free(automaton->next);
+	automaton->next = NULL;
+	return 0;
+}
+
+/*
+ * Function:  distance_rank 
+ * --------------------
+ * Index of a board in a distance table: the position of 'x', then the order of the other tiles 
+ * read row by row, leaving out the last two. With 'x' at a given position the parity of that 
+ * order is the same on every board the goal can be reached from, so the last two tiles are 
+ * known from the others and the indices run from 0 to N*N * (N*N - 1)! / 2 - 1 without gaps
+ *    
+ *  distances: The distance table
+ *  board: The packed board
+ * 
+ *  returns: the index
+ */
+unsigned long distance_rank(const DistanceTable *distances, uint64_t board){
+	int tiles[MAX_DISTANCE_TABLE_N * MAX_DISTANCE_TABLE_N];
+	unsigned long rank = 0;
+	int i, j, smaller, blank = 0, num_tiles = 0, num_cells = distances->N * distances->N;
+	for (i = 0; i < num_cells; i++){
+		tiles[num_tiles] = (int) ((board >> (4 * i)) & 0xF);
+		if (tiles[num_tiles] == 0){
+			blank = i;
+		} else {
+			num_tiles++;
+		}
+	}
+	for (i = 0; i < num_tiles - 2; i++){
+		smaller = 0;
+		for (j = i + 1; j < num_tiles; j++){
+			if (tiles[j] < tiles[i]){
+				smaller++;
+			}
+		}
+		rank = rank * (unsigned long) (num_tiles - i) + (unsigned long) smaller;
+	}
+	return (unsigned long) blank * (distances->num_entries / (unsigned long) num_cells) + rank;
+}
+
+/*
+ * Function:  distance_entry 
+ * --------------------
+ * Read an entry of a distance table: the number of moves from the board to the goal modulo 
+ * DISTANCE_UNREACHABLE, or DISTANCE_UNREACHABLE itself. Two entries of 4 bits share a byte
+ *    
+ *  distances: The distance table
+ *  rank: Index of the board (see distance_rank)
+ * 
+ *  returns: the entry
+ */
+int distance_entry(const DistanceTable *distances, unsigned long rank){
+	return (distances->entries[rank >> 1] >> (4 * (rank & 1))) & 0xF;
+}
+
+/*
+ * Function:  set_distance_entry 
+ * --------------------
+ * Write an entry of a distance table
+ *    
+ *  distances: The distance table
+ *  rank: Index of the board (see distance_rank)
+ *  entry: The entry
+ * 
+ *  returns: 0
+ */
+int set_distance_entry(DistanceTable *distances, unsigned long rank, int entry){
+	int shift = 4 * (int) (rank & 1);
+	distances->entries[rank >> 1] = (unsigned char) ((distances->entries[rank >> 1] & ~(0xF << shift)) 
+		| (entry << shift));
+	return 0;
+}
+
+/*
+ * Function:  new_distance_table 
+ * --------------------
+ * Set up an empty distance table, with every board unreachable
+ *    
+ *  distances: The distance table (output)
+ *  goal_rows: Row position for each of the value in the goal (goal_rows[value] = position)
+ *  goal_cols: Column position for each of the value in the goal (goal_cols[value] = position)
+ *  N: width and height of the board, at most MAX_DISTANCE_TABLE_N
+ * 
+ *  returns: 0, or -1 if there is not enough memory
+ */
+int new_distance_table(DistanceTable *distances, const int *goal_rows, const int *goal_cols, int N){
+	int i;
+	distances->N = N;
+	distances->max_distance = 0;
+	distances->num_entries = (unsigned long) (N * N);
+	for (i = 3; i < N*N; i++){
+		distances->num_entries *= (unsigned long) i;
+	}
+	distances->entries = (unsigned char *) malloc((distances->num_entries + 1) / 2);
+	if (distances->entries == NULL){
+		return -1;
+	}
+	if (new_move_table(&distances->moves, goal_rows, goal_cols, N) != 0){
+		free(distances->entries);
+		distances->entries = NULL;
+		return -1;
+	}
+	memset(distances->entries, 0xFF, (distances->num_entries + 1) / 2);
+	return 0;
+}
+
+/*
+ * Function:  build_distance_table 
+ * --------------------
+ * Find the number of moves to the goal from every board by a breadth-first search backwards 
+ * from the goal, and write the table to a file
+ *    
+ *  goal: The goal
+ *  N: width and height of the board 
+ *  file_name: The file to write
+ * 
+ *  returns: 0, or -1 on failure
+ */
+int build_distance_table(const int **goal, int N, const char *file_name){
+	DistanceTable distances;
+	DistanceFileHeader header;
+	int goal_rows[MAX_DISTANCE_TABLE_N * MAX_DISTANCE_TABLE_N];
+	int goal_cols[MAX_DISTANCE_TABLE_N * MAX_DISTANCE_TABLE_N];
+	const Successor *successor;
+	uint64_t *queue;
+	uint64_t board, child;
+	unsigned long head, tail, level_end, rank;
+	size_t table_size;
+	int i, j, k, blank, tile, distance = 0, status = -1;
+	FILE *fid;
+	
+	if ((N < 2) || (N > MAX_DISTANCE_TABLE_N)){
+		printf("Distance tables are only available up to %dx%d! \n", MAX_DISTANCE_TABLE_N, MAX_DISTANCE_TABLE_N);
+		return -1;
+	}
+	for (i = 0; i < N; i++){
+		for (j = 0; j < N; j++){
+			goal_rows[goal[i][j]] = i;
+			goal_cols[goal[i][j]] = j;
+		}
+	}
+	if (new_distance_table(&distances, goal_rows, goal_cols, N) != 0){
+		printf("Out of memory! \n");
+		return -1;
+	}
+	/* Each board goes into the queue once, so it never holds more than num_entries */
+	queue = (uint64_t *) malloc(sizeof(uint64_t) * distances.num_entries);
+	if (queue == NULL){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	queue[0] = pack_board(goal, N);
+	set_distance_entry(&distances, distance_rank(&distances, queue[0]), 0);
+	head = 0;
+	tail = 1;
+	level_end = 1; /* The boards at the current distance are queue[head] to queue[level_end - 1] */
+	while (head < tail){
+		if (head == level_end){
+			distance++;
+			level_end = tail;
+		}
+		board = queue[head++];
+		for (blank = 0; ((board >> (4 * blank)) & 0xF) != 0; blank++);
+		for (k = 0; k < distances.moves.num_successors[blank]; k++){
+			successor = &distances.moves.successors[blank * NUM_OF_POSSIBLE_MOVES + k];
+			tile = (int) ((board >> (4 * successor->blank)) & 0xF);
+			child = (board & ~((uint64_t) 0xF << (4 * successor->blank))) | ((uint64_t) tile << (4 * blank));
+			rank = distance_rank(&distances, child);
+			if (distance_entry(&distances, rank) == DISTANCE_UNREACHABLE){
+				set_distance_entry(&distances, rank, (distance + 1) % DISTANCE_UNREACHABLE);
+				queue[tail++] = child;
+			}
+		}
+	}
+	
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, DISTANCE_FILE_MAGIC, sizeof(header.magic));
+	header.version = DISTANCE_FILE_VERSION;
+	header.N = N;
+	header.max_distance = distance;
+	header.goal_fingerprint = goal_fingerprint(goal_rows, goal_cols, N);
+	table_size = (distances.num_entries + 1) / 2;
+	fid = fopen(file_name, "wb");
+	if (fid == NULL){
+		printf("Cannot write %s \n", file_name);
+		goto CLEANUP;
+	}
+	if ((fwrite(&header, sizeof(header), 1, fid) != 1) || (fwrite(distances.entries, 1, table_size, fid) != table_size)){
+		printf("Cannot write %s \n", file_name);
+		fclose(fid);
+		goto CLEANUP;
+	}
+	if (fclose(fid) != 0){
+		printf("Cannot write %s \n", file_name);
+		goto CLEANUP;
+	}
+	printf("Distance table: %lu boards, at most %d moves from the goal \n", tail, distance);
+	status = 0;
+	CLEANUP: {
+		free(queue);
+		free_distance_table(&distances);
+		return status;
+	}
+}
+
+/*
+ * Function:  load_distance_table 
+ * --------------------
+ * Read a file written by build_distance_table()
+ *    
+ *  distances: The distance table (output)
+ *  file_name: The file
+ *  goal_rows: Row position for each of the value in the goal (goal_rows[value] = position)
+ *  goal_cols: Column position for each of the value in the goal (goal_cols[value] = position)
+ *  N: width and height of the board 
+ * 
+ *  returns: 0, or -1 if the file cannot be used for this board and goal
+ */
+int load_distance_table(DistanceTable *distances, const char *file_name, const int *goal_rows, 
+	const int *goal_cols, int N){
+	DistanceFileHeader header;
+	size_t table_size;
+	FILE *fid;
+	
+	fid = fopen(file_name, "rb");
+	if (fid == NULL){
+		printf("Cannot open %s \n", file_name);
+		return -1;
+	}
+	if ((fread(&header, sizeof(header), 1, fid) != 1) 
+		|| (memcmp(header.magic, DISTANCE_FILE_MAGIC, sizeof(header.magic)) != 0)){
+		printf("%s is not a distance table! \n", file_name);
+		fclose(fid);
+		return -1;
+	}
+	if (header.version != DISTANCE_FILE_VERSION){
+		printf("%s has version %d, this solver reads version %d! \n", file_name, header.version, DISTANCE_FILE_VERSION);
+		fclose(fid);
+		return -1;
+	}
+	if ((N > MAX_DISTANCE_TABLE_N) || (header.N != N)){
+		printf("%s is not a distance table for a %dx%d board! \n", file_name, N, N);
+		fclose(fid);
+		return -1;
+	}
+	if (header.goal_fingerprint != goal_fingerprint(goal_rows, goal_cols, N)){
+		printf("%s was built for another goal! \n", file_name);
+		fclose(fid);
+		return -1;
+	}
+	if (new_distance_table(distances, goal_rows, goal_cols, N) != 0){
+		printf("Out of memory! \n");
+		fclose(fid);
+		return -1;
+	}
+	distances->max_distance = header.max_distance;
+	table_size = (distances->num_entries + 1) / 2;
+	if (fread(distances->entries, 1, table_size, fid) != table_size){
+		printf("%s has the wrong size! \n", file_name);
+		free_distance_table(distances);
+		fclose(fid);
+		return -1;
+	}
+	fclose(fid);
+	return 0;
+}
+
+/*
+ * Function:  free_distance_table 
+ * --------------------
+ * Free a distance table
+ *    
+ *  distances: The distance table
+ * 
+ *  returns: 0
+ */
+int free_distance_table(DistanceTable *distances){
+	free(distances->entries);
+	distances->entries = NULL;
+	free_move_table(&distances->moves);
+	return 0;
+}
+
+/*
+ * Function:  solve_by_distances 
+ * --------------------
+ * Solve an instance from a distance table, without searching. Every move takes the board one 
+ * move closer to the goal or one further from it, so the only moves that lead along an optimal 
+ * solution are the ones to a board whose entry is one less, modulo DISTANCE_UNREACHABLE
+ *    
+ *  distances: The distance table, built for this goal
+ *  start: The starting board
+ *  goal: The goal
+ *  solution: Set to the moves of the solution, starting with 'B', to be freed by the caller
+ *  num_expanded: Set to the number of boards on the way, the goal excluded
+ * 
+ *  returns: 0 if a solution was found, 1 if the table has no way to the goal, -1 if out of memory
+ */
+int solve_by_distances(const DistanceTable *distances, int **start, const int **goal, char **solution, 
+	long *num_expanded){
+	const Successor *successor = NULL;
+	uint64_t board, child = 0, packed_goal;
+	int N = distances->N;
+	int k, blank, tile, entry, length = 0;
+	
+	*num_expanded = 0;
+	*solution = (char *) malloc(distances->max_distance + 2);
+	if (*solution == NULL){
+		return -1;
+	}
+	(*solution)[0] = 'B';
+	board = pack_board((const int **) start, N);
+	packed_goal = pack_board(goal, N);
+	entry = distance_entry(distances, distance_rank(distances, board));
+	for (blank = 0; ((board >> (4 * blank)) & 0xF) != 0; blank++);
+	while ((board != packed_goal) && (entry != DISTANCE_UNREACHABLE) && (length < distances->max_distance)){
+		entry = (entry + DISTANCE_UNREACHABLE - 1) % DISTANCE_UNREACHABLE;
+		for (k = 0; k < distances->moves.num_successors[blank]; k++){
+			successor = &distances->moves.successors[blank * NUM_OF_POSSIBLE_MOVES + k];
+			tile = (int) ((board >> (4 * successor->blank)) & 0xF);
+			child = (board & ~((uint64_t) 0xF << (4 * successor->blank))) | ((uint64_t) tile << (4 * blank));
+			if (distance_entry(distances, distance_rank(distances, child)) == entry){
+				break;
+			}
+		}
+		if (k == distances->moves.num_successors[blank]){
+			break;
+		}
+		(*solution)[++length] = successor->move;
+		board = child;
+		blank = successor->blank;
+		(*num_expanded)++;
+	}
+	(*solution)[length + 1] = '\0';
+	if (board != packed_goal){
+		free(*solution);
+		*solution = NULL;
+		return 1;
+	}
+	return 0;
+}
+
+/*
+ * Function:  new_heuristic 
+ * --------------------
+ * Set up a heuristic, building its tables if it has any
+ *    
+ *  heuristic: The heuristic (output)
+ *  kind: HEURISTIC_MANHATTAN, HEURISTIC_LINEAR_CONFLICT or HEURISTIC_WALKING_DISTANCE
+ *  goal_rows: Row position for each of the value in the goal (goal_rows[value] = position)
+ *  goal_cols: Column position for each of the value in the goal (goal_cols[value] = position)
+ *  N: width and height of the board 
+ *  pattern_file: The pattern database, only for HEURISTIC_PATTERN_DATABASE
+ *  automaton: The move automaton the search is to use, kept by the caller
+ * 
+ *  returns: 0, or -1 if the heuristic is not available for this board
+ */
+int new_heuristic(Heuristic *heuristic, int kind, const int *goal_rows, const int *goal_cols, int N, 
+	const char *pattern_file, const MoveAutomaton *automaton){
+	int goal_tiles[MAX_WALKING_DISTANCE_N * MAX_WALKING_DISTANCE_N];
+	int i;
+	heuristic->kind = kind;
+	heuristic->N = N;
+	heuristic->goal_rows = goal_rows;
+	heuristic->goal_cols = goal_cols;
+	heuristic->automaton = automaton;
+	heuristic->rows.table = NULL;
+	heuristic->cols.table = NULL;
+	heuristic->pdb.mapping = NULL;
+	heuristic->moves.successors = NULL;
+	heuristic->moves.num_successors = NULL;
+	heuristic->moves.manhattan_delta = NULL;
+	if (((kind == HEURISTIC_LINEAR_CONFLICT) && (N > MAX_LINE_LENGTH)) 
+		|| ((kind == HEURISTIC_WALKING_DISTANCE) && (N > MAX_WALKING_DISTANCE_N))){
+		return -1;
+	}
+	if (new_move_table(&heuristic->moves, goal_rows, goal_cols, N) != 0){
+		return -1;
+	}
+	if (kind == HEURISTIC_PATTERN_DATABASE){
+		if (load_pattern_database(&heuristic->pdb, pattern_file, N, goal_fingerprint(goal_rows, goal_cols, N)) != 0){
+			free_heuristic(heuristic);
+			return -1;
+		}
+		return 0;
+	}
+	if (kind != HEURISTIC_WALKING_DISTANCE){
+		return 0;
+	}
+	for (i = 0; i < N*N; i++){
+		goal_tiles[goal_rows[i] * N + goal_cols[i]] = i;
+	}
+	if ((build_walking_distance(&heuristic->rows, walking_distance_key(goal_tiles, goal_rows, N, 1), N) != 0)
+		|| (build_walking_distance(&heuristic->cols, walking_distance_key(goal_tiles, goal_cols, N, 0), N) != 0)){
+		free_heuristic(heuristic);
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Function:  free_heuristic 
+ * --------------------
+ * Free the tables of a heuristic
+ *    
+ *  heuristic: The heuristic
+ * 
+ *  returns: 0
+ */
+int free_heuristic(Heuristic *heuristic){
+	if (heuristic->rows.table != NULL){
+		free_walking_distance(&heuristic->rows);
+	}
+	if (heuristic->cols.table != NULL){
+		free_walking_distance(&heuristic->cols);
+	}
+	free_pattern_database(&heuristic->pdb);
+	free_move_table(&heuristic->moves);
+	return 0;
+}
+
+/*
+ * Function:  heuristic_value 
+ * --------------------
+ * Evaluate the heuristic on a whole board. The search then keeps it up to date move by move
+ *    
+ *  heuristic: The heuristic
+ *  tiles: The board, tiles[row*N + col]
+ *  wd_rows: Walking distance index along the rows (output, only for HEURISTIC_WALKING_DISTANCE)
+ *  wd_cols: Walking distance index along the columns (output, only for HEURISTIC_WALKING_DISTANCE)
+ * 
+ *  returns: the heuristic estimate
+ */
+int heuristic_value(const Heuristic *heuristic, const int *tiles, int *wd_rows, int *wd_cols){
+	int N = heuristic->N;
+	int line[MAX_LINE_LENGTH];
+	unsigned long ranks[MAX_PATTERNS];
+	int i, j, h_score = 0;
+	*wd_rows = 0;
+	*wd_cols = 0;
+	if (heuristic->kind == HEURISTIC_WALKING_DISTANCE){
+		*wd_rows = find_walking_distance(&heuristic->rows, walking_distance_key(tiles, heuristic->goal_rows, N, 1));
+		*wd_cols = find_walking_distance(&heuristic->cols, walking_distance_key(tiles, heuristic->goal_cols, N, 0));
+		return heuristic->rows.distance[*wd_rows] + heuristic->cols.distance[*wd_cols];
+	}
+	for (i = 0; i < N*N; i++){
+		if (tiles[i] != 0){
+			/* Do not care about 'x' */
+			h_score += abs(i / N - heuristic->goal_rows[tiles[i]]) + abs(i % N - heuristic->goal_cols[tiles[i]]);
+		}
+	}
+	if (heuristic->kind == HEURISTIC_LINEAR_CONFLICT){
+		for (i = 0; i < N; i++){
+			h_score += line_conflicts(heuristic, &tiles[i*N], i, 1);
+			for (j = 0; j < N; j++){
+				line[j] = tiles[j*N + i];
+			}
+			h_score += line_conflicts(heuristic, line, i, 0);
+		}
+	}
+	if (heuristic->kind == HEURISTIC_PATTERN_DATABASE){
+		pattern_ranks(&heuristic->pdb, tiles, ranks);
+		for (i = 0; i < heuristic->pdb.num_patterns; i++){
+			h_score += 2 * pattern_entry(&heuristic->pdb, i, ranks[i]);
+		}
+	}
+	return h_score;
+}
+
+/*
+ * Function:  packed_line 
+ * --------------------
+ * Read one row or column of a packed board
+ *    
+ *  board: The packed board
+ *  N: width and height of the board 
+ *  line: Index of the row or column
+ *  is_row: 1 for a row, 0 for a column
+ *  tiles: The array of size N receiving the tiles (output)
+ * 
+ *  returns: 0
+ */
+int packed_line(uint64_t board, int N, int line, int is_row, int *tiles){
+	int i;
+	for (i = 0; i < N; i++){
+		tiles[i] = (int) ((board >> (4 * (is_row ? line*N + i : i*N + line))) & 0xF);
+	}
+	return 0;
+}
+
+/*
+ * Function:  packed_conflicts_change 
+ * --------------------
+ * Change in linear conflicts after a move. A vertical move takes a tile from one row to another 
+ * and a horizontal move from one column to another, so only those two lines need to be looked at
+ *    
+ *  heuristic: The heuristic
+ *  board: The packed board before the move
+ *  child: The packed board after the move
+ *  is_row: 1 if the tile moved between rows, 0 if between columns
+ *  line_1, line_2: The two rows or columns
+ * 
+ *  returns: the conflicts on both lines after the move minus the conflicts before
+ */
+int packed_conflicts_change(const Heuristic *heuristic, uint64_t board, uint64_t child, int is_row, 
+	int line_1, int line_2){
+	int line[MAX_LINE_LENGTH] = {0}; /* Only N entries are used, but the optimizer cannot tell */
+	int change = 0;
+	packed_line(board, heuristic->N, line_1, is_row, line);
+	change -= line_conflicts(heuristic, line, line_1, is_row);
+	packed_line(board, heuristic->N, line_2, is_row, line);
+	change -= line_conflicts(heuristic, line, line_2, is_row);
+	packed_line(child, heuristic->N, line_1, is_row, line);
+	change += line_conflicts(heuristic, line, line_1, is_row);
+	packed_line(child, heuristic->N, line_2, is_row, line);
+	change += line_conflicts(heuristic, line, line_2, is_row);
+	return change;
+}
+
+/*
+ * Function:  board_line 
+ * --------------------
+ * Read one row or column of a board
+ *    
+ *  board: The board configuration 
+ *  N: width and height of the board 
+ *  line: Index of the row or column
+ *  is_row: 1 for a row, 0 for a column
+ *  tiles: The array of size N receiving the tiles (output)
+ * 
+ *  returns: 0
+ */
+int board_line(int **board, int N, int line, int is_row, int *tiles){
+	int i;
+	for (i = 0; i < N; i++){
+		tiles[i] = is_row ? board[line][i] : board[i][line];
+	}
+	return 0;
+}
+
+/*
+ * Function:  seconds_since 
+ * --------------------
+ * Time elapsed since a point taken with clock_gettime(CLOCK_MONOTONIC)
+ *    
+ *  start: The starting point
+ * 
+ *  returns: the number of seconds
+ */
+double seconds_since(const struct timespec *start){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/*
+ * Function:  new_transposition_table 
+ * --------------------
+ * Set up an empty transposition table: as many entries as fit in the budget, rounded down 
+ * to a power of two. The memory comes zeroed, which no key matches in any iteration
+ *    
+ *  table: The transposition table
+ *  megabytes: The budget
+ *  N: width and height of the board 
+ * 
+ *  returns: 0, or -1 if there is not enough memory
+ */
+int new_transposition_table(TranspositionTable *table, long megabytes, int N){
+	unsigned long num_entries = 1;
+	uint64_t seed = 0x9E3779B97F4A7C15UL, z;
+	int i;
+	while (2 * num_entries * sizeof(TranspositionEntry) <= (unsigned long) megabytes << 20){
+		num_entries *= 2;
+	}
+	table->mask = num_entries - 1;
+	table->N = N;
+	table->iteration = 0;
+	table->zobrist = NULL;
+	table->entries = (TranspositionEntry *) calloc(num_entries, sizeof(TranspositionEntry));
+	if (table->entries == NULL){
+		return -1;
+	}
+	if (N > MAX_PACKED_N){
+		table->zobrist = (uint64_t *) malloc(sizeof(uint64_t) * N * N * N * N);
+		if (table->zobrist == NULL){
+			free_transposition_table(table);
+			return -1;
+		}
+		/* splitmix64, with a fixed seed so that runs can be repeated */
+		for (i = 0; i < N * N * N * N; i++){
+			seed += 0x9E3779B97F4A7C15UL;
+			z = seed;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9UL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBUL;
+			table->zobrist[i] = z ^ (z >> 31);
+		}
+	}
+	return 0;
+}
+
+/*
+ * Function:  free_transposition_table 
+ * --------------------
+ * Free a transposition table
+ *    
+ *  table: The transposition table
+ * 
+ *  returns: 0
+ */
+int free_transposition_table(TranspositionTable *table){
+	free(table->entries);
+	free(table->zobrist);
+	table->entries = NULL;
+	table->zobrist = NULL;
+	return 0;
+}
+
+/*
+ * Function:  transposition_key 
+ * --------------------
+ * The key of a board in a transposition table for N > MAX_PACKED_N. The search updates it 
+ * after every move with two xors
+ *    
+ *  table: The transposition table
+ *  tiles: The board, tiles[row*N + col]
+ * 
+ *  returns: the key
+ */
+uint64_t transposition_key(const TranspositionTable *table, const int *tiles){
+	uint64_t key = 0;
+	int N = table->N;
+	int i;
+	for (i = 0; i < N*N; i++){
+		if (tiles[i] != 0){
+			key ^= table->zobrist[tiles[i] * N * N + i];
+		}
+	}
+	return key;
+}
+
+/*
+ * Function:  transposition_cut 
+ * --------------------
+ * Look a board up in the transposition table. If it was already reached in this iteration 
+ * with no more moves and in the same state of the move automaton, the subtree below it was 
+ * searched then (or still is, if this is a cycle back to it) with at least as much of the 
+ * threshold left, so there is nothing to search here. The state has to match as the automaton 
+ * prunes different moves below a board depending on the moves that led to it. Otherwise the 
+ * board is recorded with this state and g-score. Threads share the table without locking: 
+ * an entry is two words, and one written half by each of two threads does not match any key
+ *    
+ *  table: The transposition table
+ *  key: The board if N <= MAX_PACKED_N, else its key (see transposition_key)
+ *  state: The state of the heuristic's MoveAutomaton on reaching the board
+ *  g_score: The number of moves made to reach the board
+ * 
+ *  returns: 1 if the board can be skipped, else 0
+ */
+int transposition_cut(TranspositionTable *table, uint64_t key, int state, int g_score){
+	TranspositionEntry *entry = &table->entries[((key * (uint64_t) 0x9E3779B97F4A7C15UL) >> 32) & table->mask];
+	uint64_t data = entry->data;
+	if (((entry->check ^ data) == key) && ((data >> TRANSPOSITION_G_BITS) 
+			== ((table->iteration << TRANSPOSITION_STATE_BITS) | (uint64_t) state)) 
+		&& ((int) (data & (((uint64_t) 1 << TRANSPOSITION_G_BITS) - 1)) <= g_score)){
+		return 1;
+	}
+	data = (((table->iteration << TRANSPOSITION_STATE_BITS) | (uint64_t) state) << TRANSPOSITION_G_BITS) 
+		| (uint64_t) g_score;
+	entry->check = key ^ data;
+	entry->data = data;
+	return 0;
+}
+
+/*
+ * Function:  found_goal 
+ * --------------------
+ * Record the moves that led to the goal
+ *    
+ *  context: The search context
+ *  depth: Number of moves made to reach the goal
+ * 
+ *  returns: 0
+ */
+int found_goal(SearchContext *context, int depth){
+	char *solution;
+	int i;
+	if (!__sync_bool_compare_and_swap(context->found, 0, 1)){
+		/* Another thread got there first, with a solution just as long */
+		return 0;
+	}
+	solution = (char *) malloc(sizeof(char) * (depth + 2));
+	for (i = 0; i <= depth; i++){
+		solution[i] = context->desc[i];
+	}
+	solution[depth + 1] = '\0';
+	*context->solution = solution;
+	return 0;
+}
+
+/*
+ * Function:  reserve_search_stack 
+ * --------------------
+ * Make room in the search stack and in desc for a search down to some depth
+ *    
+ *  context: The search context
+ *  max_depth: The deepest board the search can reach, at most the threshold
+ * 
+ *  returns: 0, or -1 if there is not enough memory
+ */
+int reserve_search_stack(SearchContext *context, int max_depth){
+	void *grown;
+	int capacity = context->capacity;
+	if (max_depth < capacity){
+		return 0;
+	}
+	while (capacity <= max_depth){
+		capacity = (capacity == 0) ? 64 : 2 * capacity;
+	}
+	grown = realloc(context->frames, sizeof(SearchFrame) * capacity);
+	if (grown == NULL){
+		return -1;
+	}
+	context->frames = (SearchFrame *) grown;
+	grown = realloc(context->desc, sizeof(char) * (capacity + 2));
+	if (grown == NULL){
+		return -1;
+	}
+	context->desc = (char *) grown;
+	context->capacity = capacity;
+	return 0;
+}
+
+/*
+ * Function:  new_cut_boards 
+ * --------------------
+ * Initialize an empty buffer of the boards cut off by the threshold
+ *    
+ *  boards: The buffer
+ *  limit: Most bytes the records may take
+ * 
+ *  returns: 0
+ */
+int new_cut_boards(CutBoards *boards, size_t limit){
+	boards->records = NULL;
+	boards->size = 0;
+	boards->capacity = 0;
+	boards->limit = limit;
+	boards->overflowed = 0;
+	return 0;
+}
+
+/*
+ * Function:  free_cut_boards 
+ * --------------------
+ * Free the records of a buffer made by new_cut_boards
+ *    
+ *  boards: The buffer
+ * 
+ *  returns: 0
+ */
+int free_cut_boards(CutBoards *boards){
+	free(boards->records);
+	boards->records = NULL;
+	boards->size = 0;
+	boards->capacity = 0;
+	return 0;
+}
+
+/*
+ * Function:  reserve_cut_board 
+ * --------------------
+ * Make room for one more record at the end of a buffer of cut boards. The buffer doubles as 
+ * needed, up to its limit. A record that does not fit sets overflowed, and nothing more is 
+ * kept from then on
+ *    
+ *  boards: The buffer
+ *  size: Bytes of the record
+ * 
+ *  returns: where to write the record, or NULL if it does not fit
+ */
+unsigned char* reserve_cut_board(CutBoards *boards, size_t size){
+	void *grown;
+	size_t capacity = boards->capacity;
+	if (boards->overflowed || (boards->size + size > boards->limit)){
+		boards->overflowed = 1;
+		return NULL;
+	}
+	if (boards->size + size > capacity){
+		while (boards->size + size > capacity){
+			capacity = (capacity == 0) ? 4096 : 2 * capacity;
+		}
+		if (capacity > boards->limit){
+			capacity = boards->limit;
+		}
+		grown = realloc(boards->records, capacity);
+		if (grown == NULL){
+			/* As if the limit was reached: the search goes on without the boards kept */
+			boards->overflowed = 1;
+			return NULL;
+		}
+		boards->records = (unsigned char *) grown;
+		boards->capacity = capacity;
+	}
+	boards->size += size;
+	return boards->records + boards->size - size;
+}
+
+/*
+ * Function:  cut_board_size 
+ * --------------------
+ * The bytes of the record of a cut board: a CutBoard, then the board, packed into 64 bits up 
+ * to MAX_PACKED_N x MAX_PACKED_N and a byte per tile beyond, then the moves from the start, 
+ * four to a byte as indices into u, d, l, r
+ *    
+ *  N: width and height of the board 
+ *  depth: Number of moves made to reach the board
+ * 
+ *  returns: the size of the record
+ */
+size_t cut_board_size(int N, int depth){
+	return sizeof(CutBoard) + ((N <= MAX_PACKED_N) ? sizeof(uint64_t) : (size_t) (N*N)) + (depth + 3) / 4;
+}
+
+/*
+ * Function:  keep_cut_board 
+ * --------------------
+ * Called by the search on a board cut off by the threshold, to keep it in context->cut_boards 
+ * for the next iteration (see cut_board_size). Once they are full, context->cut_boards is set 
+ * to NULL so that the search stops calling
+ *    
+ *  context: The search context, with desc holding the moves to the board before the last one, 
+ *           and context->board set to the board if N > MAX_PACKED_N
+ *  board: The packed board, if N <= MAX_PACKED_N
+ *  depth: Number of moves made to reach the board
+ *  f_score: Its f-score, above the threshold
+ *  state: The state of the heuristic's MoveAutomaton on reaching it
+ *  move: The last move
+ * 
+ *  returns: 0
+ */
+int keep_cut_board(SearchContext *context, uint64_t board, int depth, int f_score, int state, char move){
+	/* Index in u, d, l, r of a move c, at (c >> 2) & 7 which is different for each of them. A lookup 
+	   instead of comparisons, as the moves follow no pattern the branch predictor could pick up */
+	static const int DIRECTIONS[8] = {0, 1, 0, 2, 3, 0, 0, 0};
+	CutBoard cut;
+	unsigned char *record, *path;
+	const char *desc = context->desc;
+	int N = context->N;
+	int i, code;
+	char c;
+	record = reserve_cut_board(context->cut_boards, cut_board_size(N, depth));
+	if (record == NULL){
+		context->cut_boards = NULL;
+		return 0;
+	}
+	cut.f_score = (unsigned short) f_score;
+	cut.depth = (unsigned short) depth;
+	cut.state = (unsigned short) state;
+	memcpy(record, &cut, sizeof(CutBoard));
+	record += sizeof(CutBoard);
+	if (N <= MAX_PACKED_N){
+		memcpy(record, &board, sizeof(uint64_t));
+		path = record + sizeof(uint64_t);
+	} else {
+		for (i = 0; i < N*N; i++){
+			record[i] = (unsigned char) context->board[i / N][i % N];
+		}
+		path = record + N*N;
+	}
+	code = 0;
+	for (i = 0; i < depth; i++){
+		c = (i + 1 < depth) ? desc[i + 1] : move;
+		code |= DIRECTIONS[(c >> 2) & 7] << (2 * (i % 4));
+		if ((i % 4 == 3) || (i + 1 == depth)){
+			path[i / 4] = (unsigned char) code;
+			code = 0;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Function:  resume_cut_board 
+ * --------------------
+ * Set up the search below a board kept by keep_cut_board, as start_search does, with its board, 
+ * positions, desc, heuristic estimate and pattern ranks rebuilt from the record
+ *    
+ *  context: The search context, with room in the search stack for the current threshold
+ *  record: The record of the board
+ * 
+ *  returns: 0
+ */
+int resume_cut_board(SearchContext *context, const unsigned char *record){
+	static const char MOVES[NUM_OF_POSSIBLE_MOVES] = {'u', 'd', 'l', 'r'};
+	CutBoard cut;
+	const unsigned char *path;
+	int tiles[MAX_LINE_LENGTH * MAX_LINE_LENGTH];
+	int N = context->N;
+	int i, h_score, wd_rows, wd_cols;
+	uint64_t board = 0;
+	memcpy(&cut, record, sizeof(CutBoard));
+	record += sizeof(CutBoard);
+	if (N <= MAX_PACKED_N){
+		memcpy(&board, record, sizeof(uint64_t));
+		path = record + sizeof(uint64_t);
+		for (i = 0; i < N*N; i++){
+			tiles[i] = (int) ((board >> (4 * i)) & 0xF);
+		}
+	} else {
+		path = record + N*N;
+		for (i = 0; i < N*N; i++){
+			tiles[i] = record[i];
+			context->board[i / N][i % N] = tiles[i];
+		}
+		if (context->table != NULL){
+			board = transposition_key(context->table, (const int *) tiles);
+		}
+	}
+	for (i = 0; i < N*N; i++){
+		context->current_rows[tiles[i]] = i / N;
+		context->current_cols[tiles[i]] = i % N;
+	}
+	context->desc[0] = 'B';
+	for (i = 0; i < cut.depth; i++){
+		context->desc[i + 1] = MOVES[(path[i / 4] >> (2 * (i % 4))) & 3];
+	}
+	context->desc[cut.depth + 1] = '\0';
+	h_score = heuristic_value(context->heuristic, (const int *) tiles, &wd_rows, &wd_cols);
+	if (context->heuristic->kind == HEURISTIC_PATTERN_DATABASE){
+		pattern_ranks(&context->heuristic->pdb, (const int *) tiles, context->pattern_ranks);
+	}
+	start_search(context, board, cut.depth, context->current_rows[0], context->current_cols[0], h_score, 
+		wd_rows, wd_cols, cut.state);
+	return 0;
+}
+
+/*
+ * Function:  start_search 
+ * --------------------
+ * Set up the search stack for a search below a board, with the current threshold. The stack 
+ * must have room for it (see reserve_search_stack), and desc must hold the moves to the board
+ *    
+ *  context: The search context, with context->board and current_rows/current_cols set to the board 
+ *           if N > MAX_PACKED_N
+ *  board: The packed board, if N <= MAX_PACKED_N
+ *  depth: Number of moves made so far
+ *  x_row, x_col: Position of 'x'
+ *  h_score: The heuristic estimate of the board
+ *  wd_rows, wd_cols: Walking distance indices of the board (only for HEURISTIC_WALKING_DISTANCE)
+ *  state: State of the heuristic's MoveAutomaton after the moves to the board
+ * 
+ *  returns: 0
+ */
+int start_search(SearchContext *context, uint64_t board, int depth, int x_row, int x_col, int h_score, 
+	int wd_rows, int wd_cols, int state){
+	SearchFrame *frame = &context->frames[depth];
+	frame->blank = x_row * context->N + x_col;
+	frame->x_row = x_row;
+	frame->x_col = x_col;
+	frame->k = -1; /* Not looked at yet */
+	frame->state = state;
+	frame->num_successors = context->heuristic->moves.num_successors[frame->blank];
+	frame->h_score = h_score;
+	frame->wd_rows = wd_rows;
+	frame->wd_cols = wd_cols;
+	frame->board = board;
+	context->base_depth = depth;
+	context->depth = depth;
+	context->min = INT_MAX;
+	return 0;
+}
+
+/* Between the top frame of the search stack and the locals of a search function */
+#define LOAD_SEARCH_FRAME(frame) \
+	k = (frame)->k; \
+	state = (frame)->state; \
+	num_successors = (frame)->num_successors; \
+	blank = (frame)->blank; \
+	x_row = (frame)->x_row; \
+	x_col = (frame)->x_col; \
+	h_score = (frame)->h_score
+#define STORE_SEARCH_FRAME(frame) \
+	(frame)->k = k; \
+	(frame)->state = state; \
+	(frame)->num_successors = num_successors; \
+	(frame)->blank = blank; \
+	(frame)->x_row = x_row; \
+	(frame)->x_col = x_col; \
+	(frame)->h_score = h_score
+
+/*
+ * Function:  search 
+ * --------------------
+ * Depth-first search below the board given to start_search, cut off at the f-score threshold. 
+ * The search keeps its own stack of SearchFrame, one per move, instead of recursing, so its depth is 
+ * only limited by the threshold, and it can stop after any board and carry on where it left off when 
+ * called again. The board, desc and current_rows/current_cols are updated in place and restored on 
+ * the way back. The moves of 'x' and their effect on the Manhattan distance come from the 
+ * heuristic's MoveTable, and a move is skipped if it ends a redundant sequence of moves, going 
+ * by the heuristic's MoveAutomaton, whose state is kept in every frame. With a transposition table, a board already reached in this iteration with 
+ * no more moves is not searched again (see transposition_cut). With context->cut_boards set, the boards 
+ * cut off by the threshold are kept for the next iteration (see keep_cut_board). SEARCH defines it for any N, and 
+ * search_5() with N a constant, so that the table indexing and the line loops are worked out by the 
+ * compiler (see search_for)
+ *    
+ *  context: The search context
+ *  stop_expanded: Pause once context->num_expanded reaches it (LONG_MAX to search to the end)
+ *
+ *  returns: the minimum f_score greater than threshold encountered, the f_score of the goal, 
+ *           or SEARCH_PAUSED
+ */
+#define SEARCH(name, size) \
+int name(SearchContext *context, long stop_expanded){ \
+ \
+	SearchFrame *frame; \
+	const Successor *successor; \
+	int depth, min, f_score, i, k, num_successors, state, new_state; \
+	int blank, x_row, x_col, h_score; \
+	int new_x_row, new_x_col; \
+	int new_h_score; \
+	int temp_1; \
+	int is_row, line_1, line_2; \
+	int line[MAX_LINE_LENGTH]; \
+	int pattern = 0; \
+	unsigned long old_rank = 0, new_rank; \
+	uint64_t key, child_key = 0; \
+	int threshold = context->threshold; \
+	int base_depth = context->base_depth; \
+	char *desc = context->desc; \
+	const int N = size; /* A constant in the specializations */ \
+	int **board = context->board; \
+	int *current_rows = context->current_rows; \
+	int *current_cols = context->current_cols; \
+	const Heuristic *heuristic = context->heuristic; \
+	const MoveTable *moves = &heuristic->moves; \
+	const int *automaton = heuristic->automaton->next; \
+	TranspositionTable *table = context->table; \
+ \
+	depth = context->depth; \
+	min = context->min; \
+	if (depth < base_depth){ \
+		/* Nothing left below the board */ \
+		return min; \
+	} \
+	frame = &context->frames[base_depth]; \
+	if (frame->k < 0){ \
+		/* First call since start_search */ \
+		frame->k = 0; \
+		f_score = depth + frame->h_score; \
+		if (f_score > threshold){ \
+			context->depth = depth - 1; \
+			context->min = f_score; \
+			return f_score; \
+		} \
+		if (frame->h_score == 0){ \
+			found_goal(context, depth); \
+			return f_score; \
+		} \
+		context->num_expanded++; \
+	} \
+ \
+	/* The top frame is kept in locals, as the arguments of a recursive search would be */ \
+	frame = &context->frames[depth]; \
+	LOAD_SEARCH_FRAME(frame); \
+	key = frame->board; \
+	while (1){ \
+		if (k == num_successors){ \
+			/* Every move tried, back to the board before */ \
+			if (depth == base_depth){ \
+				break; \
+			} \
+			new_x_row = x_row; \
+			new_x_col = x_col; \
+			if (heuristic->kind == HEURISTIC_PATTERN_DATABASE){ \
+				context->pattern_ranks[frame->pattern] = frame->old_rank; \
+			} \
+			desc[depth] = '\0'; \
+			depth--; \
+			frame--; \
+			LOAD_SEARCH_FRAME(frame); \
+			key = frame->board; \
+ \
+			/* Move back */ \
+			temp_1 = board[x_row][x_col]; \
+			board[x_row][x_col] = 0; \
+			board[new_x_row][new_x_col] = temp_1; \
+			current_rows[0] = x_row; \
+			current_cols[0] = x_col; \
+			current_rows[temp_1] = new_x_row; \
+			current_cols[temp_1] = new_x_col; \
+			continue; \
+		} \
+		i = blank * NUM_OF_POSSIBLE_MOVES + k; \
+		successor = &moves->successors[i]; \
+		k++; \
+		new_state = automaton[state * NUM_OF_POSSIBLE_MOVES + successor->direction]; \
+		if (new_state < 0){ \
+			/* The moves end with a redundant sequence, such as going back to the previous state */ \
+			continue; \
+		} \
+		new_x_row = successor->row; \
+		new_x_col = successor->col; \
+		STATS_COUNT(context->num_generated); \
+ \
+		/* Update h_score */ \
+		STATS_COUNT(context->num_evaluations); \
+		new_h_score = h_score; \
+		temp_1 = board[new_x_row][new_x_col]; \
+		new_h_score += moves->manhattan_delta[i * N * N + temp_1]; \
+		if (table != NULL){ \
+			child_key = key ^ table->zobrist[temp_1 * N * N + successor->blank] ^ table->zobrist[temp_1 * N * N + blank]; \
+		} \
+ \
+		/* A vertical move takes the tile from one row to another, a horizontal move from one column \
+		   to another. Only the conflicts on those two lines can change */ \
+		is_row = (successor->direction < 2); \
+		line_1 = is_row ? x_row : x_col; \
+		line_2 = is_row ? new_x_row : new_x_col; \
+		if (heuristic->kind == HEURISTIC_LINEAR_CONFLICT){ \
+			board_line(board, N, line_1, is_row, line); \
+			new_h_score -= line_conflicts(heuristic, line, line_1, is_row); \
+			board_line(board, N, line_2, is_row, line); \
+			new_h_score -= line_conflicts(heuristic, line, line_2, is_row); \
+		} \
+ \
+		/* Move */ \
+		current_rows[0] = new_x_row; \
+		current_cols[0] = new_x_col; \
+		current_rows[temp_1] = x_row; \
+		current_cols[temp_1] = x_col; \
+		board[x_row][x_col] = temp_1; \
+		board[new_x_row][new_x_col] = 0; \
+ \
+		if (heuristic->kind == HEURISTIC_LINEAR_CONFLICT){ \
+			board_line(board, N, line_1, is_row, line); \
+			new_h_score += line_conflicts(heuristic, line, line_1, is_row); \
+			board_line(board, N, line_2, is_row, line); \
+			new_h_score += line_conflicts(heuristic, line, line_2, is_row); \
+		} \
+ \
+		/* Only the placement of the pattern of the moved tile changes */ \
+		if (heuristic->kind == HEURISTIC_PATTERN_DATABASE){ \
+			pattern = heuristic->pdb.pattern_of[temp_1]; \
+			old_rank = context->pattern_ranks[pattern]; \
+			new_rank = board_pattern_rank(&heuristic->pdb, pattern, (const int *) current_rows, (const int *) current_cols); \
+			new_h_score += 2 * (pattern_entry(&heuristic->pdb, pattern, new_rank) \
+				- pattern_entry(&heuristic->pdb, pattern, old_rank)); \
+			context->pattern_ranks[pattern] = new_rank; \
+		} \
+ \
+		f_score = depth + 1 + new_h_score; \
+		if ((f_score > threshold) || ((table != NULL) && (threshold - f_score >= TRANSPOSITION_MIN_SLACK) \
+			&& transposition_cut(table, child_key, new_state, depth + 1))){ \
+			/* find the minimum of all f_score greater than threshold encountered. A board cut by the \
+			   transposition table has already been searched with no fewer moves left */ \
+			if ((f_score > threshold) && (f_score < min)){ \
+				min = f_score; \
+			} \
+			if ((f_score > threshold) && (context->cut_boards != NULL)){ \
+				keep_cut_board(context, 0, depth + 1, f_score, new_state, successor->move); \
+			} \
+ \
+			/* Move back */ \
+			board[x_row][x_col] = 0; \
+			board[new_x_row][new_x_col] = temp_1; \
+			current_rows[0] = x_row; \
+			current_cols[0] = x_col; \
+			current_rows[temp_1] = new_x_row; \
+			current_cols[temp_1] = new_x_col; \
+			if (heuristic->kind == HEURISTIC_PATTERN_DATABASE){ \
+				context->pattern_ranks[pattern] = old_rank; \
+			} \
+			continue; \
+		} \
+		desc[depth+1] = successor->move; \
+		desc[depth+2] = '\0'; \
+		if (new_h_score == 0){ \
+			frame->k = k; \
+			context->depth = depth; \
+			context->min = min; \
+			found_goal(context, depth + 1); \
+			return f_score; \
+		} \
+ \
+		/* Search further down the game tree */ \
+		frame->k = k; \
+		depth++; \
+		frame++; \
+		k = 0; \
+		state = new_state; \
+		blank = successor->blank; \
+		x_row = new_x_row; \
+		x_col = new_x_col; \
+		num_successors = moves->num_successors[blank]; \
+		h_score = new_h_score; \
+		key = child_key; \
+		STORE_SEARCH_FRAME(frame); \
+		frame->board = key; \
+		frame->pattern = pattern; \
+		frame->old_rank = old_rank; \
+		context->num_expanded++; \
+		if (context->num_expanded >= stop_expanded){ \
+			context->depth = depth; \
+			context->min = min; \
+			return SEARCH_PAUSED; \
+		} \
+	} \
+	context->depth = depth - 1; \
+	context->min = min; \
+	return min;  /* return the minimum f_score encountered greater than threshold */ \
+}
+
+SEARCH(search, context->N)
+SEARCH(search_5, 5)
+
+/*
+ * Function:  search_packed 
+ * --------------------
+ * Same as search(), on a board packed into 64 bits (see pack_board). A move is a mask and 
+ * two shifts on the board of the frame, so nothing has to be undone on the way back, 
+ * and the goal test is a single comparison. SEARCH_PACKED defines it for any N, and the 3x3 and 
+ * 4x4 specializations with N a constant (see search_for)
+ *    
+ *  context: The search context
+ *  stop_expanded: Pause once context->num_expanded reaches it (LONG_MAX to search to the end)
+ *
+ *  returns: the minimum f_score greater than threshold encountered, the f_score of the goal, 
+ *           or SEARCH_PAUSED
+ */
+#define SEARCH_PACKED(name, size) \
+int name(SearchContext *context, long stop_expanded){ \
+ \
+	SearchFrame *frame; \
+	const Successor *successor; \
+	int depth, min, f_score, i, k, num_successors, state, new_state; \
+	int blank, x_row, x_col, h_score, wd_rows, wd_cols; \
+	int new_h_score, new_wd_rows, new_wd_cols; \
+	int temp_1; \
+	int new_blank_shift; \
+	int pattern = 0; \
+	unsigned long old_rank = 0, new_rank; \
+	uint64_t board, child; \
+	int threshold = context->threshold; \
+	int base_depth = context->base_depth; \
+	char *desc = context->desc; \
+	uint64_t packed_goal = context->packed_goal; \
+	const int N = size; /* A constant in the specializations */ \
+	const Heuristic *heuristic = context->heuristic; \
+	const MoveTable *moves = &heuristic->moves; \
+	const int *automaton = heuristic->automaton->next; \
+	TranspositionTable *table = context->table; \
+ \
+	depth = context->depth; \
+	min = context->min; \
+	if (depth < base_depth){ \
+		/* Nothing left below the board */ \
+		return min; \
+	} \
+	frame = &context->frames[base_depth]; \
+	if (frame->k < 0){ \
+		/* First call since start_search */ \
+		frame->k = 0; \
+		f_score = depth + frame->h_score; \
+		if (f_score > threshold){ \
+			context->depth = depth - 1; \
+			context->min = f_score; \
+			return f_score; \
+		} \
+		if (frame->board == packed_goal){ \
+			found_goal(context, depth); \
+			return f_score; \
+		} \
+		context->num_expanded++; \
+	} \
+ \
+	/* The top frame is kept in locals, as the arguments of a recursive search would be */ \
+	frame = &context->frames[depth]; \
+	LOAD_SEARCH_FRAME(frame); \
+	board = frame->board; \
+	wd_rows = frame->wd_rows; \
+	wd_cols = frame->wd_cols; \
+	while (1){ \
+		if (k == num_successors){ \
+			/* Every move tried, back to the board before */ \
+			if (depth == base_depth){ \
+				break; \
+			} \
+			if (heuristic->kind == HEURISTIC_PATTERN_DATABASE){ \
+				context->pattern_ranks[frame->pattern] = frame->old_rank; \
+			} \
+			desc[depth] = '\0'; \
+			depth--; \
+			frame--; \
+			LOAD_SEARCH_FRAME(frame); \
+			board = frame->board; \
+			wd_rows = frame->wd_rows; \
+			wd_cols = frame->wd_cols; \
+			continue; \
+		} \
+		i = blank * NUM_OF_POSSIBLE_MOVES + k; \
+		successor = &moves->successors[i]; \
+		k++; \
+		new_state = automaton[state * NUM_OF_POSSIBLE_MOVES + successor->direction]; \
+		if (new_state < 0){ \
+			/* The moves end with a redundant sequence, such as going back to the previous state */ \
+			continue; \
+		} \
+		STATS_COUNT(context->num_generated); \
+ \
+		/* Move. The tile being moved sits where 'x' is going */ \
+		new_blank_shift = 4 * successor->blank; \
+		temp_1 = (int) ((board >> new_blank_shift) & 0xF); \
+		child = (board & ~((uint64_t) 0xF << new_blank_shift)) | ((uint64_t) temp_1 << (4 * blank)); \
+ \
+		/* Update h_score */ \
+		STATS_COUNT(context->num_evaluations); \
+		new_h_score = h_score; \
+		new_wd_rows = wd_rows; \
+		new_wd_cols = wd_cols; \
+		if (heuristic->kind == HEURISTIC_WALKING_DISTANCE){ \
+			/* The tile enters the line of 'x' from the line before it (moves 'u' and 'l') \
+			   or after it (moves 'd' and 'r') */ \
+			if (successor->direction < 2){ \
+				new_wd_rows = heuristic->rows.next[(wd_rows*2 + successor->direction)*N + context->goal_rows[temp_1]]; \
+			} else { \
+				new_wd_cols = heuristic->cols.next[(wd_cols*2 + successor->direction - 2)*N + context->goal_cols[temp_1]]; \
+			} \
+			new_h_score = heuristic->rows.distance[new_wd_rows] + heuristic->cols.distance[new_wd_cols]; \
+		} else { \
+			new_h_score += moves->manhattan_delta[i * N * N + temp_1]; \
+			if (heuristic->kind == HEURISTIC_LINEAR_CONFLICT){ \
+				if (successor->direction < 2){ \
+					new_h_score += packed_conflicts_change(heuristic, board, child, 1, x_row, successor->row); \
+				} else { \
+					new_h_score += packed_conflicts_change(heuristic, board, child, 0, x_col, successor->col); \
+				} \
+			} \
+			if (heuristic->kind == HEURISTIC_PATTERN_DATABASE){ \
+				/* Only the placement of the pattern of the moved tile changes */ \
+				pattern = heuristic->pdb.pattern_of[temp_1]; \
+				old_rank = context->pattern_ranks[pattern]; \
+				new_rank = packed_pattern_rank(&heuristic->pdb, pattern, child); \
+				new_h_score += 2 * (pattern_entry(&heuristic->pdb, pattern, new_rank) \
+					- pattern_entry(&heuristic->pdb, pattern, old_rank)); \
+				context->pattern_ranks[pattern] = new_rank; \
+			} \
+		} \
+ \
+		f_score = depth + 1 + new_h_score; \
+		if ((f_score > threshold) || ((table != NULL) && (threshold - f_score >= TRANSPOSITION_MIN_SLACK) \
+			&& transposition_cut(table, child, new_state, depth + 1))){ \
+			/* find the minimum of all f_score greater than threshold encountered. A board cut by the \
+			   transposition table has already been searched with no fewer moves left */ \
+			if ((f_score > threshold) && (f_score < min)){ \
+				min = f_score; \
+			} \
+			if ((f_score > threshold) && (context->cut_boards != NULL)){ \
+				keep_cut_board(context, child, depth + 1, f_score, new_state, successor->move); \
+			} \
+			if (heuristic->kind == HEURISTIC_PATTERN_DATABASE){ \
+				context->pattern_ranks[pattern] = old_rank; \
+			} \
+			continue; \
+		} \
+		desc[depth+1] = successor->move; \
+		desc[depth+2] = '\0'; \
+		if (child == packed_goal){ \
+			frame->k = k; \
+			context->depth = depth; \
+			context->min = min; \
+			found_goal(context, depth + 1); \
+			return f_score; \
+		} \
+ \
+		/* Search further down the game tree */ \
+		frame->k = k; \
+		depth++; \
+		frame++; \
+		k = 0; \
+		state = new_state; \
+		board = child; \
+		blank = successor->blank; \
+		x_row = successor->row; \
+		x_col = successor->col; \
+		num_successors = moves->num_successors[blank]; \
+		h_score = new_h_score; \
+		wd_rows = new_wd_rows; \
+		wd_cols = new_wd_cols; \
+		STORE_SEARCH_FRAME(frame); \
+		frame->board = board; \
+		frame->wd_rows = wd_rows; \
+		frame->wd_cols = wd_cols; \
+		frame->pattern = pattern; \
+		frame->old_rank = old_rank; \
+		context->num_expanded++; \
+		if (context->num_expanded >= stop_expanded){ \
+			context->depth = depth; \
+			context->min = min; \
+			return SEARCH_PAUSED; \
+		} \
+	} \
+	context->depth = depth - 1; \
+	context->min = min; \
+	return min;  /* return the minimum f_score encountered greater than threshold */ \
+}
+
+SEARCH_PACKED(search_packed, context->N)
+SEARCH_PACKED(search_packed_3, 3)
+SEARCH_PACKED(search_packed_4, 4)
+
+/*
+ * Function:  search_for 
+ * --------------------
+ * The search function to use for a board: search_packed() up to MAX_PACKED_N x MAX_PACKED_N, 
+ * search() beyond
+ *    
+ *  N: width and height of the board 
+ * 
+ *  returns: the specialization for N if there is one, or search_packed() or search()
+ */
+SearchFunction search_for(int N){
+	switch (N){
+		case 3:
+			return search_packed_3;
+		case 4:
+			return search_packed_4;
+		case 5:
+			return search_5;
+		default:
+			return (N <= MAX_PACKED_N) ? search_packed : search;
+	}
+}
+
+/*
+ * Function:  search_cut_boards 
+ * --------------------
+ * One IDA* iteration that starts from the boards cut off in the iteration before instead of 
+ * from the start. Every board searched then and within the threshold is known not to lead to 
+ * the goal at that threshold, so only the boards at its edge have to be looked at again: those 
+ * now within the threshold are searched below, and the others are kept as they are for the 
+ * iteration after, in context->cut_boards along with the boards cut off this time
+ *    
+ *  context: The search context, with its threshold raised to the smallest f-score in boards
+ *  boards: The boards kept in the iteration before
+ * 
+ *  returns: the minimum f_score greater than threshold encountered, or the f_score of the goal
+ */
+int search_cut_boards(SearchContext *context, const CutBoards *boards){
+	CutBoard cut;
+	unsigned char *record;
+	size_t offset, size;
+	int N = context->N;
+	int temp, min = INT_MAX;
+	for (offset = 0; offset < boards->size; offset += size){
+		memcpy(&cut, boards->records + offset, sizeof(CutBoard));
+		size = cut_board_size(N, cut.depth);
+		if (cut.f_score > context->threshold){
+			record = (context->cut_boards == NULL) ? NULL : reserve_cut_board(context->cut_boards, size);
+			if (record != NULL){
+				memcpy(record, boards->records + offset, size);
+			} else {
+				context->cut_boards = NULL;
+			}
+			temp = cut.f_score;
+		} else {
+			resume_cut_board(context, boards->records + offset);
+			temp = search_for(N)(context, LONG_MAX);
+			if (*context->found){
+				return temp;
+			}
+		}
+		if (temp < min){
+			min = temp;
+		}
+	}
+	return min;
+}
+
+/*
+ * Function:  new_frontier 
+ * --------------------
+ * Initialize an empty frontier
+ *    
+ *  frontier: The frontier
+ * 
+ *  returns: 0
+ */
+int new_frontier(Frontier *frontier){
+	frontier->nodes = NULL;
+	frontier->num_nodes = 0;
+	frontier->capacity = 0;
+	frontier->depth = 0;
+	return 0;
+}
+
+/*
+ * Function:  free_frontier 
+ * --------------------
+ * Free a frontier and its nodes
+ *    
+ *  frontier: The frontier
+ * 
+ *  returns: 0
+ */
+int free_frontier(Frontier *frontier){
+	int i;
+	for (i = 0; i < frontier->num_nodes; i++){
+		free(frontier->nodes[i].tiles);
+		free(frontier->nodes[i].desc);
+		free(frontier->nodes[i].path_f);
+	}
+	free(frontier->nodes);
+	new_frontier(frontier);
+	return 0;
+}
+
+/*
+ * Function:  add_to_frontier 
+ * --------------------
+ * Append a board to a frontier, with everything search() needs to start from it
+ *    
+ *  frontier: The frontier
+ *  tiles: The board, tiles[row*N + col]
+ *  desc: 'B' followed by the moves from the start
+ *  path_f: f-scores of the boards before this one (depth of them)
+ *  depth: Number of moves from the start
+ *  state: State of the heuristic's MoveAutomaton after desc
+ *  heuristic: The heuristic
+ * 
+ *  returns: 0, or -1 if there is not enough memory
+ */
+int add_to_frontier(Frontier *frontier, const int *tiles, const char *desc, const int *path_f, int depth, 
+	int state, const Heuristic *heuristic){
+	FrontierNode *node;
+	int N = heuristic->N;
+	int i, capacity;
+	void *grown;
+	if (frontier->num_nodes == frontier->capacity){
+		capacity = (frontier->capacity == 0) ? 64 : 2 * frontier->capacity;
+		grown = realloc(frontier->nodes, sizeof(FrontierNode) * capacity);
+		if (grown == NULL){
+			return -1;
+		}
+		frontier->nodes = (FrontierNode *) grown;
+		frontier->capacity = capacity;
+	}
+	node = &frontier->nodes[frontier->num_nodes];
+	node->tiles = (int *) malloc(sizeof(int) * N * N);
+	node->desc = (char *) malloc(sizeof(char) * (depth + 2));
+	node->path_f = (int *) malloc(sizeof(int) * (depth + 1));
+	if ((node->tiles == NULL) || (node->desc == NULL) || (node->path_f == NULL)){
+		free(node->tiles);
+		free(node->desc);
+		free(node->path_f);
+		return -1;
+	}
+	frontier->num_nodes++;
+	memcpy(node->tiles, tiles, sizeof(int) * N * N);
+	memcpy(node->desc, desc, sizeof(char) * (depth + 1));
+	node->desc[depth + 1] = '\0';
+	memcpy(node->path_f, path_f, sizeof(int) * depth);
+	node->depth = depth;
+	node->state = state;
+	for (i = 0; tiles[i] != 0; i++){
+	}
+	node->x_row = i / N;
+	node->x_col = i % N;
+	node->h_score = heuristic_value(heuristic, tiles, &node->wd_rows, &node->wd_cols);
+	if (heuristic->kind == HEURISTIC_PATTERN_DATABASE){
+		pattern_ranks(&heuristic->pdb, tiles, node->pattern_ranks);
+	}
+	node->path_f[depth] = depth + node->h_score;
+	return 0;
+}
+
+/*
+ * Function:  build_frontier 
+ * --------------------
+ * Expand the start breadth-first, one move at a time, until there are at least min_nodes 
+ * boards at the last depth to hand out to the workers. Like search(), it skips the moves 
+ * that the heuristic's MoveAutomaton prunes, and it stops early if a board is the goal: breadth-first, that is a shortest solution
+ *    
+ *  frontier: The frontier (output, empty on entry)
+ *  start: The starting board, start[row*N + col]
+ *  goal_tiles: The goal, goal_tiles[row*N + col]
+ *  heuristic: The heuristic
+ *  min_nodes: How many boards are wanted
+ * 
+ *  returns: the index of a node that is the goal, -1 if there is none, or -2 if there is not enough memory
+ */
+int build_frontier(Frontier *frontier, const int *start, const int *goal_tiles, const Heuristic *heuristic, 
+	int min_nodes){
+	static const char MOVES[NUM_OF_POSSIBLE_MOVES] = {'u', 'd', 'l', 'r'};
+	Frontier next;
+	const FrontierNode *node;
+	int N = heuristic->N;
+	int *tiles;
+	char desc[MAX_FRONTIER_DEPTH + 2];
+	int k, i, blank, new_blank, state, status = -1;
+	
+	tiles = (int *) malloc(sizeof(int) * N * N);
+	if ((tiles == NULL) || (add_to_frontier(frontier, start, "B", NULL, 0, 0, heuristic) != 0)){
+		free(tiles);
+		return -2;
+	}
+	if (memcmp(start, goal_tiles, sizeof(int) * N * N) == 0){
+		free(tiles);
+		return 0;
+	}
+	while ((frontier->num_nodes < min_nodes) && (frontier->depth < MAX_FRONTIER_DEPTH)){
+		new_frontier(&next);
+		next.depth = frontier->depth + 1;
+		for (k = 0; (k < frontier->num_nodes) && (status == -1); k++){
+			node = &frontier->nodes[k];
+			blank = node->x_row * N + node->x_col;
+			for (i = 0; i < NUM_OF_POSSIBLE_MOVES; i++){
+				if (((i == 0) && (node->x_row == 0)) || ((i == 1) && (node->x_row == N - 1)) 
+					|| ((i == 2) && (node->x_col == 0)) || ((i == 3) && (node->x_col == N - 1))){
+					continue;
+				}
+				state = heuristic->automaton->next[node->state * NUM_OF_POSSIBLE_MOVES + i];
+				if (state < 0){
+					continue;
+				}
+				new_blank = blank + ((i == 0) ? -N : (i == 1) ? N : (i == 2) ? -1 : 1);
+				memcpy(tiles, node->tiles, sizeof(int) * N * N);
+				tiles[blank] = tiles[new_blank];
+				tiles[new_blank] = 0;
+				memcpy(desc, node->desc, sizeof(char) * (node->depth + 1));
+				desc[node->depth + 1] = MOVES[i];
+				if (add_to_frontier(&next, (const int *) tiles, (const char *) desc, (const int *) node->path_f, 
+					next.depth, state, heuristic) != 0){
+					status = -2;
+					break;
+				}
+				if (memcmp(tiles, goal_tiles, sizeof(int) * N * N) == 0){
+					status = next.num_nodes - 1;
+					break;
+				}
+			}
+		}
+		free_frontier(frontier);
+		*frontier = next;
+		if (status != -1){
+			break;
+		}
+	}
+	free(tiles);
+	return status;
+}
+
+/*
+ * Function:  take_work 
+ * --------------------
+ * Get the next frontier node for a worker: the last one in its own queue, or else the first 
+ * one in the queue of another worker
+ *    
+ *  shared: The parallel search
+ *  id: The worker
+ * 
+ *  returns: the index of the node, or -1 if every queue is empty
+ */
+int take_work(ParallelSearch *shared, int id){
+	WorkQueue *queue = &shared->queues[id];
+	int i, item = -1;
+	pthread_mutex_lock(&queue->lock);
+	if (queue->bottom > queue->top){
+		queue->bottom--;
+		item = queue->items[queue->bottom];
+	}
+	pthread_mutex_unlock(&queue->lock);
+	for (i = 1; (item == -1) && (i < shared->num_threads); i++){
+		queue = &shared->queues[(id + i) % shared->num_threads];
+		pthread_mutex_lock(&queue->lock);
+		if (queue->bottom > queue->top){
+			item = queue->items[queue->top];
+			queue->top++;
+		}
+		pthread_mutex_unlock(&queue->lock);
+	}
+	return item;
+}
+
+/*
+ * Function:  reduce_min 
+ * --------------------
+ * Atomically lower a shared value to value, if it is smaller
+ *    
+ *  target: The shared value
+ *  value: The candidate
+ * 
+ *  returns: 0
+ */
+int reduce_min(volatile int *target, int value){
+	int current = *target;
+	while ((value < current) && !__sync_bool_compare_and_swap(target, current, value)){
+		current = *target;
+	}
+	return 0;
+}
+
+/*
+ * Function:  search_worker 
+ * --------------------
+ * Thread body: search below frontier nodes until the queues run dry or some worker 
+ * reaches the goal
+ *    
+ *  arg: The Worker
+ * 
+ *  returns: NULL
+ */
+void* search_worker(void *arg){
+	Worker *worker = (Worker *) arg;
+	ParallelSearch *shared = worker->shared;
+	SearchContext *context = &worker->context;
+	const FrontierNode *node;
+	int N = context->N;
+	int item, d, i, temp, min = INT_MAX;
+	uint64_t packed;
+	
+	context->threshold = shared->threshold;
+	context->num_expanded = 0;
+#ifdef NPUZZLE_STATS
+	context->num_generated = 0;
+	context->num_evaluations = 0;
+#endif
+	while (!shared->found){
+		item = take_work(shared, worker->id);
+		if (item == -1){
+			break;
+		}
+		node = &shared->frontier->nodes[item];
+		
+		/* Where the serial search would have stopped on the way to the node */
+		for (d = 0; (d <= node->depth) && (node->path_f[d] <= shared->threshold); d++){
+		}
+		if (d <= node->depth){
+			temp = node->path_f[d];
+		} else {
+			memcpy(context->desc, node->desc, sizeof(char) * (node->depth + 2));
+			memcpy(context->pattern_ranks, node->pattern_ranks, sizeof(node->pattern_ranks));
+			packed = 0;
+			if (N <= MAX_PACKED_N){
+				for (i = N*N - 1; i >= 0; i--){
+					packed = (packed << 4) | (uint64_t) node->tiles[i];
+				}
+			} else {
+				for (i = 0; i < N*N; i++){
+					context->board[i / N][i % N] = node->tiles[i];
+					context->current_rows[node->tiles[i]] = i / N;
+					context->current_cols[node->tiles[i]] = i % N;
+				}
+				if (context->table != NULL){
+					packed = transposition_key(context->table, (const int *) node->tiles);
+				}
+			}
+			start_search(context, packed, node->depth, node->x_row, node->x_col, node->h_score, 
+				node->wd_rows, node->wd_cols, node->state);
+			
+			/* In slices, to stop soon after another worker reaches the goal */
+			do {
+				temp = search_for(N)(context, context->num_expanded + SEARCH_SLICE);
+			} while ((temp == SEARCH_PAUSED) && !shared->found);
+			if (temp == SEARCH_PAUSED){
+				break;
+			}
+		}
+		if (temp < min){
+			min = temp;
+		}
+	}
+	reduce_min(&shared->next_threshold, min);
+	__sync_fetch_and_add(&shared->num_expanded, context->num_expanded);
+#ifdef NPUZZLE_STATS
+	__sync_fetch_and_add(&shared->num_generated, context->num_generated);
+	__sync_fetch_and_add(&shared->num_evaluations, context->num_evaluations);
+#endif
+	return NULL;
+}
+
+/*
+ * Function:  parallel_search 
+ * --------------------
+ * One IDA* iteration over the frontier with all the workers. The frontier nodes are dealt 
+ * out round-robin, and a worker whose queue is empty steals from the others, which also 
+ * drains the queue of a worker whose thread could not be started. The calling thread 
+ * runs worker 0
+ *    
+ *  shared: The parallel search, threshold set
+ *  workers: The workers
+ * 
+ *  returns: 0
+ */
+int parallel_search(ParallelSearch *shared, Worker *workers){
+	pthread_t threads[MAX_THREADS];
+	WorkQueue *queue;
+	int i, num_started;
+	for (i = 0; i < shared->num_threads; i++){
+		shared->queues[i].top = 0;
+		shared->queues[i].bottom = 0;
+	}
+	for (i = 0; i < shared->frontier->num_nodes; i++){
+		queue = &shared->queues[i % shared->num_threads];
+		queue->items[queue->bottom] = i;
+		queue->bottom++;
+	}
+	shared->next_threshold = INT_MAX;
+	for (num_started = 1; num_started < shared->num_threads; num_started++){
+		if (pthread_create(&threads[num_started], NULL, search_worker, &workers[num_started]) != 0){
+			break;
+		}
+	}
+	search_worker(&workers[0]);
+	for (i = 1; i < num_started; i++){
+		pthread_join(threads[i], NULL);
+	}
+	return 0;
+}
+
+/*
+ * Function:  run_parallel 
+ * --------------------
+ * IDA* with several threads. Every iteration searches below the same frontier, so the 
+ * thresholds are the same as in the serial search, and every solution within a threshold 
+ * has the length of the threshold: the first worker to reach the goal can stop the others 
+ * and the solution is still optimal
+ *    
+ *  tiles: The starting board, tiles[row*N + col]
+ *  context: The search context of solve(), with the threshold set to the h-score of the start
+ *  num_threads: Number of threads
+ *  solution: Set to the moves of the solution, starting with 'B', to be freed by the caller
+ *  num_expanded: Set to the number of boards expanded by all the threads
+ * 
+ *  returns: 0 if a solution was found, 1 if the f-score went past MAX_F_VALUE, -1 if out of memory
+ */
+int run_parallel(const int *tiles, const SearchContext *context, int num_threads, char **solution, 
+	long *num_expanded){
+	Frontier frontier;
+	ParallelSearch shared;
+	WorkQueue queues[MAX_THREADS];
+	Worker workers[MAX_THREADS];
+	int *goal_tiles;
+	int N = context->N;
+	int i, goal_node, threshold, num_locks = 0, num_workers = 0, status = -1;
+#ifdef NPUZZLE_STATS
+	int search_number = new_search_stats(), iteration = 0;
+	long iteration_expanded;
+	struct timespec iteration_start;
+#endif
+	
+	new_frontier(&frontier);
+	shared.solution = NULL;
+	shared.num_expanded = 0;
+	goal_tiles = (int *) malloc(sizeof(int) * N * N);
+	if (goal_tiles == NULL){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	for (i = 0; i < N*N; i++){
+		goal_tiles[context->goal_rows[i] * N + context->goal_cols[i]] = i;
+	}
+	goal_node = build_frontier(&frontier, tiles, (const int *) goal_tiles, context->heuristic, 
+		FRONTIER_NODES_PER_THREAD * num_threads);
+	if (goal_node == -2){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	if (goal_node >= 0){
+		shared.solution = (char *) malloc(sizeof(char) * (strlen(frontier.nodes[goal_node].desc) + 1));
+		if (shared.solution == NULL){
+			printf("Out of memory! \n");
+			goto CLEANUP;
+		}
+		strcpy(shared.solution, frontier.nodes[goal_node].desc);
+		status = 0;
+		goto CLEANUP;
+	}
+	printf("Threads: %d, frontier: %d boards at depth %d \n", num_threads, frontier.num_nodes, frontier.depth);
+	
+	shared.frontier = &frontier;
+	shared.queues = queues;
+	shared.num_threads = num_threads;
+	shared.found = 0;
+	for (num_locks = 0; num_locks < num_threads; num_locks++){
+		queues[num_locks].items = (int *) malloc(sizeof(int) * (frontier.num_nodes / num_threads + 1));
+		if ((queues[num_locks].items == NULL) || (pthread_mutex_init(&queues[num_locks].lock, NULL) != 0)){
+			free(queues[num_locks].items);
+			printf("Out of memory! \n");
+			goto CLEANUP;
+		}
+	}
+	for (num_workers = 0; num_workers < num_threads; num_workers++){
+		workers[num_workers].shared = &shared;
+		workers[num_workers].id = num_workers;
+		workers[num_workers].context = *context;
+		workers[num_workers].context.found = &shared.found;
+		workers[num_workers].context.solution = &shared.solution;
+		workers[num_workers].context.desc = NULL;
+		workers[num_workers].context.frames = NULL;
+		workers[num_workers].context.capacity = 0;
+		workers[num_workers].context.current_rows = (int *) malloc(sizeof(int) * N * N);
+		workers[num_workers].context.current_cols = (int *) malloc(sizeof(int) * N * N);
+		workers[num_workers].context.board = (N > MAX_PACKED_N) ? new_board(N) : NULL;
+		if ((workers[num_workers].context.current_rows == NULL) || (workers[num_workers].context.current_cols == NULL)){
+			num_workers++;
+			printf("Out of memory! \n");
+			goto CLEANUP;
+		}
+	}
+	
+	threshold = context->threshold;
+	while (1){
+		shared.threshold = threshold;
+		if (context->table != NULL){
+			context->table->iteration++;
+		}
+		for (i = 0; i < num_workers; i++){
+			if (reserve_search_stack(&workers[i].context, threshold) != 0){
+				printf("Out of memory! \n");
+				goto CLEANUP;
+			}
+		}
+#ifdef NPUZZLE_STATS
+		iteration_expanded = shared.num_expanded;
+		shared.num_generated = 0;
+		shared.num_evaluations = 0;
+		clock_gettime(CLOCK_MONOTONIC, &iteration_start);
+#endif
+		parallel_search(&shared, workers);
+#ifdef NPUZZLE_STATS
+		record_iteration(search_number, ++iteration, threshold, shared.num_generated, shared.num_expanded - iteration_expanded, 
+			shared.num_evaluations, seconds_since(&iteration_start));
+#endif
+		if (shared.found){
+			status = 0;
+			goto CLEANUP;
+		}
+		if (shared.next_threshold > MAX_F_VALUE){
+			/* Threshold larger than maximum possible f value */
+			status = 1;
+			goto CLEANUP;
+		}
+		threshold = shared.next_threshold;
+	}
+	
+	CLEANUP: {
+		for (i = 0; i < num_workers; i++){
+			free(workers[i].context.desc);
+			free(workers[i].context.frames);
+			free(workers[i].context.current_rows);
+			free(workers[i].context.current_cols);
+			if (workers[i].context.board != NULL){
+				free_board(workers[i].context.board, N);
+			}
+		}
+		for (i = 0; i < num_locks; i++){
+			pthread_mutex_destroy(&queues[i].lock);
+			free(queues[i].items);
+		}
+		if (status == 0){
+			*solution = shared.solution;
+		} else {
+			free(shared.solution);
+		}
+		*num_expanded = shared.num_expanded;
+		free(goal_tiles);
+		free_frontier(&frontier);
+		return status;
+	}
+}
+
+/*
+ * Function:  solve 
+ * --------------------
+ * Solve one instance with IDA-star, once the heuristic for its goal is set up
+ *    
+ *  start: The starting board
+ *  goal: The goal
+ *  N: width and height of the board 
+ *  heuristic: The heuristic for the goal, only read, so it can be shared between threads
+ *  num_threads: Number of threads for this instance
+ *  table_megabytes: Size of the transposition table of the search, shared by its threads, or 0 for none
+ *  frontier_megabytes: Memory for the boards cut off by the threshold, from which the next iteration 
+ *                      carries on instead of starting over (see search_cut_boards), or 0 for none. 
+ *                      Once they do not fit, every later iteration starts over. Only on one thread
+ *  solution: Set to the moves of the solution, starting with 'B', to be freed by the caller
+ *  num_expanded: Set to the number of boards expanded
+ * 
+ *  returns: 0 if a solution was found, 1 if the f-score went past MAX_F_VALUE, -1 if out of memory
+ */ 
+int solve(int **start, const int **goal, int N, const Heuristic *heuristic, int num_threads, long table_megabytes, 
+	long frontier_megabytes, char **solution, long *num_expanded){
+	SearchContext context;
+	TranspositionTable table;
+	CutBoards cut_boards[2]; /* Kept in the last iteration, and in this one */
+	int last = 0; /* Index of the boards kept in the last iteration */
+	int keeping, resume = 0;
+	size_t frontier_limit = (size_t) frontier_megabytes << 20;
+	size_t before = 0; /* Bytes kept in the iteration before the last */
+	int *current_cols, *current_rows; /* Position of each element */
+	int *tiles;
+	int N_squared;
+	int temp;
+	int i,j;
+	int x_row, x_col;
+	int h_score, wd_rows, wd_cols;	
+	int status = -1;
+	uint64_t packed_start = 0;
+	volatile int found = 0;
+#ifdef NPUZZLE_STATS
+	int search_number = 0, iteration = 0;
+	long iteration_expanded;
+	struct timespec iteration_start;
+#endif
+	
+	*solution = NULL;
+	*num_expanded = 0;
+	N_squared = N*N;
+	current_cols = (int *) malloc(sizeof(int) * N_squared);
+    current_rows = (int *) malloc(sizeof(int) * N_squared);
+	tiles = (int *) malloc(sizeof(int) * N_squared);
+	context.desc = NULL;
+	context.frames = NULL;
+	context.capacity = 0;
+	context.board = (N > MAX_PACKED_N) ? new_board(N) : NULL; /* A copy, the search leaves it at the goal */
+	context.table = NULL;
+	context.cut_boards = NULL;
+	context.num_expanded = 0;
+	new_cut_boards(&cut_boards[0], 0);
+	new_cut_boards(&cut_boards[1], 0);
+	keeping = (frontier_megabytes > 0) && (N <= MAX_LINE_LENGTH);
+	if ((current_cols == NULL) || (current_rows == NULL) || (tiles == NULL)){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	for (i = 0; i < N; i++){		
+		for (j = 0; j < N; j++){
+			current_rows[start[i][j]] = i;
+			current_cols[start[i][j]] = j;
+			tiles[i*N + j] = start[i][j];
+			if (context.board != NULL){
+				context.board[i][j] = start[i][j];
+			}
+		}		
+	}	
+	x_row = current_rows[0];
+	x_col = current_cols[0];
+	
+	h_score = heuristic_value(heuristic, (const int *) tiles, &wd_rows, &wd_cols);
+	if (heuristic->kind == HEURISTIC_PATTERN_DATABASE){
+		pattern_ranks(&heuristic->pdb, (const int *) tiles, context.pattern_ranks);
+	}
+	
+	context.goal = goal;
+	context.packed_goal = 0;
+	context.N = N;
+	context.found = &found;
+	context.solution = solution;
+	context.current_rows = current_rows;
+	context.current_cols = current_cols;
+	context.goal_rows = heuristic->goal_rows;
+	context.goal_cols = heuristic->goal_cols;
+	context.heuristic = heuristic;
+	if (reserve_search_stack(&context, h_score) != 0){
+		printf("Out of memory! \n");
+		goto CLEANUP;
+	}
+	context.desc[0] = 'B';
+	context.desc[1] = '\0';
+	if (table_megabytes > 0){
+		if (new_transposition_table(&table, table_megabytes, N) != 0){
+			printf("Out of memory! \n");
+			goto CLEANUP;
+		}
+		context.table = &table;
+	}
+	if (N <= MAX_PACKED_N){
+		packed_start = pack_board((const int **) start, N);
+		context.packed_goal = pack_board(goal, N);
+	} else if (context.table != NULL){
+		packed_start = transposition_key(context.table, (const int *) tiles);
+	}
+	context.threshold = h_score;	
+	if (num_threads > 1){
+		status = run_parallel((const int *) tiles, (const SearchContext *) &context, num_threads, solution, 
+			&context.num_expanded);
+		goto CLEANUP;
+	}
+#ifdef NPUZZLE_STATS
+	search_number = new_search_stats();
+#endif
+	while (1){			
+#ifdef NPUZZLE_STATS
+		iteration_expanded = context.num_expanded;
+		context.num_generated = 0;
+		context.num_evaluations = 0;
+		clock_gettime(CLOCK_MONOTONIC, &iteration_start);
+#endif
+		if (reserve_search_stack(&context, context.threshold) != 0){
+			printf("Out of memory! \n");
+			goto CLEANUP;
+		}
+		if (context.table != NULL){
+			context.table->iteration++;
+		}
+		if (keeping && resume && (before > 0) && ((double) cut_boards[last].size * cut_boards[last].size / before 
+			> (double) (frontier_limit - cut_boards[last].size))){
+			/* The boards grow by about as much in every iteration, so those of this one would not fit */
+			keeping = 0;
+		}
+		context.cut_boards = NULL;
+		if (keeping){
+			/* Both sets of boards share the memory */
+			cut_boards[1 - last].size = 0;
+			cut_boards[1 - last].limit = frontier_limit - cut_boards[last].size;
+			context.cut_boards = &cut_boards[1 - last];
+		}
+		if (resume){
+			temp = search_cut_boards(&context, (const CutBoards *) &cut_boards[last]);
+		} else {
+			if (frontier_megabytes > 0){
+				/* The boards kept may have left the board, the positions and the pattern ranks elsewhere */
+				for (i = 0; i < N_squared; i++){
+					current_rows[tiles[i]] = i / N;
+					current_cols[tiles[i]] = i % N;
+					if (context.board != NULL){
+						context.board[i / N][i % N] = tiles[i];
+					}
+				}
+				if (heuristic->kind == HEURISTIC_PATTERN_DATABASE){
+					pattern_ranks(&heuristic->pdb, (const int *) tiles, context.pattern_ranks);
+				}
+				context.desc[1] = '\0';
+			}
+			start_search(&context, packed_start, 0, x_row, x_col, h_score, wd_rows, wd_cols, 0);
+			temp = search_for(N)(&context, LONG_MAX);
+		}
+#ifdef NPUZZLE_STATS
+		record_iteration(search_number, ++iteration, context.threshold, context.num_generated, 
+			context.num_expanded - iteration_expanded, context.num_evaluations, seconds_since(&iteration_start));
+#endif
+		if (found){
+			status = 0;
+			goto CLEANUP;				
+		}
+		if (temp > MAX_F_VALUE){
+			/* Threshold larger than maximum possible f value */
+			status = 1;
+			goto CLEANUP;
+		}
+		if (keeping){
+			before = cut_boards[last].size;
+			last = 1 - last;
+			keeping = !cut_boards[last].overflowed;
+		}
+		resume = keeping;
+		if (!keeping){
+			/* From now on, every iteration starts over */
+			free_cut_boards(&cut_boards[0]);
+			free_cut_boards(&cut_boards[1]);
+		}
+		context.threshold = temp;
+	}		
+	CLEANUP: {
+		*num_expanded = context.num_expanded;
+		free_cut_boards(&cut_boards[0]);
+		free_cut_boards(&cut_boards[1]);
+		free(context.desc);
+		free(context.frames);
+		if (context.board != NULL){
+			free_board(context.board, N);
+		}
+		if (context.table != NULL){
+			free_transposition_table(context.table);
+		}
+		free(current_cols);
+		free(current_rows);
+		free(tiles);
+		return status;
+	}	
+}
+
+/*
+ * Function:  run 
+ * --------------------
+ * Run (N^2-1) solver using IDA-star algorithm
+ *    
+ *  start: The starting board
+ *  goal: The goal
+ *  N: width and height of the board 
+ *  options: Options from the command line
+ * 
+ *  returns: 0 if a solution was found, EXIT_UNSOLVABLE if the goal cannot be reached from the start, 
+ *           1 otherwise
+ */ 
+int run(int **start, const int **goal, int N, const Options *options){
+	Heuristic heuristic;
+	MoveAutomaton automaton;
+	DistanceTable distances;
+	int *goal_cols, *goal_rows; /* Position of each element */
+	int N_squared;
+	int i,j;
+	int status;
+	int exit_status = 0;
+	long num_expanded;
+	struct timespec start_time;
+	char *solution = NULL;
+	
+	if (is_solvable((const int **) start, goal, N) == 0){
+		printf("UNSOLVABLE! The goal cannot be reached from the start \n");
+		return EXIT_UNSOLVABLE;
+	}
+	
+	/* Precompute positions for goal */
+	N_squared = N*N;
+    goal_cols = (int *) malloc(sizeof(int) * N_squared);
+    goal_rows = (int *) malloc(sizeof(int) * N_squared);
+	for (i = 0; i < N; i++){		
+		for (j = 0; j < N; j++){
+			goal_rows[goal[i][j]] = i;
+			goal_cols[goal[i][j]] = j;
+		}		
+	}	
+	
+	if ((options->distance_file != NULL) && (N <= MAX_DISTANCE_TABLE_N) && (load_distance_table(&distances, 
+		options->distance_file, (const int *) goal_rows, (const int *) goal_cols, N) == 0)){
+		clock_gettime(CLOCK_MONOTONIC, &start_time);
+		if (solve_by_distances((const DistanceTable *) &distances, start, goal, &solution, &num_expanded) == 0){
+			printf("FOUND SOLUTION!\n");
+			print_solution((const int **) start, N, (const char *) solution);
+			printf("Nodes expanded: %ld \n", num_expanded);
+			printf("Read off the distance table in %.3f s \n", seconds_since(&start_time));
+		} else {
+			printf("%s has no way to the goal from this start! \n", options->distance_file);
+			exit_status = 1;
+		}
+		free_distance_table(&distances);
+		free(solution);
+		free(goal_cols);
+		free(goal_rows);
+		return exit_status;
+	}
+	
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+	if (new_move_automaton(&automaton, options->automaton_depth) != 0){
+		free(goal_cols);
+		free(goal_rows);
+		return 1;
+	}
+	printf("Move automaton: %d states, ready in %.3f s \n", automaton.num_states, seconds_since(&start_time));
+	
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+	if (new_heuristic(&heuristic, options->heuristic, (const int *) goal_rows, (const int *) goal_cols, N, 
+		options->pattern_file, (const MoveAutomaton *) &automaton) != 0){
+		printf("This heuristic is not available for a %dx%d board! \n", N, N);
+		exit_status = 1;
+		goto CLEANUP;
+	}
+	if ((heuristic.kind == HEURISTIC_PATTERN_DATABASE) && options->prefault){
+		prefault_pattern_database(&heuristic.pdb);
+	}
+	printf("Heuristic ready in %.3f s \n", seconds_since(&start_time));
+	
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+	status = solve(start, goal, N, (const Heuristic *) &heuristic, options->num_threads, options->table_megabytes, 
+		options->frontier_megabytes, &solution, &num_expanded);
+	if (status == 0){
+		printf("FOUND SOLUTION!\n");
+		print_solution((const int **) start, N, (const char *) solution);
+		printf("Nodes expanded: %ld \n", num_expanded);
+		printf("Search took %.3f s \n", seconds_since(&start_time));
+	} else if (status == 1){
+		printf("MAXIMUM F VALUE REACHED! TERMINATING! \n");
+	}
+	if (status != 0){
+		exit_status = 1;
+	}
+	CLEANUP: {
+		free_heuristic(&heuristic);
+		free_move_automaton(&automaton);
+		free(solution);
+		free(goal_cols);
+		free(goal_rows);
+		return exit_status;
+	}	
+}
+
+/*
+ * Function:  read_instance 
+ * --------------------
+ * Read the next instance of a batch file: N, the start and the goal, as in temp.txt. 
+ * Blank lines and the "--------------" lines between instances are skipped
+ *    
+ *  fid: The batch file
+ *  N: Set to the width and height of the board 
+ *  start: Set to the starting board, to be freed by the caller
+ *  goal: Set to the goal, to be freed by the caller
+ * 
+ *  returns: 1 if an instance was read, 0 at the end of the file, -1 if the instance is malformed
+ */
+int read_instance(FILE *fid, int *N, int ***start, int ***goal){
+	char seen[MAX_LINE_LENGTH * MAX_LINE_LENGTH];
+	int **board;
+	int c, i, j, k;
+	
+	do {
+		c = fgetc(fid);
+	} while ((c != EOF) && (isspace(c) || (c == '-')));
+	if (c == EOF){
+		return 0;
+	}
+	ungetc(c, fid);
+	if ((fscanf(fid, "%d", N) != 1) || (*N < 2) || (*N > MAX_LINE_LENGTH)){
+		return -1;
+	}
+	*start = new_board(*N);
+	*goal = new_board(*N);
+	for (k = 0; k < 2; k++){
+		board = (k == 0) ? *start : *goal;
+		memset(seen, 0, sizeof(seen));
+		for (i = 0; i < *N; i++){
+			for (j = 0; j < *N; j++){
+				/* Every tile from 0 to N*N - 1 exactly once */
+				if ((fscanf(fid, "%d", &board[i][j]) != 1) || (board[i][j] < 0) || (board[i][j] >= (*N) * (*N)) 
+					|| seen[board[i][j]]){
+					free_board(*start, *N);
+					free_board(*goal, *N);
+					return -1;
+				}
+				seen[board[i][j]] = 1;
+			}
+		}
+	}
+	return 1;
+}
+
+/*
+ * Function:  goal_table 
+ * --------------------
+ * Find the goal table of a batch for this goal, or set one up. Called with the lock of the batch held
+ *    
+ *  batch: The batch
+ *  goal: The goal
+ *  N: width and height of the board 
+ * 
+ *  returns: The goal table, with ready set to 0 if the heuristic is not available for it, 
+ *           or NULL if out of memory
+ */
+GoalTable* goal_table(BatchSearch *batch, const int **goal, int N){
+	GoalTable *table;
+	int i, j;
+	struct timespec start_time;
+	
+	for (table = batch->goal_tables; table != NULL; table = table->next){
+		for (i = 0; i < N*N; i++){
+			if ((table->N != N) || (goal[table->goal_rows[i]][table->goal_cols[i]] != i)){
+				break;
+			}
+		}
+		if (i == N*N){
+			return table;
+		}
+	}
+	
+	table = (GoalTable *) malloc(sizeof(GoalTable));
+	if (table == NULL){
+		printf("Out of memory! \n");
+		return NULL;
+	}
+	table->N = N;
+	table->goal_rows = (int *) malloc(sizeof(int) * N * N);
+	table->goal_cols = (int *) malloc(sizeof(int) * N * N);
+	if ((table->goal_rows == NULL) || (table->goal_cols == NULL)){
+		free(table->goal_rows);
+		free(table->goal_cols);
+		free(table);
+		printf("Out of memory! \n");
+		return NULL;
+	}
+	for (i = 0; i < N; i++){		
+		for (j = 0; j < N; j++){
+			table->goal_rows[goal[i][j]] = i;
+			table->goal_cols[goal[i][j]] = j;
+		}		
+	}	
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+	table->ready = (new_heuristic(&table->heuristic, batch->options->heuristic, (const int *) table->goal_rows, 
+		(const int *) table->goal_cols, N, batch->options->pattern_file, (const MoveAutomaton *) &batch->automaton) == 0);
+	if (!table->ready){
+		printf("This heuristic is not available for a %dx%d board! \n", N, N);
+	} else {
+		if ((table->heuristic.kind == HEURISTIC_PATTERN_DATABASE) && batch->options->prefault){
+			prefault_pattern_database(&table->heuristic.pdb);
+		}
+		printf("Heuristic ready in %.3f s \n", seconds_since(&start_time));
+	}
+	table->has_distances = (batch->options->distance_file != NULL) && (N <= MAX_DISTANCE_TABLE_N) 
+		&& (load_distance_table(&table->distances, batch->options->distance_file, (const int *) table->goal_rows, 
+		(const int *) table->goal_cols, N) == 0);
+	table->next = batch->goal_tables;
+	batch->goal_tables = table;
+	return table;
+}
+
+/*
+ * Function:  peak_rss 
+ * --------------------
+ * Peak resident set size of the process so far. In a batch it covers every instance solved up to now
+ * 
+ *  returns: the peak in kilobytes, or -1 if it is not available
+ */
+long peak_rss(void){
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0){
+		return -1;
+	}
+	return usage.ru_maxrss;
+}
+
+/*
+ * Function:  report_instance 
+ * --------------------
+ * Print the result of one instance of a batch, and write it to the CSV and JSON files if there are any. 
+ * Called with the lock of the batch held
+ *    
+ *  batch: The batch
+ *  index: Number of the instance in the batch file, from 1
+ *  N: width and height of the board 
+ *  solution: The moves of the solution, starting with 'B', or NULL if the instance was not solved
+ *  num_expanded: Number of boards expanded
+ *  seconds: Time taken by the search
+ * 
+ *  returns: 0
+ */
+int report_instance(BatchSearch *batch, int index, int N, int solvable, const char *solution, long num_expanded, 
+	double seconds){
+	int length = (solution != NULL) ? (int) strlen(solution) - 1 : solvable ? -1 : -2;
+	double rate = (seconds > 0) ? num_expanded / seconds : 0.0;
+	long rss = peak_rss();
+	
+	if (solution != NULL){
+		printf("Instance %d: %dx%d, length %d, nodes %ld, %.3f s, %s \n", index, N, N, length, num_expanded, 
+			seconds, solution + 1);
+	} else if (!solvable){
+		printf("Instance %d: %dx%d, UNSOLVABLE \n", index, N, N);
+	} else {
+		printf("Instance %d: %dx%d, NOT SOLVED, nodes %ld, %.3f s \n", index, N, N, num_expanded, seconds);
+	}
+	if (batch->csv != NULL){
+		fprintf(batch->csv, "ida,%s,%d,%d,%d,%d,%ld,%.6f,%.0f,%ld\n", HEURISTIC_NAMES[batch->options->heuristic], 
+			batch->options->num_threads, index, N, length, num_expanded, seconds, rate, rss);
+	}
+	if (batch->json != NULL){
+		fprintf(batch->json, "%s\n    {\"instance\": %d, \"n\": %d, \"length\": %d, \"nodes_expanded\": %ld, "
+			"\"seconds\": %.6f, \"nodes_per_sec\": %.0f, \"peak_rss_kb\": %ld}", (batch->num_reported > 0) ? "," : "", 
+			index, N, length, num_expanded, seconds, rate, rss);
+	}
+	batch->num_reported++;
+	return 0;
+}
+
+/*
+ * Function:  batch_worker 
+ * --------------------
+ * Take instances from the batch file one at a time and solve them, until the file runs out
+ *    
+ *  arg: The batch
+ * 
+ *  returns: NULL
+ */
+void* batch_worker(void *arg){
+	BatchSearch *batch = (BatchSearch *) arg;
+	GoalTable *table;
+	int **start, **goal;
+	int N, index, status, solvable;
+	long num_expanded;
+	double seconds;
+	char *solution;
+	struct timespec start_time;
+	
+	while (1){
+		pthread_mutex_lock(&batch->lock);
+		status = batch->malformed ? 0 : read_instance(batch->fid, &N, &start, &goal);
+		if (status < 0){
+			printf("Malformed instance after instance %d! \n", batch->num_read);
+			batch->malformed = 1;
+		}
+		if (status <= 0){
+			pthread_mutex_unlock(&batch->lock);
+			return NULL;
+		}
+		batch->num_read++;
+		index = batch->num_read;
+		solvable = (is_solvable((const int **) start, (const int **) goal, N) != 0);
+		table = solvable ? goal_table(batch, (const int **) goal, N) : NULL;
+		pthread_mutex_unlock(&batch->lock);
+		
+		solution = NULL;
+		num_expanded = 0;
+		status = -1;
+		clock_gettime(CLOCK_MONOTONIC, &start_time);
+		if ((table != NULL) && table->has_distances){
+			status = solve_by_distances((const DistanceTable *) &table->distances, start, (const int **) goal, 
+				&solution, &num_expanded);
+		} else if ((table != NULL) && table->ready){
+			status = solve(start, (const int **) goal, N, (const Heuristic *) &table->heuristic, 1, 
+				batch->options->table_megabytes, batch->options->frontier_megabytes, &solution, &num_expanded);
+		}
+		seconds = seconds_since(&start_time);
+		
+		pthread_mutex_lock(&batch->lock);
+		report_instance(batch, index, N, solvable, (status == 0) ? (const char *) solution : NULL, num_expanded, seconds);
+		if (status == 0){
+			batch->num_solved++;
+		} else if (!solvable){
+			batch->num_unsolvable++;
+		}
+		batch->num_expanded += num_expanded;
+		pthread_mutex_unlock(&batch->lock);
+		free(solution);
+		free_board(start, N);
+		free_board(goal, N);
+	}
+}
+
+/*
+ * Function:  run_batch 
+ * --------------------
+ * Solve every instance of a batch file, in the format of temp.txt. The heuristic of each 
+ * distinct goal is set up once and shared by all the instances with that goal. With several 
+ * threads, each thread solves whole instances, so the results come out in the order they finish. 
+ * A solution length of -1 in the CSV and JSON files means the instance was not solved, and -2 
+ * that its goal cannot be reached from its start (see is_solvable), which is found without searching
+ *    
+ *  file_name: The batch file
+ *  options: Options from the command line
+ * 
+ *  returns: 0 if every instance was read and solved, EXIT_UNSOLVABLE if the only ones not solved 
+ *           cannot be, 1 otherwise
+ */
+int run_batch(const char *file_name, const Options *options){
+	BatchSearch batch;
+	GoalTable *table;
+	pthread_t threads[MAX_THREADS];
+	int i, num_started, num_goals = 0, status = 1;
+	double seconds;
+	struct timespec start_time;
+	
+	batch.fid = fopen(file_name, "rt");
+	if (batch.fid == NULL){
+		printf("Cannot open %s \n", file_name);
+		return 1;
+	}
+	if (pthread_mutex_init(&batch.lock, NULL) != 0){
+		fclose(batch.fid);
+		printf("Out of memory! \n");
+		return 1;
+	}
+	batch.options = options;
+	batch.num_read = 0;
+	batch.malformed = 0;
+	batch.goal_tables = NULL;
+	batch.num_solved = 0;
+	batch.num_unsolvable = 0;
+	batch.num_expanded = 0;
+	batch.csv = NULL;
+	batch.json = NULL;
+	batch.num_reported = 0;
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+	if (new_move_automaton(&batch.automaton, options->automaton_depth) != 0){
+		goto CLEANUP;
+	}
+	printf("Move automaton: %d states, ready in %.3f s \n", batch.automaton.num_states, seconds_since(&start_time));
+	if (options->csv_file != NULL){
+		batch.csv = fopen(options->csv_file, "w");
+		if (batch.csv == NULL){
+			printf("Cannot write %s \n", options->csv_file);
+			goto CLEANUP;
+		}
+		fprintf(batch.csv, "solver,heuristic,threads,instance,n,length,nodes_expanded,seconds,nodes_per_sec,peak_rss_kb\n");
+	}
+	if (options->json_file != NULL){
+		batch.json = fopen(options->json_file, "w");
+		if (batch.json == NULL){
+			printf("Cannot write %s \n", options->json_file);
+			goto CLEANUP;
+		}
+		fprintf(batch.json, "{\n  \"solver\": \"ida\",\n  \"heuristic\": \"%s\",\n  \"threads\": %d,\n  \"instances\": [", 
+			HEURISTIC_NAMES[options->heuristic], options->num_threads);
+	}
+	
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+	for (num_started = 1; num_started < options->num_threads; num_started++){
+		if (pthread_create(&threads[num_started], NULL, batch_worker, &batch) != 0){
+			break;
+		}
+	}
+	batch_worker(&batch);
+	for (i = 1; i < num_started; i++){
+		pthread_join(threads[i], NULL);
+	}
+	seconds = seconds_since(&start_time);
+	
+	while (batch.goal_tables != NULL){
+		table = batch.goal_tables;
+		batch.goal_tables = table->next;
+		if (table->ready){
+			free_heuristic(&table->heuristic);
+		}
+		if (table->has_distances){
+			free_distance_table(&table->distances);
+		}
+		free(table->goal_rows);
+		free(table->goal_cols);
+		free(table);
+		num_goals++;
+	}
+	printf("Solved %d of %d instances (%d unsolvable, %d goals) with %d threads in %.3f s, %.2f instances/s \n", 
+		batch.num_solved, batch.num_read, batch.num_unsolvable, num_goals, num_started, seconds, 
+		(seconds > 0) ? batch.num_solved / seconds : 0.0);
+	printf("Nodes expanded: %ld, %.0f nodes/s, peak RSS %ld kB \n", batch.num_expanded, 
+		(seconds > 0) ? batch.num_expanded / seconds : 0.0, peak_rss());
+	if (batch.json != NULL){
+		fprintf(batch.json, "\n  ],\n  \"summary\": {\"instances\": %d, \"solved\": %d, \"unsolvable\": %d, \"goals\": %d, \"seconds\": %.6f, "
+			"\"instances_per_sec\": %.3f, \"nodes_expanded\": %ld, \"nodes_per_sec\": %.0f, \"peak_rss_kb\": %ld}\n}\n", 
+			batch.num_read, batch.num_solved, batch.num_unsolvable, num_goals, seconds, (seconds > 0) ? batch.num_solved / seconds : 0.0, 
+			batch.num_expanded, (seconds > 0) ? batch.num_expanded / seconds : 0.0, peak_rss());
+	}
+	status = (batch.malformed || (batch.num_solved + batch.num_unsolvable < batch.num_read)) ? 1 
+		: (batch.num_unsolvable > 0) ? EXIT_UNSOLVABLE : 0;
+	
+	CLEANUP: {
+		if (batch.csv != NULL){
+			fclose(batch.csv);
+		}
+		if (batch.json != NULL){
+			fclose(batch.json);
+		}
+		free_move_automaton(&batch.automaton);
+		pthread_mutex_destroy(&batch.lock);
+		fclose(batch.fid);
+		return status;
+	}
+}
+
+#ifdef NPUZZLE_STATS
+/*
+ * Function:  new_search_stats 
+ * --------------------
+ * Number a new search for the statistics
+ * 
+ *  returns: the number of the search, from 1
+ */
+int new_search_stats(void){
+	return __sync_add_and_fetch(&statistics.num_searches, 1);
+}
+
+/*
+ * Function:  record_iteration 
+ * --------------------
+ * Keep the counters of one threshold iteration for the report on exit
+ *    
+ *  search: Number of the search, from new_search_stats()
+ *  iteration: Number of the iteration in the search, from 1
+ *  threshold: The f-score threshold of the iteration
+ *  num_generated: Boards generated in the iteration
+ *  num_expanded: Boards expanded in the iteration
+ *  num_evaluations: Heuristic evaluations in the iteration
+ *  seconds: Time taken by the iteration
+ * 
+ *  returns: 0, or -1 if out of memory
+ */
+int record_iteration(int search, int iteration, int threshold, long num_generated, long num_expanded, 
+	long num_evaluations, double seconds){
+	IterationStats *iterations;
+	IterationStats *record;
+	int status = 0;
+	pthread_mutex_lock(&statistics.lock);
+	if (statistics.num_iterations == statistics.capacity){
+		statistics.capacity = (statistics.capacity == 0) ? INITIAL_STATS_CAPACITY : statistics.capacity * 2;
+		iterations = (IterationStats *) realloc(statistics.iterations, sizeof(IterationStats) * statistics.capacity);
+		if (iterations == NULL){
+			statistics.capacity = statistics.num_iterations;
+			status = -1;
+			goto CLEANUP;
+		}
+		statistics.iterations = iterations;
+	}
+	record = &statistics.iterations[statistics.num_iterations];
+	record->search = search;
+	record->iteration = iteration;
+	record->threshold = threshold;
+	record->num_generated = num_generated;
+	record->num_expanded = num_expanded;
+	record->num_evaluations = num_evaluations;
+	record->seconds = seconds;
+	statistics.num_iterations++;
+	CLEANUP: {
+		pthread_mutex_unlock(&statistics.lock);
+		return status;
+	}
+}
+
+/*
+ * Function:  print_statistics 
+ * --------------------
+ * Print every iteration recorded and the totals, one "stats:" line each. Registered with atexit
+ */
+void print_statistics(void){
+	const IterationStats *record;
+	long num_generated = 0, num_expanded = 0, num_evaluations = 0;
+	double seconds = 0;
+	int i;
+	for (i = 0; i < statistics.num_iterations; i++){
+		record = &statistics.iterations[i];
+		printf("stats: search=%d iteration=%d threshold=%d generated=%ld expanded=%ld evaluations=%ld seconds=%.6f \n", 
+			record->search, record->iteration, record->threshold, record->num_generated, record->num_expanded, 
+			record->num_evaluations, record->seconds);
+		num_generated += record->num_generated;
+		num_expanded += record->num_expanded;
+		num_evaluations += record->num_evaluations;
+		seconds += record->seconds;
+	}
+	printf("stats: total searches=%d iterations=%d generated=%ld expanded=%ld evaluations=%ld seconds=%.6f \n", 
+		statistics.num_searches, statistics.num_iterations, num_generated, num_expanded, num_evaluations, seconds);
+	free(statistics.iterations);
+}
+#endif
@@ -0,0 +1,70 @@
+#!/bin/sh
+#
+#	Benchmarks for both solvers, run with their -batch mode.
+#	Usage:
+#	benchmarks/run_benchmarks.sh [label]
+#	builds both solvers with $CC $CFLAGS (gcc -O2 by default) and runs them over:
+#	  random8.txt    100 random solvable 8-puzzles (fixed, made once with a seeded shuffle)
+#	  temp.txt       the instances of Iterative_deepening_A_star/temp.txt
+#	  korf100.txt    Korf's 100 random 15-puzzles (Korf 1985), with the goal 0 1 2 ... 15 as in
+#	                 his paper. IDA* runs with $KORF100_ARGS (-heuristic walking by default, or e.g.
+#	                 -heuristic pattern -pdb file), A* with the walking distance and -memory
+#	                 $KORF100_MEMORY megabytes (256 by default), as plain A* runs out of memory on
+#	                 the harder ones. Both find the optimal lengths of the paper; the A* run takes
+#	                 about 20 minutes on one core and stays under 180 MB
+#	Each run writes <set>-<solver>.csv, .json and .log into benchmarks/results/<label>, where the
+#	label defaults to the current git commit. The CSV and JSON files have, for every instance, the
+#	time of the search (monotonic clock), the nodes expanded, nodes/s, the solution length and the
+#	peak RSS of the process so far.
+#	To compare two labels, set by set:
+#	benchmarks/run_benchmarks.sh -compare old_label new_label
+#
+set -u
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+RESULTS=${RESULTS:-$ROOT/benchmarks/results}
+
+if [ "${1:-}" = "-compare" ]; then
+	if [ $# -ne 3 ]; then
+		echo "Usage: $0 -compare old_label new_label"
+		exit 1
+	fi
+	for OLD in "$RESULTS/$2"/*.csv; do
+		NEW="$RESULTS/$3/$(basename "$OLD")"
+		[ -f "$NEW" ] || continue
+		awk -F, -v name="$(basename "$OLD" .csv)" '
+			FNR == 1 { file++; next }
+			{ seconds[file] += $8; nodes[file] += $7 }
+			END {
+				printf "%-20s %10.3f s -> %10.3f s (x%.2f), nodes %.0f -> %.0f \n", name, seconds[1], seconds[2],
+					(seconds[2] > 0) ? seconds[1] / seconds[2] : 0, nodes[1], nodes[2]
+			}' "$OLD" "$NEW"
+	done
+	exit 0
+fi
+
+LABEL=${1:-$(git -C "$ROOT" rev-parse --short HEAD 2>/dev/null || echo build)}
+CC=${CC:-gcc}
+CFLAGS=${CFLAGS:--O2}
+OUT=$RESULTS/$LABEL
+mkdir -p "$OUT" || exit 1
+$CC -ansi -pedantic -W -Wall $CFLAGS -pthread -o "$OUT/N_puzzles" "$ROOT/A_star/N_puzzles.c" || exit 1
+$CC -ansi -pedantic -W -Wall $CFLAGS -pthread -o "$OUT/N_puzzles_IDA" "$ROOT/Iterative_deepening_A_star/N_puzzles_IDA.c" || exit 1
+
+# run name program args...
+run() {
+	NAME=$1
+	shift
+	echo "$NAME"
+	if ! "$@" -csv "$OUT/$NAME.csv" -json "$OUT/$NAME.json" > "$OUT/$NAME.log"; then
+		echo "Not every instance was solved, see $OUT/$NAME.log"
+	fi
+	tail -n 2 "$OUT/$NAME.log"
+}
+
+run random8-astar "$OUT/N_puzzles" -batch "$ROOT/benchmarks/random8.txt"
+run random8-ida "$OUT/N_puzzles_IDA" -batch "$ROOT/benchmarks/random8.txt"
+run temp-astar "$OUT/N_puzzles" -batch "$ROOT/Iterative_deepening_A_star/temp.txt" -heuristic walking
+run temp-ida "$OUT/N_puzzles_IDA" -batch "$ROOT/Iterative_deepening_A_star/temp.txt" -heuristic walking
+
+run korf100-ida "$OUT/N_puzzles_IDA" -batch "$ROOT/benchmarks/korf100.txt" ${KORF100_ARGS:--heuristic walking}
+run korf100-astar "$OUT/N_puzzles" -batch "$ROOT/benchmarks/korf100.txt" -heuristic walking -memory "${KORF100_MEMORY:-256}"